@@ -61,6 +61,116 @@ qboolean G_ClearLineOfSight(const vec3_t point1, const vec3_t point2, int ignore
 	return qfalse;
 }
 
+/*
+-------------------------
+Line of sight cache
+
+NPCs ask the same sight questions many times a frame - picking an enemy,
+checking the current one, finding the nearest. Each line's answer is kept
+for the rest of the frame, keyed by its exact end points and the entities
+that change how it's traced, so an answer is only reused for the very same
+line. CanSee traces start at the asking NPC's eyes, so those answers are
+only reused by that NPC; squad members looking at the same target each
+trace their own lines.
+-------------------------
+*/
+
+#define	LOS_CACHE_SIZE	512	// power of 2
+
+typedef enum
+{
+	LOS_CANSEE,		// CanSee, one spot
+	LOS_CLEAR		// G_ClearLOS, position to position
+} losKind_t;
+
+typedef struct losCache_s
+{
+	int			time;
+	int			kind;
+	int			passEnt;
+	int			target;
+	vec3_t		start;
+	vec3_t		end;
+	qboolean	clear;
+} losCache_t;
+
+static losCache_t	losCache[LOS_CACHE_SIZE];
+
+// level.time starts over with every map and saved game, so answers from the
+// last one could otherwise match
+void G_ClearLOSCache( void )
+{
+	for ( int i = 0; i < LOS_CACHE_SIZE; i++ )
+	{
+		losCache[i].time = -1;
+	}
+}
+
+static losCache_t *G_LOSCacheSlot( int kind, int passEnt, int target, const vec3_t start, const vec3_t end )
+{
+	unsigned int	hash = (unsigned int)( kind + passEnt * 31 + target * 1021 );
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		unsigned int	bits[2];
+
+		memcpy( &bits[0], &start[i], sizeof( bits[0] ) );
+		memcpy( &bits[1], &end[i], sizeof( bits[1] ) );
+		hash = ( hash ^ bits[0] ) * 16777619u;
+		hash = ( hash ^ bits[1] ) * 16777619u;
+	}
+
+	return &losCache[( hash ^ ( hash >> 16 ) ) & ( LOS_CACHE_SIZE - 1 )];
+}
+
+// qtrue and the answer in *clear if this line was already traced this frame
+static qboolean G_LOSCacheLookup( losCache_t *slot, int kind, int passEnt, int target, const vec3_t start, const vec3_t end, qboolean *clear )
+{
+	if ( slot->time != level.time
+		|| slot->kind != kind
+		|| slot->passEnt != passEnt
+		|| slot->target != target
+		|| !VectorCompare( slot->start, start )
+		|| !VectorCompare( slot->end, end ) )
+	{
+		return qfalse;
+	}
+
+	*clear = slot->clear;
+	return qtrue;
+}
+
+static void G_LOSCacheStore( losCache_t *slot, int kind, int passEnt, int target, const vec3_t start, const vec3_t end, qboolean clear )
+{
+	slot->time = level.time;
+	slot->kind = kind;
+	slot->passEnt = passEnt;
+	slot->target = target;
+	VectorCopy( start, slot->start );
+	VectorCopy( end, slot->end );
+	slot->clear = clear;
+}
+
+// One of CanSee's traces, from the NPC's eyes to a spot on ent
+static qboolean NPC_SpotVisible( gentity_t *ent, vec3_t eyes, vec3_t spot )
+{
+	losCache_t	*slot = G_LOSCacheSlot( LOS_CANSEE, NPC->s.number, ent->s.number, eyes, spot );
+	trace_t		tr;
+	qboolean	clear;
+
+	if ( G_LOSCacheLookup( slot, LOS_CANSEE, NPC->s.number, ent->s.number, eyes, spot, &clear ) )
+	{
+		return clear;
+	}
+
+	gi.trace ( &tr, eyes, NULL, NULL, spot, NPC->s.number, MASK_OPAQUE, (EG2_Collision)0, 0 );
+	ShotThroughGlass (&tr, ent, spot, MASK_OPAQUE);
+	clear = (qboolean)( tr.fraction == 1.0 );
+
+	G_LOSCacheStore( slot, LOS_CANSEE, NPC->s.number, ent->s.number, eyes, spot, clear );
+	return clear;
+}
+
 /*
 CanSee
 determine if NPC can see an entity
@@ -72,32 +182,25 @@ FIXME do we need fat and thin version of this?
 */
 qboolean CanSee ( gentity_t *ent )
 {
-	trace_t		tr;
 	vec3_t		eyes;
 	vec3_t		spot;
 
 	CalcEntitySpot( NPC, SPOT_HEAD_LEAN, eyes );
 
 	CalcEntitySpot( ent, SPOT_ORIGIN, spot );
-	gi.trace ( &tr, eyes, NULL, NULL, spot, NPC->s.number, MASK_OPAQUE, (EG2_Collision)0, 0 );
-	ShotThroughGlass (&tr, ent, spot, MASK_OPAQUE);
-	if ( tr.fraction == 1.0 )
+	if ( NPC_SpotVisible( ent, eyes, spot ) )
 	{
 		return qtrue;
 	}
 
 	CalcEntitySpot( ent, SPOT_HEAD, spot );
-	gi.trace ( &tr, eyes, NULL, NULL, spot, NPC->s.number, MASK_OPAQUE, (EG2_Collision)0, 0 );
-	ShotThroughGlass (&tr, ent, spot, MASK_OPAQUE);
-	if ( tr.fraction == 1.0 )
+	if ( NPC_SpotVisible( ent, eyes, spot ) )
 	{
 		return qtrue;
 	}
 
 	CalcEntitySpot( ent, SPOT_LEGS, spot );
-	gi.trace ( &tr, eyes, NULL, NULL, spot, NPC->s.number, MASK_OPAQUE, (EG2_Collision)0, 0 );
-	ShotThroughGlass (&tr, ent, spot, MASK_OPAQUE);
-	if ( tr.fraction == 1.0 )
+	if ( NPC_SpotVisible( ent, eyes, spot ) )
 	{
 		return qtrue;
 	}
@@ -925,8 +1028,7 @@ G_ClearLOS
 -------------------------
 */
 
-// Position to position
-qboolean G_ClearLOS( gentity_t *self, const vec3_t start, const vec3_t end )
+static qboolean G_TraceClearLOS( const vec3_t start, const vec3_t end )
 {
 	trace_t		tr;
 	int			traceCount = 0;
@@ -953,6 +1055,22 @@ qboolean G_ClearLOS( gentity_t *self, const vec3_t start, const vec3_t end )
 	return qfalse;
 }
 
+// Position to position
+qboolean G_ClearLOS( gentity_t *self, const vec3_t start, const vec3_t end )
+{
+	//self isn't part of the trace, so anyone asking about this line shares the answer
+	losCache_t	*slot = G_LOSCacheSlot( LOS_CLEAR, ENTITYNUM_NONE, ENTITYNUM_NONE, start, end );
+	qboolean	clear;
+
+	if ( !G_LOSCacheLookup( slot, LOS_CLEAR, ENTITYNUM_NONE, ENTITYNUM_NONE, start, end, &clear ) )
+	{
+		clear = G_TraceClearLOS( start, end );
+		G_LOSCacheStore( slot, LOS_CLEAR, ENTITYNUM_NONE, ENTITYNUM_NONE, start, end, clear );
+	}
+
+	return clear;
+}
+
 //Entity to position
 qboolean G_ClearLOS( gentity_t *self, gentity_t *ent, const vec3_t end )
 {
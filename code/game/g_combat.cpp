@@ -5506,6 +5506,11 @@ void G_Damage( gentity_t *targ, gentity_t *inflictor, gentity_t *attacker, const
 		}
 	}
 
+	if ( targ->contents & MASK_SOLID )
+	{// breaking it may open a way through for splash damage
+		G_SplashVisInvalidate();
+	}
+
 	if ( targ->health <= 0 && !targ->client )
 	{	// allow corpses to be disintegrated
 		if( mod != MOD_SNIPER || (targ->flags & FL_DISINTEGRATED) )
@@ -6840,19 +6845,153 @@ qboolean CanDamage (gentity_t *targ, const vec3_t origin) {
 	return qfalse;
 }
 
+// CanDamage answers for explosions at the last few spots, kept for the
+// frame they went off in, so that a burst of explosions at the same spot
+// traces each target once. They're dropped as soon as anything that blocks
+// the traces is freed, damaged or moved by a mover, since an earlier
+// explosion may have opened a way through. Solid entities switched on or
+// off some other way (by a script or a use function) in the same frame
+// aren't noticed, so a later explosion there may still see them as they
+// were.
+#define SPLASH_VIS_ORIGINS	4
+
+typedef enum
+{
+	SPLASH_VIS_UNKNOWN,
+	SPLASH_VIS_CLEAR,
+	SPLASH_VIS_BLOCKED
+} splashVisState_t;
+
+typedef struct splashVis_s
+{
+	int			time;
+	int			generation;					// splashVisGeneration when made
+	vec3_t		origin;
+	byte		state[MAX_GENTITIES];		// splashVisState_t
+	vec3_t		midpoint[MAX_GENTITIES];	// of the entity when it was traced
+} splashVis_t;
+
+static splashVis_t	splashVis[SPLASH_VIS_ORIGINS];
+static int			splashVisNext;
+static int			splashVisGeneration;
+
+/*
+============
+G_SplashVisInvalidate
+
+Something that blocks CanDamage's traces has changed, so the splash
+visibility answers worked out so far no longer hold.
+============
+*/
+void G_SplashVisInvalidate( void )
+{
+	splashVisGeneration++;
+}
+
+static splashVis_t *G_SplashVisForOrigin( const vec3_t origin )
+{
+	for ( int i = 0; i < SPLASH_VIS_ORIGINS; i++ )
+	{
+		splashVis_t *vis = &splashVis[i];
+		if ( vis->time == level.time && vis->generation == splashVisGeneration && VectorCompare( vis->origin, origin ) )
+		{
+			return vis;
+		}
+	}
+
+	splashVis_t *vis = &splashVis[splashVisNext];
+	splashVisNext = (splashVisNext + 1) % SPLASH_VIS_ORIGINS;
+
+	vis->time = level.time;
+	vis->generation = splashVisGeneration;
+	VectorCopy( origin, vis->origin );
+	memset( vis->state, SPLASH_VIS_UNKNOWN, sizeof( vis->state ) );
+	return vis;
+}
+
+/*
+============
+CanDamageList
+
+CanDamage for each of a list of entities, done before any of them is
+damaged. Reuses the answers of earlier explosions at the same origin this
+frame, for entities that haven't moved since, as long as nothing solid
+has changed in between.
+============
+*/
+static void CanDamageList( const vec3_t origin, gentity_t **ents, int count, qboolean *canDamage )
+{
+	splashVis_t	*vis = G_SplashVisForOrigin( origin );
+
+	for ( int e = 0; e < count; e++ )
+	{
+		gentity_t	*ent = ents[e];
+		const int	num = ent->s.number;
+		vec3_t		midpoint;
+
+		VectorAdd( ent->absmin, ent->absmax, midpoint );
+		VectorScale( midpoint, 0.5f, midpoint );
+
+		if ( vis->state[num] == SPLASH_VIS_UNKNOWN || !VectorCompare( vis->midpoint[num], midpoint ) )
+		{
+			vis->state[num] = CanDamage( ent, origin ) ? SPLASH_VIS_CLEAR : SPLASH_VIS_BLOCKED;
+			VectorCopy( midpoint, vis->midpoint[num] );
+		}
+
+		canDamage[e] = (qboolean)( vis->state[num] == SPLASH_VIS_CLEAR );
+	}
+}
+
+/*
+============
+G_RadiusDamagePoints
+
+How much of the damage reaches ent, going by the distance from the edge of
+its bounding box. qfalse if it's out of the radius.
+============
+*/
+static qboolean G_RadiusDamagePoints( gentity_t *ent, const vec3_t origin, float damage, float radius, float *points )
+{
+	vec3_t	v;
+
+	// find the distance from the edge of the bounding box
+	for ( int i = 0 ; i < 3 ; i++ ) {
+		if ( origin[i] < ent->absmin[i] ) {
+			v[i] = ent->absmin[i] - origin[i];
+		} else if ( origin[i] > ent->absmax[i] ) {
+			v[i] = origin[i] - ent->absmax[i];
+		} else {
+			v[i] = 0;
+		}
+	}
+
+	float dist = VectorLength( v );
+	if ( dist >= radius ) {
+		return qfalse;
+	}
+
+	*points = damage * ( 1.0 - dist / radius );
+	return qtrue;
+}
+
 extern	void	Boba_DustFallNear(const vec3_t origin, int dustcount);
 extern	void	G_GetMassAndVelocityForEnt( gentity_t *ent, float *mass, vec3_t velocity );
 /*
 ============
 G_RadiusDamage
+
+Visibility is worked out for every target before any of them is damaged,
+so breaking something open doesn't let this same explosion through to
+what's behind it. Later explosions see the change.
 ============
 */
 void G_RadiusDamage ( const vec3_t origin, gentity_t *attacker, float damage, float radius,
 					 gentity_t *ignore, int mod) {
-	float		points, dist;
+	float		points;
 	gentity_t	*ent;
 	gentity_t	*entityList[MAX_GENTITIES];
-	int			numListedEntities;
+	qboolean	canDamage[MAX_GENTITIES];
+	int			numListedEntities, numTargets;
 	vec3_t		mins, maxs;
 	vec3_t		v;
 	vec3_t		dir;
@@ -6880,6 +7019,9 @@ void G_RadiusDamage ( const vec3_t origin, gentity_t *attacker, float damage, fl
 
 	numListedEntities = gi.EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
 
+	// narrow the list down to what's in the radius, then see what the
+	// explosion can reach all at once
+	numTargets = 0;
 	for ( e = 0 ; e < numListedEntities ; e++ ) {
 		ent = entityList[ e ];
 
@@ -6889,24 +7031,24 @@ void G_RadiusDamage ( const vec3_t origin, gentity_t *attacker, float damage, fl
 			continue;
 		if ( !ent->contents )
 			continue;
+		if ( !G_RadiusDamagePoints( ent, origin, damage, radius, &points ) )
+			continue;
 
-		// find the distance from the edge of the bounding box
-		for ( i = 0 ; i < 3 ; i++ ) {
-			if ( origin[i] < ent->absmin[i] ) {
-				v[i] = ent->absmin[i] - origin[i];
-			} else if ( origin[i] > ent->absmax[i] ) {
-				v[i] = origin[i] - ent->absmax[i];
-			} else {
-				v[i] = 0;
-			}
-		}
+		entityList[numTargets++] = ent;
+	}
 
-		dist = VectorLength( v );
-		if ( dist >= radius ) {
-			continue;
-		}
+	CanDamageList( origin, entityList, numTargets, canDamage );
+
+	for ( e = 0 ; e < numTargets ; e++ ) {
+		ent = entityList[ e ];
 
-		points = damage * ( 1.0 - dist / radius );
+		// damaging an earlier target can take this one out
+		if ( !ent->inuse || !ent->takedamage )
+			continue;
+		if ( !ent->contents )
+			continue;
+		if ( !G_RadiusDamagePoints( ent, origin, damage, radius, &points ) )
+			continue;
 
 		// Lessen damage to vehicles that are moving away from the explosion
 		if (ent->client && (ent->client->NPC_class==CLASS_VEHICLE || G_IsRidingVehicle(ent)))
@@ -6940,7 +7082,7 @@ void G_RadiusDamage ( const vec3_t origin, gentity_t *attacker, float damage, fl
 			}
 		}
 
-		if (CanDamage (ent, origin))
+		if ( canDamage[e] )
 		{//FIXME: still do a little damage in in PVS and close?
 			if ( ent->svFlags & (SVF_GLASS_BRUSH|SVF_BBRUSH) )
 			{
@@ -461,6 +461,7 @@ void	G_DebugLine(vec3_t A, vec3_t B, int duration, int color, qboolean deleteorn
 qboolean CanDamage (gentity_t *targ, const vec3_t origin);
 void G_Damage( gentity_t *targ, gentity_t *inflictor, gentity_t *attacker, const vec3_t dir, const vec3_t point, int damage, int dflags, int mod, int hitLoc=HL_NONE );
 void G_RadiusDamage (const vec3_t origin, gentity_t *attacker, float damage, float radius, gentity_t *ignore, int mod);
+void G_SplashVisInvalidate( void );
 gentity_t *TossClientItems( gentity_t *self );
 void ExplodeDeath_Wait( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int damage, int meansOfDeath,int dFlags,int hitLoc );
 void ExplodeDeath( gentity_t *self );
@@ -656,6 +657,7 @@ extern qboolean G_ClearLOS( gentity_t *self, gentity_t *ent, const vec3_t end );
 extern qboolean G_ClearLOS( gentity_t *self, const vec3_t start, gentity_t *ent );
 extern qboolean G_ClearLOS( gentity_t *self, gentity_t *ent );
 extern qboolean G_ClearLOS( gentity_t *self, const vec3_t end );
+extern void G_ClearLOSCache( void );
 
 //============================================================================
 
@@ -781,6 +781,7 @@ void InitGame(  const char *mapname, const char *spawntarget, int checkSum, cons
 	WP_SaberLoadParms();
 	//Set up NPC init data
 	NPC_InitGame();
+	G_ClearLOSCache();
 
 	TIMER_Clear();
 	Rail_Reset();
@@ -513,6 +513,11 @@ void G_MoverTeam( gentity_t *ent ) {
 		EvaluateTrajectory( &part->s.apos, level.time, angles );
 		VectorSubtract( origin, part->currentOrigin, move );
 		VectorSubtract( angles, part->currentAngles, amove );
+		if ( (part->contents & MASK_SOLID)
+			&& (!VectorCompare( move, vec3_origin ) || !VectorCompare( amove, vec3_origin )) )
+		{
+			G_SplashVisInvalidate();
+		}
 		if ( !G_MoverPush( part, move, amove, &obstacle ) )
 		{
 			break;	// move was blocked
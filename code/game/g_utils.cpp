@@ -863,6 +863,10 @@ Marks the entity as free
 =================
 */
 void G_FreeEntity( gentity_t *ed ) {
+	if ( ed->linked && (ed->contents & MASK_SOLID) ) {
+		G_SplashVisInvalidate();
+	}
+
 	gi.unlinkentity (ed);		// unlink from world
 
 	// Free the Game Element (the entity) and delete the Icarus ID.
@@ -49,6 +49,9 @@ CFxScheduler::CFxScheduler()
 	mNextFree2DEffect = 0;
 	memset( &mEffectTemplates, 0, sizeof( mEffectTemplates ));
 	memset( &mLoopedEffectArray, 0, sizeof( mLoopedEffectArray ));
+	memset( &mFxSchedule, 0, sizeof( mFxSchedule ));
+	mFxScheduleTime[0] = mFxScheduleTime[1] = 0;
+	mNumScheduledFx = 0;
 }
 
 int CFxScheduler::ScheduleLoopedEffect( int id, int boltInfo, CGhoul2Info_v *ghoul2, bool isPortal, int iLoopTime, bool isRelative  )
@@ -190,21 +193,26 @@ SEffectTemplate &SEffectTemplate::operator=(const SEffectTemplate &that)
 void CFxScheduler::Clean(bool bRemoveTemplates /*= true*/, int idToPreserve /*= 0*/)
 {
 	int								i, j;
-	TScheduledEffect::iterator		itr, next;
 
 	// Ditch any scheduled effects
-	itr = mFxSchedule.begin();
-
-	while ( itr != mFxSchedule.end() )
+	for ( i = 0; i < 2; i++ )
 	{
-		next = itr;
-		++next;
+		for ( j = 0; j < FX_SCHEDULE_SLOTS; j++ )
+		{
+			SScheduledEffect *effect = mFxSchedule[i][j];
 
-		mScheduledEffectsPool.Free (*itr);
-		mFxSchedule.erase(itr);
+			while ( effect )
+			{
+				SScheduledEffect *next = effect->mNext;
 
-		itr = next;
+				mScheduledEffectsPool.Free (effect);
+				effect = next;
+			}
+			mFxSchedule[i][j] = NULL;
+		}
+		mFxScheduleTime[i] = 0;
 	}
+	mNumScheduledFx = 0;
 
 	if (bRemoveTemplates)
 	{
@@ -980,7 +988,7 @@ void CFxScheduler::PlayEffect( int id, vec3_t origin, matrix3_t axis, const int
 					sfx->mStartTime++;
 				}
 
-				mFxSchedule.push_front( sfx );
+				ScheduleEffect( sfx );
 			}
 		}
 	}
@@ -1038,6 +1046,35 @@ void CFxScheduler::PlayEffect( const char *file, vec3_t origin, vec3_t forward,
 	PlayEffect( mEffectIDs[sfile], origin, forward, vol, rad );
 }
 
+//------------------------------------------------------
+// ScheduleEffect
+//	Puts a scheduled effect in the slot of the wheel for
+//	its pass that it's due in.
+//
+// Input:
+//	effect to schedule, with mStartTime and mPortalEffect set
+//
+// Return:
+//	none
+//------------------------------------------------------
+void CFxScheduler::ScheduleEffect( SScheduledEffect *schedFx )
+{
+	const int	wheel = schedFx->mPortalEffect ? 1 : 0;
+	int			time = schedFx->mStartTime;
+
+	// the wheel won't look behind where it's got to again until the next lap
+	if ( time < mFxScheduleTime[wheel] )
+	{
+		time = mFxScheduleTime[wheel];
+	}
+
+	SScheduledEffect **slot = &mFxSchedule[wheel][(time / FX_SCHEDULE_SLOT_MSEC) & (FX_SCHEDULE_SLOTS - 1)];
+
+	schedFx->mNext = *slot;
+	*slot = schedFx;
+	mNumScheduledFx++;
+}
+
 //------------------------------------------------------
 // AddScheduledEffects
 //	Handles determining if a scheduled effect should
@@ -1054,11 +1091,12 @@ bool gEffectsInPortal = qfalse; //this is just because I don't want to have to a
 
 void CFxScheduler::AddScheduledEffects( bool portal )
 {
-	TScheduledEffect::iterator	itr, next;
 	vec3_t						origin;
 	matrix3_t					axis;
 	int							oldEntNum = -1, oldBoltIndex = -1, oldModelNum = -1;
 	qboolean					doesBoltExist  = qfalse;
+	const int					wheel = portal ? 1 : 0;
+	int							firstSlot, numSlots;
 
 	if (portal)
 	{
@@ -1069,70 +1107,88 @@ void CFxScheduler::AddScheduledEffects( bool portal )
 		AddLoopedEffects();
 	}
 
-	for ( itr = mFxSchedule.begin(); itr != mFxSchedule.end(); /* do nothing */ )
+	// visit the slots from where this pass's wheel got to last time up to now, or all
+	// of them if time has gone backwards or further than a lap
+	firstSlot = mFxScheduleTime[wheel] / FX_SCHEDULE_SLOT_MSEC;
+	numSlots = theFxHelper.mTime / FX_SCHEDULE_SLOT_MSEC - firstSlot + 1;
+	if ( numSlots <= 0 || numSlots > FX_SCHEDULE_SLOTS )
 	{
-		SScheduledEffect *effect = *itr;
+		numSlots = FX_SCHEDULE_SLOTS;
+	}
+	mFxScheduleTime[wheel] = theFxHelper.mTime;
 
-		if (portal == effect->mPortalEffect && effect->mStartTime <= theFxHelper.mTime )
-		{ //only render portal fx on the skyportal pass and vice versa
-			if (effect->mBoltNum == -1)
-			{// ok, are we spawning a bolt on effect or a normal one?
-				if ( effect->mEntNum != ENTITYNUM_NONE )
-				{
-					// Find out where the entity currently is
-					TCGVectorData	*data = (TCGVectorData*)cl.mSharedMemory;
+	for ( int i = 0; i < numSlots; i++ )
+	{
+		SScheduledEffect **link = &mFxSchedule[wheel][(firstSlot + i) & (FX_SCHEDULE_SLOTS - 1)];
 
-					data->mEntityNum = effect->mEntNum;
-					CGVM_GetLerpOrigin();
-					CreateEffect( effect->mpTemplate,
-								data->mPoint, effect->mAxis,
-								theFxHelper.mTime - effect->mStartTime );
-				}
-				else
-				{
-					CreateEffect( effect->mpTemplate,
-								effect->mOrigin, effect->mAxis,
-								theFxHelper.mTime - effect->mStartTime );
-				}
-			}
-			else
-			{	//bolted on effect
-				// do we need to go and re-get the bolt matrix again? Since it takes time lets try to do it only once
-				if ((effect->mModelNum != oldModelNum) ||
-					(effect->mEntNum != oldEntNum) ||
-					(effect->mBoltNum != oldBoltIndex))
-				{
-					oldModelNum = effect->mModelNum;
-					oldEntNum = effect->mEntNum;
-					oldBoltIndex = effect->mBoltNum;
+		while ( *link )
+		{
+			SScheduledEffect *effect = *link;
 
-					doesBoltExist = theFxHelper.GetOriginAxisFromBolt(effect->ghoul2, effect->mEntNum, effect->mModelNum, effect->mBoltNum, origin, axis);
-				}
+			if ( effect->mStartTime <= theFxHelper.mTime )
+			{ //each pass has its own wheel, so portal fx only render on the skyportal pass and vice versa
+				// unlink it first, creating it can schedule more effects into this slot
+				*link = effect->mNext;
 
-				// only do this if we found the bolt
-				if (doesBoltExist)
-				{
-					if (effect->mIsRelative )
+				if (effect->mBoltNum == -1)
+				{// ok, are we spawning a bolt on effect or a normal one?
+					if ( effect->mEntNum != ENTITYNUM_NONE )
 					{
+						// Find out where the entity currently is
+						TCGVectorData	*data = (TCGVectorData*)cl.mSharedMemory;
+
+						data->mEntityNum = effect->mEntNum;
+						CGVM_GetLerpOrigin();
 						CreateEffect( effect->mpTemplate,
-									origin, axis, 0, -1,
-									effect->ghoul2, effect->mEntNum, effect->mModelNum, effect->mBoltNum );
+									data->mPoint, effect->mAxis,
+									theFxHelper.mTime - effect->mStartTime );
 					}
 					else
 					{
 						CreateEffect( effect->mpTemplate,
-									origin, axis,
+									effect->mOrigin, effect->mAxis,
 									theFxHelper.mTime - effect->mStartTime );
 					}
 				}
-			}
+				else
+				{	//bolted on effect
+					// do we need to go and re-get the bolt matrix again? Since it takes time lets try to do it only once
+					if ((effect->mModelNum != oldModelNum) ||
+						(effect->mEntNum != oldEntNum) ||
+						(effect->mBoltNum != oldBoltIndex))
+					{
+						oldModelNum = effect->mModelNum;
+						oldEntNum = effect->mEntNum;
+						oldBoltIndex = effect->mBoltNum;
 
-			mScheduledEffectsPool.Free (effect);
-			itr = mFxSchedule.erase(itr);
-		}
-		else
-		{
-			++itr;
+						doesBoltExist = theFxHelper.GetOriginAxisFromBolt(effect->ghoul2, effect->mEntNum, effect->mModelNum, effect->mBoltNum, origin, axis);
+					}
+
+					// only do this if we found the bolt
+					if (doesBoltExist)
+					{
+						if (effect->mIsRelative )
+						{
+							CreateEffect( effect->mpTemplate,
+										origin, axis, 0, -1,
+										effect->ghoul2, effect->mEntNum, effect->mModelNum, effect->mBoltNum );
+						}
+						else
+						{
+							CreateEffect( effect->mpTemplate,
+										origin, axis,
+										theFxHelper.mTime - effect->mStartTime );
+						}
+					}
+				}
+
+				mScheduledEffectsPool.Free (effect);
+				mNumScheduledFx--;
+			}
+			else
+			{
+				link = &effect->mNext;
+			}
 		}
 	}
 
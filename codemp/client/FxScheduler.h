@@ -39,6 +39,9 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #define FX_MAX_EFFECT_COMPONENTS	24		// how many primitives an effect can hold, this should be plenty
 #define FX_MAX_PRIM_NAME			32
 
+#define FX_SCHEDULE_SLOTS			256		// scheduled effects are bucketed by start time into this many slots,
+#define FX_SCHEDULE_SLOT_MSEC		8		//	each this long, so a frame only visits the slots that came due
+
 //-----------------------------------------------
 // These are spawn flags for primitiveTemplates
 //-----------------------------------------------
@@ -571,6 +574,7 @@ private:
 		CGhoul2Info_v *ghoul2;
 		vec3_t	mOrigin;
 		matrix3_t	mAxis;
+		SScheduledEffect	*mNext;	// in the same schedule slot
 	};
 
 /* Looped Effects get stored and reschedule at mRepeatRate */
@@ -616,8 +620,6 @@ private:
 	// this makes looking up the index based on the string name much easier
 	typedef std::map<std::string, int>				TEffectID;
 
-	typedef std::list<SScheduledEffect*>			TScheduledEffect;
-
 	// Effects
 	SEffectTemplate		mEffectTemplates[FX_MAX_EFFECTS];
 	TEffectID			mEffectIDs;								// if you only have the unique effect name, you'll have to use this to get the ID.
@@ -626,11 +628,17 @@ private:
 	CScheduled2DEffect	m2DEffects[FX_MAX_2DEFFECTS];
 	int					mNextFree2DEffect;
 
-	// List of scheduled effects that will need to be created at the correct time.
-	TScheduledEffect	mFxSchedule;
+	// Scheduled effects that will need to be created at the correct time, as a timing wheel
+	// for each of the normal and portal passes. Effects further off than the wheel goes
+	// around sit in their slot until a later lap.
+	SScheduledEffect	*mFxSchedule[2][FX_SCHEDULE_SLOTS];
+	int					mFxScheduleTime[2];		// the last time each wheel was run up to
+	int					mNumScheduledFx;
 
 	PagedPoolAllocator<SScheduledEffect, 1024> mScheduledEffectsPool;
 
+	void	ScheduleEffect( SScheduledEffect *schedFx );
+
 	// Private function prototypes
 	SEffectTemplate *GetNewEffectTemplate( int *id, const char *file );
 
@@ -666,7 +674,7 @@ public:
 	void	Draw2DEffects(float screenXScale, float screenYScale);
 
 	int		GetHighWatermark() const { return mScheduledEffectsPool.GetHighWatermark(); }
-	int		NumScheduledFx()	{ return (int)mFxSchedule.size();	}
+	int		NumScheduledFx()	{ return mNumScheduledFx;	}
 	void	Clean(bool bRemoveTemplates = true, int idToPreserve = 0);	// clean out the system
 
 	// FX Override functions
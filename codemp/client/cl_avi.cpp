@@ -64,7 +64,7 @@ typedef struct aviFileData_s
   int           chunkStack[ MAX_RIFF_CHUNKS ];
   int           chunkStackTop;
 
-  byte          *cBuffer, *eBuffer;
+  qboolean      writeFailed;    // CL_TakeVideoFrame raises the error
 } aviFileData_t;
 
 static aviFileData_t afd;
@@ -81,8 +81,10 @@ SafeFS_Write
 */
 static QINLINE void SafeFS_Write( const void *buffer, int len, fileHandle_t f )
 {
+  // video frames are written from inside the renderer, which
+  // mustn't be longjmp'd out of
   if( FS_Write( buffer, len, f ) < len )
-    Com_Error( ERR_DROP, "Failed to write avi file" );
+    afd.writeFailed = qtrue;
 }
 
 /*
@@ -368,14 +370,6 @@ qboolean CL_OpenAVIForWriting( const char *fileName )
   else
     afd.motionJpeg = qfalse;
 
-  // Buffers only need to store RGB pixels.
-  // Allocate a bit more space for the capture buffer to account for possible
-  // padding at the end of pixel lines, and padding for alignment
-  #define MAX_PACK_LEN 16
-  afd.cBuffer = (byte *)Z_Malloc((afd.width * 3 + MAX_PACK_LEN - 1) * afd.height + MAX_PACK_LEN - 1, TAG_AVI, qtrue);
-  // raw avi files have pixel lines start on 4-byte boundaries
-  afd.eBuffer = (byte *)Z_Malloc(PAD(afd.width * 3, AVI_LINE_PADDING) * afd.height, TAG_AVI, qtrue);
-
   afd.a.rate = dma.speed;
   afd.a.format = WAV_FORMAT_PCM;
   afd.a.channels = dma.channels;
@@ -433,6 +427,8 @@ qboolean CL_OpenAVIForWriting( const char *fileName )
   return qtrue;
 }
 
+static qboolean CL_FinishAVIFile( void );
+
 /*
 ===============
 CL_CheckFileSize
@@ -455,12 +451,16 @@ static qboolean CL_CheckFileSize( int bytesToAdd )
     if ( newFileSize > INT_MAX )
     {
       // Close the current file...
-      CL_CloseAVI();
+      CL_FinishAVIFile( );
 
-      // ...And open a new one
-      CL_OpenAVIForWriting( va( "%s_", afd.fileName ) );
+      // ...And open a new one, so neither the audio nor the video
+      // loses the frame that didn't fit
+      if( !CL_OpenAVIForWriting( va( "%s_", afd.fileName ) ) )
+      {
+        Com_Printf( S_COLOR_RED "Couldn't open %s_ to carry on recording\n", afd.fileName );
+        return qtrue;
+      }
 
-      return qtrue;
     }
   }
 
@@ -474,7 +474,7 @@ CL_WriteAVIVideoFrame
 */
 void CL_WriteAVIVideoFrame( const byte *imageBuffer, int size )
 {
-  int   chunkOffset = afd.fileSize - afd.moviOffset - 8;
+  int   chunkOffset;
   int   chunkSize = 8 + size;
   int   paddingSize = PADLEN(size, 2);
   byte  padding[ 4 ] = { 0 };
@@ -486,6 +486,9 @@ void CL_WriteAVIVideoFrame( const byte *imageBuffer, int size )
   if( CL_CheckFileSize( 8 + size + 2 ) )
     return;
 
+  // after CL_CheckFileSize, which may have started a new file
+  chunkOffset = afd.fileSize - afd.moviOffset - 8;
+
   bufIndex = 0;
   WRITE_STRING( "00dc" );
   WRITE_4BYTES( size );
@@ -591,27 +594,26 @@ void CL_TakeVideoFrame( void )
   if( !afd.fileOpen )
     return;
 
-  re->TakeVideoFrame( afd.width, afd.height,
-      afd.cBuffer, afd.eBuffer, afd.motionJpeg );
+  if( afd.writeFailed )
+    Com_Error( ERR_DROP, "Failed to write avi file" );
+
+  re->TakeVideoFrame( afd.width, afd.height, afd.motionJpeg );
 }
 
 /*
 ===============
-CL_CloseAVI
+CL_FinishAVIFile
 
-Closes the AVI file and writes an index chunk
+Writes an index chunk and closes the file, without waiting for the
+renderer. Returns qfalse if any of the file couldn't be written.
 ===============
 */
-qboolean CL_CloseAVI( void )
+static qboolean CL_FinishAVIFile( void )
 {
   int indexRemainder;
   int indexSize = afd.numIndices * 16;
   const char *idxFileName = va( "%s" INDEX_FILE_EXTENSION, afd.fileName );
 
-  // AVI file isn't open
-  if( !afd.fileOpen )
-    return qfalse;
-
   afd.fileOpen = qfalse;
 
   FS_Seek( afd.idxF, 4, FS_SEEK_SET );
@@ -627,6 +629,7 @@ qboolean CL_CloseAVI( void )
           &afd.idxF, qtrue ) ) <= 0 )
   {
     FS_FCloseFile( afd.f );
+    Com_Printf( S_COLOR_RED "Couldn't read the index back, %s is unplayable\n", afd.fileName );
     return qfalse;
   }
 
@@ -660,15 +663,39 @@ qboolean CL_CloseAVI( void )
 
   SafeFS_Write( buffer, bufIndex, afd.f );
 
-  Z_Free( afd.cBuffer );
-  Z_Free( afd.eBuffer );
   FS_FCloseFile( afd.f );
 
+  if( afd.writeFailed )
+  {
+    Com_Printf( S_COLOR_RED "Failed to write %s, it is incomplete\n", afd.fileName );
+    return qfalse;
+  }
+
   Com_Printf( "Wrote %d:%d frames to %s\n", afd.numVideoFrames, afd.numAudioFrames, afd.fileName );
 
   return qtrue;
 }
 
+/*
+===============
+CL_CloseAVI
+
+Closes the AVI file and writes an index chunk
+===============
+*/
+qboolean CL_CloseAVI( void )
+{
+  // AVI file isn't open
+  if( !afd.fileOpen )
+    return qfalse;
+
+  // Let the renderer write the frames it is still encoding
+  if( re && re->FinishVideoFrames )
+    re->FinishVideoFrames( );
+
+  return CL_FinishAVIFile( );
+}
+
 /*
 ===============
 CL_VideoRecording
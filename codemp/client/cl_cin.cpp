@@ -44,6 +44,11 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include <cmath>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ROQ_SSE2
+#include <emmintrin.h>
+#endif
+
 #define MAXSIZE				8
 #define MINSIZE				4
 
@@ -337,13 +342,13 @@ static long RllDecodeStereoToMono(unsigned char *from,short *to,unsigned int siz
 *
 ******************************************************************************/
 
-static void move8_32( byte *src, byte *dst, int spl )
+static void move8_32( byte *src, byte *dst, int width, int spl )
 {
 	int i;
 
 	for(i = 0; i < 8; ++i)
 	{
-		memcpy(dst, src, 32);
+		memcpy(dst, src, width);
 		src += spl;
 		dst += spl;
 	}
@@ -426,7 +431,9 @@ static void blit2_32( byte *src, byte *dst, int spl  )
 *
 * Function:
 *
-* Description:
+* Description:	motion compensation always reads from the other frame buffer,
+*				so neighbouring 8x8 blocks that move together are gathered
+*				into one run and copied a whole row at a time
 *
 ******************************************************************************/
 
@@ -435,11 +442,17 @@ static void blitVQQuad32fs( byte **status, unsigned char *data )
 unsigned short	newd, celdata, code;
 unsigned int	index, i;
 int		spl;
+byte	*runSrc, *runDst, *src;
+int		runWidth;
 
 	newd	= 0;
 	celdata = 0;
 	index	= 0;
 
+	runSrc	= NULL;
+	runDst	= NULL;
+	runWidth = 0;
+
         spl = cinTable[currentHandle].samplesPerLine;
 
 	do {
@@ -497,7 +510,17 @@ int		spl;
 				}
 				break;
 			case	0x4000:													// motion compensation
-				move8_32( status[index] + cin.mcomp[(*data)], status[index], spl );
+				src = status[index] + cin.mcomp[(*data)];
+				if ( runWidth && status[index] == runDst + runWidth && src == runSrc + runWidth ) {
+					runWidth += 32;
+				} else {
+					if ( runWidth ) {
+						move8_32( runSrc, runDst, runWidth, spl );
+					}
+					runSrc = src;
+					runDst = status[index];
+					runWidth = 32;
+				}
 				data++;
 				index += 5;
 				break;
@@ -506,6 +529,10 @@ int		spl;
 				break;
 		}
 	} while ( status[index] != NULL );
+
+	if ( runWidth ) {
+		move8_32( runSrc, runDst, runWidth, spl );
+	}
 }
 
 /******************************************************************************
@@ -635,6 +662,39 @@ static unsigned int yuv_to_rgb24( long y, long u, long v )
 	return LittleLong ((r)|(g<<8)|(b<<16)|(255<<24));
 }
 
+/******************************************************************************
+*
+* Function:		yuv_to_rgb24_x4
+*
+* Description:	yuv_to_rgb24 for four pixels sharing their chroma, as every
+*				codebook entry does
+*
+******************************************************************************/
+static void yuv_to_rgb24_x4( long y0, long y1, long y2, long y3, long u, long v, unsigned int *out )
+{
+#ifdef ROQ_SSE2
+	const __m128i yy = _mm_setr_epi32( (int)ROQ_YY_tab[y0], (int)ROQ_YY_tab[y1], (int)ROQ_YY_tab[y2], (int)ROQ_YY_tab[y3] );
+	const __m128i r = _mm_srai_epi32( _mm_add_epi32( yy, _mm_set1_epi32( (int)ROQ_VR_tab[v] ) ), 6 );
+	const __m128i g = _mm_srai_epi32( _mm_add_epi32( yy, _mm_set1_epi32( (int)(ROQ_UG_tab[u] + ROQ_VG_tab[v]) ) ), 6 );
+	const __m128i b = _mm_srai_epi32( _mm_add_epi32( yy, _mm_set1_epi32( (int)ROQ_UB_tab[u] ) ), 6 );
+
+	// interleave to r g b a per pixel, the final pack clamps to 0..255
+	const __m128i rb = _mm_packs_epi32( r, b );
+	const __m128i ga = _mm_packs_epi32( g, _mm_set1_epi32( 255 ) );
+	const __m128i rg = _mm_unpacklo_epi16( rb, ga );
+	const __m128i ba = _mm_unpackhi_epi16( rb, ga );
+	const __m128i p01 = _mm_unpacklo_epi32( rg, ba );
+	const __m128i p23 = _mm_unpackhi_epi32( rg, ba );
+
+	_mm_storeu_si128( (__m128i *)out, _mm_packus_epi16( p01, p23 ) );
+#else
+	out[0] = yuv_to_rgb24( y0, u, v );
+	out[1] = yuv_to_rgb24( y1, u, v );
+	out[2] = yuv_to_rgb24( y2, u, v );
+	out[3] = yuv_to_rgb24( y3, u, v );
+#endif
+}
+
 /******************************************************************************
 *
 * Function:
@@ -703,10 +763,8 @@ static void decodeCodeBook( byte *input, unsigned short roq_flags )
 					y3 = (long)*input++;
 					cr = (long)*input++;
 					cb = (long)*input++;
-					*ibptr.i++ = yuv_to_rgb24( y0, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( y1, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( y2, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( y3, cr, cb );
+					yuv_to_rgb24_x4( y0, y1, y2, y3, cr, cb, ibptr.i );
+					ibptr.i += 4;
 				}
 
 				icptr.s = vq4;
@@ -781,14 +839,9 @@ static void decodeCodeBook( byte *input, unsigned short roq_flags )
 					y3 = (long)*input++;
 					cr = (long)*input++;
 					cb = (long)*input++;
-					*ibptr.i++ = yuv_to_rgb24( y0, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( y1, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( ((y0*3)+y2)/4, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( ((y1*3)+y3)/4, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( (y0+(y2*3))/4, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( (y1+(y3*3))/4, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( y2, cr, cb );
-					*ibptr.i++ = yuv_to_rgb24( y3, cr, cb );
+					yuv_to_rgb24_x4( y0, y1, ((y0*3)+y2)/4, ((y1*3)+y3)/4, cr, cb, ibptr.i );
+					yuv_to_rgb24_x4( (y0+(y2*3))/4, (y1+(y3*3))/4, y2, y3, cr, cb, ibptr.i + 4 );
+					ibptr.i += 8;
 				}
 
 				icptr.s = vq4;
@@ -2483,9 +2483,11 @@ void CL_InitRef( void ) {
 	ri.FS_FOpenFileByMode = FS_FOpenFileByMode;
 	ri.FS_FileExists = FS_FileExists;
 	ri.FS_FileIsInPAK = FS_FileIsInPAK;
+	ri.FS_FileStamp = FS_FileStamp;
 	ri.FS_ListFiles = FS_ListFiles;
 	ri.FS_Write = FS_Write;
 	ri.FS_WriteFile = FS_WriteFile;
+	ri.FS_HomeRemove = FS_HomeRemove;
 	ri.CM_BoxTrace = CM_BoxTrace;
 	ri.CM_DrawDebugSurface = CM_DrawDebugSurface;
 	ri.CM_CullWorldBox = CM_CullWorldBox;
@@ -2516,6 +2518,7 @@ void CL_InitRef( void ) {
     ri.WIN_Present = WIN_Present;
 	ri.GL_GetProcAddress = WIN_GL_GetProcAddress;
 	ri.GL_ExtensionSupported = WIN_GL_ExtensionSupported;
+	ri.GL_MakeCurrent = WIN_GL_MakeCurrent;
 
 	ri.CM_GetCachedMapDiskImage = CM_GetCachedMapDiskImage;
 	ri.CM_SetCachedMapDiskImage = CM_SetCachedMapDiskImage;
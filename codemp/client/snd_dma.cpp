@@ -40,6 +40,11 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include <windows.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define S_SPATIALIZE_SSE2
+#include <emmintrin.h>
+#endif
+
 qboolean s_shutUp = qfalse;
 
 static void S_Play_f(void);
@@ -1337,91 +1342,181 @@ channel_t *S_OpenALPickChannel(int entnum, int entchannel)
 
 /*
 =================
-S_SpatializeOrigin
+S_ChannelAttenuation
 
-Used for spatializing s_channels
+How far away sounds on a channel stay at full volume, and how quickly they
+fade beyond that
 =================
 */
-void S_SpatializeOrigin (const vec3_t origin, float master_vol, int *left_vol, int *right_vol, int channel)
+static void S_ChannelAttenuation( int channel, float *fullVolume, float *attenuate )
 {
-    float		dot;
-    float		dist;
-    float		lscale, rscale, scale;
-    vec3_t		source_vec;
-	float		dist_mult = SOUND_ATTENUATE;
+	*attenuate = SOUND_ATTENUATE;
+
+	switch ( channel )
+	{
+	case CHAN_VOICE:
+		*fullVolume = SOUND_FULLVOLUME * 3.0f;
+//		*attenuate = VOICE_ATTENUATE;	// tweak added (this fixes an NPC dialogue "in your ears" bug, but we're not sure if it'll make a bunch of others fade too early. Too close to shipping...)
+		break;
+	case CHAN_LESS_ATTEN:
+		*fullVolume = SOUND_FULLVOLUME * 8.0f; // maybe is too large
+		break;
+	case CHAN_VOICE_ATTEN:
+		*fullVolume = SOUND_FULLVOLUME * 1.35f; // used to be 0.15f, dropped off too sharply - dmv
+		*attenuate = VOICE_ATTENUATE;
+		break;
+	case CHAN_VOICE_GLOBAL:
+		*fullVolume = 0;
+		*attenuate = 0;	// always at full volume
+		break;
+	default:	// use normal attenuation.
+		*fullVolume = SOUND_FULLVOLUME;
+		break;
+	}
+}
 
-	// calculate stereo seperation and distance attenuation
-	VectorSubtract(origin, listener_origin, source_vec);
+/*
+=================
+S_SpatializeOrigins
 
-	dist = VectorNormalize(source_vec);
-	if ( channel == CHAN_VOICE )
-	{
-		dist -= SOUND_FULLVOLUME * 3.0f;
-//		dist_mult = VOICE_ATTENUATE;	// tweak added (this fixes an NPC dialogue "in your ears" bug, but we're not sure if it'll make a bunch of others fade too early. Too close to shipping...)
-	}
-	else if ( channel == CHAN_LESS_ATTEN )
-	{
-		dist -= SOUND_FULLVOLUME * 8.0f; // maybe is too large
-	}
-	else if ( channel == CHAN_VOICE_ATTEN )
-	{
-		dist -= SOUND_FULLVOLUME * 1.35f; // used to be 0.15f, dropped off too sharply - dmv
-		dist_mult = VOICE_ATTENUATE;
-	}
-	else if ( channel == CHAN_VOICE_GLOBAL )
-	{
-		dist = -1;
-	}
-	else	// use normal attenuation.
-	{
-		dist -= SOUND_FULLVOLUME;
-	}
+Spatializes count sounds in one pass, four at a time where SSE2 is available.
+The inputs and outputs are arrays of count entries each.
+=================
+*/
+static void S_SpatializeOrigins( int count, const vec3_t *origins, const float *master_vols, const int *channels, int *left_vols, int *right_vols )
+{
+	const float	separation = s_separation->value;
+	const bool	mono = dma.channels == 1;	// no attenuation = no spatialization
+	int			i = 0;
+
+#ifdef S_SPATIALIZE_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 signBit = _mm_set1_ps( -0.0f );
+	const __m128 sep = _mm_set1_ps( separation );
+	const __m128 sepScale = _mm_set1_ps( 1.0f - separation );
+	const __m128 maxVol = _mm_set1_ps( SOUND_FMAXVOL );
 
-	if (dist < 0)
+	for ( ; i + 4 <= count; i += 4 )
 	{
-		dist = 0;			// close enough to be at full volume
-	}
-	dist *= dist_mult;		// different attenuation levels
+		const vec3_t *o = origins + i;
+		float fullVolume[4], attenuate[4];
+
+		for ( int j = 0; j < 4; j++ )
+		{
+			S_ChannelAttenuation( channels[i + j], &fullVolume[j], &attenuate[j] );
+		}
+
+		// calculate stereo seperation and distance attenuation
+		__m128 x = _mm_sub_ps( _mm_setr_ps( o[0][0], o[1][0], o[2][0], o[3][0] ), _mm_set1_ps( listener_origin[0] ) );
+		__m128 y = _mm_sub_ps( _mm_setr_ps( o[0][1], o[1][1], o[2][1], o[3][1] ), _mm_set1_ps( listener_origin[1] ) );
+		__m128 z = _mm_sub_ps( _mm_setr_ps( o[0][2], o[1][2], o[2][2], o[3][2] ), _mm_set1_ps( listener_origin[2] ) );
+
+		__m128 dist = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) ) );
+		const __m128 idist = _mm_and_ps( _mm_cmpgt_ps( dist, zero ), _mm_div_ps( one, dist ) );
+		x = _mm_mul_ps( x, idist );
+		y = _mm_mul_ps( y, idist );
+		z = _mm_mul_ps( z, idist );
+
+		dist = _mm_sub_ps( dist, _mm_loadu_ps( fullVolume ) );
+		dist = _mm_mul_ps( _mm_max_ps( dist, zero ), _mm_loadu_ps( attenuate ) );
+
+		__m128 rscale = maxVol;
+		__m128 lscale = maxVol;
+		if ( !mono )
+		{
+			__m128 dot = _mm_add_ps( _mm_add_ps(
+				_mm_mul_ps( _mm_set1_ps( listener_axis[1][0] ), x ),
+				_mm_mul_ps( _mm_set1_ps( listener_axis[1][1] ), y ) ),
+				_mm_mul_ps( _mm_set1_ps( listener_axis[1][2] ), z ) );
+			dot = _mm_mul_ps( sepScale, _mm_xor_ps( dot, signBit ) );
+
+			rscale = _mm_max_ps( _mm_add_ps( sep, dot ), zero );
+			lscale = _mm_max_ps( _mm_sub_ps( sep, dot ), zero );
+		}
 
-	dot = -DotProduct(listener_axis[1], source_vec);
+		// add in distance effect
+		const __m128 fade = _mm_sub_ps( one, dist );
+		const __m128 vol = _mm_loadu_ps( master_vols + i );
+		const __m128 right = _mm_max_ps( _mm_mul_ps( vol, _mm_mul_ps( fade, rscale ) ), zero );
+		const __m128 left = _mm_max_ps( _mm_mul_ps( vol, _mm_mul_ps( fade, lscale ) ), zero );
 
-	if (dma.channels == 1)	// || !dist_mult)
-	{ // no attenuation = no spatialization
-		rscale = SOUND_FMAXVOL;
-		lscale = SOUND_FMAXVOL;
+		_mm_storeu_si128( (__m128i *)( right_vols + i ), _mm_cvttps_epi32( right ) );
+		_mm_storeu_si128( (__m128i *)( left_vols + i ), _mm_cvttps_epi32( left ) );
 	}
-	else
+#endif
+
+	for ( ; i < count; i++ )
 	{
-		//rscale = 0.5 * (1.0 + dot);
-		//lscale = 0.5 * (1.0 - dot);
-		rscale = s_separation->value + ( 1.0f - s_separation->value ) * dot;
-		lscale = s_separation->value - ( 1.0f - s_separation->value ) * dot;
-		if ( rscale < 0 )
+		float		dot;
+		float		dist;
+		float		lscale, rscale, scale;
+		float		fullVolume, attenuate;
+		vec3_t		source_vec;
+
+		// calculate stereo seperation and distance attenuation
+		VectorSubtract( origins[i], listener_origin, source_vec );
+
+		dist = VectorNormalize( source_vec );
+		S_ChannelAttenuation( channels[i], &fullVolume, &attenuate );
+		dist -= fullVolume;
+
+		if (dist < 0)
 		{
-			rscale = 0;
+			dist = 0;			// close enough to be at full volume
 		}
-		if ( lscale < 0 )
+		dist *= attenuate;		// different attenuation levels
+
+		dot = -DotProduct(listener_axis[1], source_vec);
+
+		if ( mono )
 		{
-			lscale = 0;
+			rscale = SOUND_FMAXVOL;
+			lscale = SOUND_FMAXVOL;
+		}
+		else
+		{
+			rscale = separation + ( 1.0f - separation ) * dot;
+			lscale = separation - ( 1.0f - separation ) * dot;
+			if ( rscale < 0 )
+			{
+				rscale = 0;
+			}
+			if ( lscale < 0 )
+			{
+				lscale = 0;
+			}
 		}
-	}
 
-	// add in distance effect
-	scale = (1.0f - dist) * rscale;
-	*right_vol = (int) (master_vol * scale);
-	if (*right_vol < 0)
-	{
-		*right_vol = 0;
-	}
+		// add in distance effect
+		scale = (1.0f - dist) * rscale;
+		right_vols[i] = (int) (master_vols[i] * scale);
+		if (right_vols[i] < 0)
+		{
+			right_vols[i] = 0;
+		}
 
-	scale = (1.0f - dist) * lscale;
-	*left_vol = (int) (master_vol * scale);
-	if (*left_vol < 0)
-	{
-		*left_vol = 0;
+		scale = (1.0f - dist) * lscale;
+		left_vols[i] = (int) (master_vols[i] * scale);
+		if (left_vols[i] < 0)
+		{
+			left_vols[i] = 0;
+		}
 	}
 }
 
+/*
+=================
+S_SpatializeOrigin
+
+Used for spatializing s_channels
+=================
+*/
+void S_SpatializeOrigin (const vec3_t origin, float master_vol, int *left_vol, int *right_vol, int channel)
+{
+	S_SpatializeOrigins( 1, (const vec3_t *)origin, &master_vol, &channel, left_vol, right_vol );
+}
+
 // =======================================================================
 // Start a sound effect
 // =======================================================================
@@ -2036,10 +2131,21 @@ sum up the channel multipliers.
 void S_AddLoopSounds (void)
 {
 	int			i, j;
-	int			left, right, left_total, right_total;
+	int			left_total, right_total;
 	channel_t	*ch;
 	loopSound_t	*loop, *loop2;
 	static int	loopFrame;
+	vec3_t		origins[MAX_LOOP_SOUNDS];
+	float		volumes[MAX_LOOP_SOUNDS];
+	int			channels[MAX_LOOP_SOUNDS];
+	int			left[MAX_LOOP_SOUNDS], right[MAX_LOOP_SOUNDS];
+
+	for ( i = 0 ; i < numLoopSounds ; i++ ) {
+		VectorCopy( loopSounds[i].origin, origins[i] );
+		volumes[i] = loopSounds[i].volume;	//FIXME: Allow for volume change!!
+		channels[i] = CHAN_AUTO;
+	}
+	S_SpatializeOrigins( numLoopSounds, origins, volumes, channels, left, right );
 
 	loopFrame++;
 	for ( i = 0 ; i < numLoopSounds ; i++) {
@@ -2058,10 +2164,8 @@ void S_AddLoopSounds (void)
 			}
 			loop2->mergeFrame = loopFrame;	// don't check this again later
 
-			S_SpatializeOrigin( loop2->origin, loop2->volume, &left, &right, CHAN_AUTO);	//FIXME: Allow for volume change!!
-
-			left_total += left;
-			right_total += right;
+			left_total += left[j];
+			right_total += right[j];
 		}
 
 		if (left_total == 0 && right_total == 0)
@@ -2506,9 +2610,12 @@ void S_Respatialize( int entityNum, const vec3_t head, matrix3_t axis, int inwat
 	EAXOCCLUSIONPROPERTIES eaxOCProp;
 	EAXACTIVEFXSLOTS eaxActiveSlots;
 #endif
-	int			i;
+	int			i, count;
 	channel_t	*ch;
-	vec3_t		origin;
+	vec3_t		origins[MAX_CHANNELS];
+	float		volumes[MAX_CHANNELS];
+	int			channels[MAX_CHANNELS];
+	int			left[MAX_CHANNELS], right[MAX_CHANNELS];
 
 	if ( !s_soundStarted || s_soundMuted ) {
 		return;
@@ -2611,7 +2718,9 @@ void S_Respatialize( int entityNum, const vec3_t head, matrix3_t axis, int inwat
 		VectorCopy(axis[1], listener_axis[1]);
 		VectorCopy(axis[2], listener_axis[2]);
 
-		// update spatialization for dynamic sounds
+		// update spatialization for dynamic sounds, gathering them up to be
+		// spatialized together
+		count = 0;
 		ch = s_channels;
 		for ( i = 0 ; i < MAX_CHANNELS ; i++, ch++ ) {
 			if ( !ch->thesfx ) {
@@ -2628,12 +2737,29 @@ void S_Respatialize( int entityNum, const vec3_t head, matrix3_t axis, int inwat
 				ch->rightvol = ch->master_vol;
 			} else {
 				if (ch->fixed_origin) {
-					VectorCopy( ch->origin, origin );
+					VectorCopy( ch->origin, origins[count] );
 				} else {
-					VectorCopy( s_entityPosition[ ch->entnum ], origin );
+					VectorCopy( s_entityPosition[ ch->entnum ], origins[count] );
 				}
+				volumes[count] = (float)ch->master_vol;
+				channels[count] = ch->entchannel;
+				count++;
+			}
+		}
+
+		S_SpatializeOrigins( count, origins, volumes, channels, left, right );
+
+		count = 0;
+		ch = s_channels;
+		for ( i = 0 ; i < MAX_CHANNELS ; i++, ch++ ) {
+			if ( !ch->thesfx ) {
+				continue;
+			}
 
-				S_SpatializeOrigin (origin, (float)ch->master_vol, &ch->leftvol, &ch->rightvol, ch->entchannel);
+			if (ch->entnum != listener_number) {
+				ch->leftvol = left[count];
+				ch->rightvol = right[count];
+				count++;
 			}
 
 			//NOTE: Made it so that voice sounds keep playing, even out of range
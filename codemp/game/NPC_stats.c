@@ -962,7 +962,7 @@ void NPC_BuildRandom( gentity_t *NPC )
 }
 #endif
 
-extern void SetupGameGhoul2Model(gentity_t *ent, char *modelname, char *skinName);
+extern void SetupGameGhoul2Model(gentity_t *ent, const char *modelname, char *skinName);
 qboolean NPC_ParseParms( const char *NPCName, gentity_t *NPC )
 {
 	const char	*token;
@@ -92,6 +92,7 @@ vmCvar_t bot_debugmessages;
 
 vmCvar_t bot_attachments;
 vmCvar_t bot_camp;
+vmCvar_t bot_thinkbudget;
 
 vmCvar_t bot_wp_info;
 vmCvar_t bot_wp_edit;
@@ -7518,6 +7519,21 @@ void StandardBotAI(bot_state_t *bs, float thinktime)
 
 int gUpdateVars = 0;
 
+/*
+==================
+BotCompareThinkResidual
+==================
+*/
+static int QDECL BotCompareThinkResidual( const void *a, const void *b ) {
+	const bot_state_t *bsa = botstates[*(const int *)a];
+	const bot_state_t *bsb = botstates[*(const int *)b];
+
+	if ( bsa->botthink_residual != bsb->botthink_residual ) {
+		return bsb->botthink_residual - bsa->botthink_residual;
+	}
+	return *(const int *)a - *(const int *)b;
+}
+
 /*
 ==================
 BotAIStartFrame
@@ -7526,6 +7542,8 @@ BotAIStartFrame
 int BotAIStartFrame(int time) {
 	int i;
 	int elapsed_time, thinktime;
+	int due[MAX_CLIENTS], numDue;
+	int budgetStart;
 	static int local_time;
 //	static int botlib_residual;
 	static int lastbotthink_time;
@@ -7535,6 +7553,7 @@ int BotAIStartFrame(int time) {
 		trap->Cvar_Update(&bot_pvstype);
 		trap->Cvar_Update(&bot_camp);
 		trap->Cvar_Update(&bot_attachments);
+		trap->Cvar_Update(&bot_thinkbudget);
 		trap->Cvar_Update(&bot_forgimmick);
 		trap->Cvar_Update(&bot_honorableduelacceptance);
 #ifndef FINAL_BUILD
@@ -7568,7 +7587,8 @@ int BotAIStartFrame(int time) {
 	if (elapsed_time > BOT_THINK_TIME) thinktime = elapsed_time;
 	else thinktime = BOT_THINK_TIME;
 
-	// execute scheduled bot AI
+	// find the bots due to think
+	numDue = 0;
 	for( i = 0; i < MAX_CLIENTS; i++ ) {
 		if( !botstates[i] || !botstates[i]->inuse ) {
 			continue;
@@ -7577,11 +7597,37 @@ int BotAIStartFrame(int time) {
 		botstates[i]->botthink_residual += elapsed_time;
 		//
 		if ( botstates[i]->botthink_residual >= thinktime ) {
-			botstates[i]->botthink_residual -= thinktime;
+			due[numDue++] = i;
+		}
+	}
 
-			if (g_entities[i].client->pers.connected == CON_CONNECTED) {
-				BotAI(i, (float) thinktime / 1000);
-			}
+	// execute scheduled bot AI, longest overdue first, until the frame's
+	// budget is spent. bots left over keep their residual and go first
+	// next frame, repeating their last input until then.
+	if ( numDue > 1 && bot_thinkbudget.integer > 0 ) {
+		qsort( due, numDue, sizeof( due[0] ), BotCompareThinkResidual );
+	}
+
+	budgetStart = trap->Milliseconds();
+	for( i = 0; i < numDue; i++ ) {
+		bot_state_t *bs = botstates[due[i]];
+		int owed;
+
+		if ( i > 0 && bot_thinkbudget.integer > 0
+			&& trap->Milliseconds() - budgetStart >= bot_thinkbudget.integer ) {
+			break;
+		}
+
+		// whole think intervals owed; thinks missed while deferred are
+		// folded into this one rather than run back to back
+		owed = thinktime;
+		if ( thinktime > 0 ) {
+			owed = bs->botthink_residual - bs->botthink_residual % thinktime;
+		}
+		bs->botthink_residual -= owed;
+
+		if (g_entities[due[i]].client->pers.connected == CON_CONNECTED) {
+			BotAI(due[i], (float) owed / 1000);
 		}
 	}
 
@@ -7623,6 +7669,7 @@ int BotAISetup( int restart ) {
 
 	trap->Cvar_Register(&bot_attachments, "bot_attachments", "1", 0);
 	trap->Cvar_Register(&bot_camp, "bot_camp", "1", 0);
+	trap->Cvar_Register(&bot_thinkbudget, "bot_thinkbudget", "20", 0);
 
 	trap->Cvar_Register(&bot_wp_info, "bot_wp_info", "1", 0);
 	trap->Cvar_Register(&bot_wp_edit, "bot_wp_edit", "0", CVAR_CHEAT);
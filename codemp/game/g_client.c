@@ -1559,7 +1559,7 @@ qboolean BG_IsValidCharacterModel(const char *modelName, const char *skinName);
 qboolean BG_ValidateSkinForTeam( const char *modelName, char *skinName, int team, float *colors );
 void BG_GetVehicleModelName(char *modelName, const char *vehicleName, size_t len);
 
-void SetupGameGhoul2Model(gentity_t *ent, char *modelname, char *skinName)
+void SetupGameGhoul2Model(gentity_t *ent, const char *modelname, char *skinName)
 {
 	int handle;
 	char		afilename[MAX_QPATH];
@@ -1952,7 +1952,7 @@ if desired.
 ============
 */
 
-qboolean G_SetSaber(gentity_t *ent, int saberNum, char *saberName, qboolean siegeOverride);
+qboolean G_SetSaber(gentity_t *ent, int saberNum, const char *saberName, qboolean siegeOverride);
 void G_ValidateSiegeClassForTeam(gentity_t *ent, int team);
 
 typedef struct userinfoValidate_s {
@@ -2110,11 +2110,12 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 	gentity_t *ent = g_entities + clientNum;
 	gclient_t *client = ent->client;
 	int team=TEAM_FREE, health=100, maxHealth=100, teamLeader;
-	const char *s=NULL;
-	char *value=NULL, userinfo[MAX_INFO_STRING], buf[MAX_INFO_STRING], oldClientinfo[MAX_INFO_STRING], model[MAX_QPATH],
+	const char *s=NULL, *value=NULL;
+	char userinfo[MAX_INFO_STRING], buf[MAX_INFO_STRING], oldClientinfo[MAX_INFO_STRING], model[MAX_QPATH],
 		forcePowers[DEFAULT_FORCEPOWERS_LEN], oldname[MAX_NETNAME], className[MAX_QPATH], color1[16], color2[16];
 	qboolean modelChanged = qfalse;
 	gender_t gender = GENDER_MALE;
+	infoDict_t info;
 
 	trap->GetUserinfo( clientNum, userinfo, sizeof( userinfo ) );
 
@@ -2127,19 +2128,21 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 		return qfalse;
 	}
 
+	InfoDict_Parse( &info, userinfo );
+
 	// check for local client
-	s = Info_ValueForKey( userinfo, "ip" );
+	s = InfoDict_ValueForKey( &info, "ip" );
 	if ( !strcmp( s, "localhost" ) && !(ent->r.svFlags & SVF_BOT) )
 		client->pers.localClient = qtrue;
 
 	// check the item prediction
-	s = Info_ValueForKey( userinfo, "cg_predictItems" );
+	s = InfoDict_ValueForKey( &info, "cg_predictItems" );
 	if ( !atoi( s ) )	client->pers.predictItemPickup = qfalse;
 	else				client->pers.predictItemPickup = qtrue;
 
 	// set name
 	Q_strncpyz( oldname, client->pers.netname, sizeof( oldname ) );
-	s = Info_ValueForKey( userinfo, "name" );
+	s = InfoDict_ValueForKey( &info, "name" );
 	ClientCleanName( s, client->pers.netname, sizeof( client->pers.netname ) );
 	Q_strncpyz( client->pers.netname_nocolor, client->pers.netname, sizeof( client->pers.netname_nocolor ) );
 	Q_StripColor( client->pers.netname_nocolor );
@@ -2153,8 +2156,8 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 		if ( client->pers.netnameTime > level.time ) {
 			trap->SendServerCommand( clientNum, va( "print \"%s\n\"", G_GetStringEdString( "MP_SVGAME", "NONAMECHANGE" ) ) );
 
-			Info_SetValueForKey( userinfo, "name", oldname );
-			trap->SetUserinfo( clientNum, userinfo );
+			InfoDict_SetValueForKey( &info, "name", oldname );
+			trap->SetUserinfo( clientNum, InfoDict_String( &info ) );
 			Q_strncpyz( client->pers.netname, oldname, sizeof( client->pers.netname ) );
 			Q_strncpyz( client->pers.netname_nocolor, oldname, sizeof( client->pers.netname_nocolor ) );
 			Q_StripColor( client->pers.netname_nocolor );
@@ -2167,16 +2170,16 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 	}
 
 	// set model
-	Q_strncpyz( model, Info_ValueForKey( userinfo, "model" ), sizeof( model ) );
+	Q_strncpyz( model, InfoDict_ValueForKey( &info, "model" ), sizeof( model ) );
 
 	if ( d_perPlayerGhoul2.integer&& Q_stricmp( model, client->modelname ) ) {
 		Q_strncpyz( client->modelname, model, sizeof( client->modelname ) );
 		modelChanged = qtrue;
 	}
 
-	client->ps.customRGBA[0] = (value=Info_ValueForKey( userinfo, "char_color_red" ))	? Com_Clampi( 0, 255, atoi( value ) ) : 255;
-	client->ps.customRGBA[1] = (value=Info_ValueForKey( userinfo, "char_color_green" ))	? Com_Clampi( 0, 255, atoi( value ) ) : 255;
-	client->ps.customRGBA[2] = (value=Info_ValueForKey( userinfo, "char_color_blue" ))	? Com_Clampi( 0, 255, atoi( value ) ) : 255;
+	client->ps.customRGBA[0] = (value=InfoDict_ValueForKey( &info, "char_color_red" ))	? Com_Clampi( 0, 255, atoi( value ) ) : 255;
+	client->ps.customRGBA[1] = (value=InfoDict_ValueForKey( &info, "char_color_green" ))	? Com_Clampi( 0, 255, atoi( value ) ) : 255;
+	client->ps.customRGBA[2] = (value=InfoDict_ValueForKey( &info, "char_color_blue" ))	? Com_Clampi( 0, 255, atoi( value ) ) : 255;
 
 	//Prevent skins being too dark
 	if ( g_charRestrictRGB.integer && ((client->ps.customRGBA[0]+client->ps.customRGBA[1]+client->ps.customRGBA[2]) < 100) )
@@ -2184,7 +2187,7 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 
 	client->ps.customRGBA[3]=255;
 
-	Q_strncpyz( forcePowers, Info_ValueForKey( userinfo, "forcepowers" ), sizeof( forcePowers ) );
+	Q_strncpyz( forcePowers, InfoDict_ValueForKey( &info, "forcepowers" ), sizeof( forcePowers ) );
 
 	// update our customRGBA for team colors.
 	if ( level.gametype >= GT_TEAM && level.gametype != GT_SIEGE && !g_jediVmerc.integer ) {
@@ -2200,7 +2203,7 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 
 	// bots set their team a few frames later
 	if ( level.gametype >= GT_TEAM && g_entities[clientNum].r.svFlags & SVF_BOT ) {
-		s = Info_ValueForKey( userinfo, "team" );
+		s = InfoDict_ValueForKey( &info, "team" );
 		if ( !Q_stricmp( s, "red" ) || !Q_stricmp( s, "r" ) )
 			team = TEAM_RED;
 		else if ( !Q_stricmp( s, "blue" ) || !Q_stricmp( s, "b" ) )
@@ -2267,8 +2270,8 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 	// only set the saber name on the first connect.
 	//	it will be read from userinfo on ClientSpawn and stored in client->pers.saber1/2
 	if ( !VALIDSTRING( client->pers.saber1 ) || !VALIDSTRING( client->pers.saber2 ) ) {
-		G_SetSaber( ent, 0, Info_ValueForKey( userinfo, "saber1" ), qfalse );
-		G_SetSaber( ent, 1, Info_ValueForKey( userinfo, "saber2" ), qfalse );
+		G_SetSaber( ent, 0, InfoDict_ValueForKey( &info, "saber1" ), qfalse );
+		G_SetSaber( ent, 1, InfoDict_ValueForKey( &info, "saber2" ), qfalse );
 	}
 
 	// set max health
@@ -2281,7 +2284,7 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 		health = maxHealth;
 	}
 	else
-		health = Com_Clampi( 1, 100, atoi( Info_ValueForKey( userinfo, "handicap" ) ) );
+		health = Com_Clampi( 1, 100, atoi( InfoDict_ValueForKey( &info, "handicap" ) ) );
 
 	client->pers.maxHealth = health;
 	if ( client->pers.maxHealth < 1 || client->pers.maxHealth > maxHealth )
@@ -2291,7 +2294,7 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 	if ( level.gametype >= GT_TEAM )
 		client->pers.teamInfo = qtrue;
 	else {
-		s = Info_ValueForKey( userinfo, "teamoverlay" );
+		s = InfoDict_ValueForKey( &info, "teamoverlay" );
 		if ( !*s || atoi( s ) != 0 )
 			client->pers.teamInfo = qtrue;
 		else
@@ -2304,17 +2307,17 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 	teamLeader = client->sess.teamLeader;
 
 	// colors
-	Q_strncpyz( color1, Info_ValueForKey( userinfo, "color1" ), sizeof( color1 ) );
-	Q_strncpyz( color2, Info_ValueForKey( userinfo, "color2" ), sizeof( color2 ) );
+	Q_strncpyz( color1, InfoDict_ValueForKey( &info, "color1" ), sizeof( color1 ) );
+	Q_strncpyz( color2, InfoDict_ValueForKey( &info, "color2" ), sizeof( color2 ) );
 
 	// gender hints
-	s = Info_ValueForKey( userinfo, "sex" );
+	s = InfoDict_ValueForKey( &info, "sex" );
 	if ( !Q_stricmp( s, "female" ) )
 		gender = GENDER_FEMALE;
 	else
 		gender = GENDER_MALE;
 
-	s = Info_ValueForKey( userinfo, "snaps" );
+	s = InfoDict_ValueForKey( &info, "snaps" );
 	if ( atoi( s ) < sv_fps.integer )
 		trap->SendServerCommand( clientNum, va( "print \"" S_COLOR_YELLOW "Recommend setting /snaps %d or higher to match this server's sv_fps\n\"", sv_fps.integer ) );
 
@@ -2332,7 +2335,7 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 	Q_strcat( buf, sizeof( buf ), va( "c2\\%s\\", color2 ) );
 	Q_strcat( buf, sizeof( buf ), va( "hc\\%i\\", client->pers.maxHealth ) );
 	if ( ent->r.svFlags & SVF_BOT )
-		Q_strcat( buf, sizeof( buf ), va( "skill\\%s\\", Info_ValueForKey( userinfo, "skill" ) ) );
+		Q_strcat( buf, sizeof( buf ), va( "skill\\%s\\", InfoDict_ValueForKey( &info, "skill" ) ) );
 	if ( level.gametype == GT_DUEL || level.gametype == GT_POWERDUEL ) {
 		Q_strcat( buf, sizeof( buf ), va( "w\\%i\\", client->sess.wins ) );
 		Q_strcat( buf, sizeof( buf ), va( "l\\%i\\", client->sess.losses ) );
@@ -2354,7 +2357,7 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 	// only going to be true for allowable server-side custom skeleton cases
 	if ( modelChanged ) {
 		// update the server g2 instance if appropriate
-		char *modelname = Info_ValueForKey( userinfo, "model" );
+		const char *modelname = InfoDict_ValueForKey( &info, "model" );
 		SetupGameGhoul2Model( ent, modelname, NULL );
 
 		if ( ent->ghoul2 && ent->client )
@@ -4463,6 +4463,11 @@ void G_Damage( gentity_t *targ, gentity_t *inflictor, gentity_t *attacker, vec3_
 		return;
 	}
 
+	if ( targ->r.contents & MASK_SOLID ) {
+		// breaking it may open a way through for splash damage
+		G_SplashVisInvalidate();
+	}
+
 	if ( (targ->flags&FL_SHIELDED) && mod != MOD_SABER  && !targ->client)
 	{//magnetically protected, this thing can only be damaged by lightsabers
 		return;
@@ -5605,19 +5610,148 @@ qboolean CanDamage (gentity_t *targ, vec3_t origin) {
 }
 
 
+// CanDamage answers for explosions at the last few spots, kept for the
+// frame they went off in, so that a burst of explosions at the same spot
+// traces each target once. They're dropped as soon as anything that blocks
+// the traces is freed, damaged or moved by a mover, since an earlier
+// explosion may have opened a way through. Solid entities switched on or
+// off some other way (by a script or a use function) in the same frame
+// aren't noticed, so a later explosion there may still see them as they
+// were.
+#define SPLASH_VIS_ORIGINS	4
+
+typedef enum {
+	SPLASH_VIS_UNKNOWN,
+	SPLASH_VIS_CLEAR,
+	SPLASH_VIS_BLOCKED
+} splashVisState_t;
+
+typedef struct splashVis_s {
+	int			time;
+	int			generation;					// splashVisGeneration when made
+	vec3_t		origin;
+	byte		state[MAX_GENTITIES];		// splashVisState_t
+	vec3_t		midpoint[MAX_GENTITIES];	// of the entity when it was traced
+} splashVis_t;
+
+static splashVis_t	splashVis[SPLASH_VIS_ORIGINS];
+static int			splashVisNext;
+static int			splashVisGeneration;
+
+/*
+============
+G_SplashVisInvalidate
+
+Something that blocks CanDamage's traces has changed, so the splash
+visibility answers worked out so far no longer hold.
+============
+*/
+void G_SplashVisInvalidate( void ) {
+	splashVisGeneration++;
+}
+
+static splashVis_t *G_SplashVisForOrigin( vec3_t origin ) {
+	splashVis_t	*vis;
+	int			i;
+
+	for ( i = 0; i < SPLASH_VIS_ORIGINS; i++ ) {
+		vis = &splashVis[i];
+		if ( vis->time == level.time && vis->generation == splashVisGeneration && VectorCompare( vis->origin, origin ) )
+			return vis;
+	}
+
+	vis = &splashVis[splashVisNext];
+	splashVisNext = (splashVisNext + 1) % SPLASH_VIS_ORIGINS;
+
+	vis->time = level.time;
+	vis->generation = splashVisGeneration;
+	VectorCopy( origin, vis->origin );
+	memset( vis->state, SPLASH_VIS_UNKNOWN, sizeof( vis->state ) );
+	return vis;
+}
+
+/*
+============
+CanDamageList
+
+CanDamage for each of a list of entities, done before any of them is
+damaged. Reuses the answers of earlier explosions at the same origin this
+frame, for entities that haven't moved since, as long as nothing solid
+has changed in between.
+============
+*/
+static void CanDamageList( vec3_t origin, const int *entityNums, int count, qboolean *canDamage ) {
+	splashVis_t	*vis = G_SplashVisForOrigin( origin );
+	int			e;
+
+	for ( e = 0; e < count; e++ ) {
+		const int	num = entityNums[e];
+		gentity_t	*ent = &g_entities[num];
+		vec3_t		midpoint;
+
+		VectorAdd( ent->r.absmin, ent->r.absmax, midpoint );
+		VectorScale( midpoint, 0.5f, midpoint );
+
+		if ( vis->state[num] == SPLASH_VIS_UNKNOWN || !VectorCompare( vis->midpoint[num], midpoint ) ) {
+			vis->state[num] = CanDamage( ent, origin ) ? SPLASH_VIS_CLEAR : SPLASH_VIS_BLOCKED;
+			VectorCopy( midpoint, vis->midpoint[num] );
+		}
+
+		canDamage[e] = (vis->state[num] == SPLASH_VIS_CLEAR) ? qtrue : qfalse;
+	}
+}
+
+/*
+============
+G_RadiusDamagePoints
+
+How much of the damage reaches ent, going by the distance from the edge of
+its bounding box. qfalse if it's out of the radius.
+============
+*/
+static qboolean G_RadiusDamagePoints( gentity_t *ent, vec3_t origin, float damage, float radius, float *points ) {
+	vec3_t	v;
+	float	dist;
+	int		i;
+
+	// find the distance from the edge of the bounding box
+	for ( i = 0 ; i < 3 ; i++ ) {
+		if ( origin[i] < ent->r.absmin[i] ) {
+			v[i] = ent->r.absmin[i] - origin[i];
+		} else if ( origin[i] > ent->r.absmax[i] ) {
+			v[i] = origin[i] - ent->r.absmax[i];
+		} else {
+			v[i] = 0;
+		}
+	}
+
+	dist = VectorLength( v );
+	if ( dist >= radius ) {
+		return qfalse;
+	}
+
+	*points = damage * ( 1.0 - dist / radius );
+	return qtrue;
+}
+
+
 /*
 ============
 G_RadiusDamage
+
+Visibility is worked out for every target before any of them is damaged,
+so breaking something open doesn't let this same explosion through to
+what's behind it. Later explosions see the change.
 ============
 */
 qboolean G_RadiusDamage ( vec3_t origin, gentity_t *attacker, float damage, float radius,
 					 gentity_t *ignore, gentity_t *missile, int mod) {
-	float		points, dist;
+	float		points;
 	gentity_t	*ent;
 	int			entityList[MAX_GENTITIES];
-	int			numListedEntities;
+	qboolean	canDamage[MAX_GENTITIES];
+	int			numListedEntities, numTargets;
 	vec3_t		mins, maxs;
-	vec3_t		v;
 	vec3_t		dir;
 	int			i, e;
 	qboolean	hitClient = qfalse;
@@ -5655,6 +5789,9 @@ qboolean G_RadiusDamage ( vec3_t origin, gentity_t *attacker, float damage, floa
 
 	numListedEntities = trap->EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
 
+	// narrow the list down to what's in the radius, then see what the
+	// explosion can reach all at once
+	numTargets = 0;
 	for ( e = 0 ; e < numListedEntities ; e++ ) {
 		ent = &g_entities[entityList[ e ]];
 
@@ -5662,29 +5799,27 @@ qboolean G_RadiusDamage ( vec3_t origin, gentity_t *attacker, float damage, floa
 			continue;
 		if (!ent->takedamage)
 			continue;
+		if ( !G_RadiusDamagePoints( ent, origin, damage, radius, &points ) )
+			continue;
 
-		// find the distance from the edge of the bounding box
-		for ( i = 0 ; i < 3 ; i++ ) {
-			if ( origin[i] < ent->r.absmin[i] ) {
-				v[i] = ent->r.absmin[i] - origin[i];
-			} else if ( origin[i] > ent->r.absmax[i] ) {
-				v[i] = origin[i] - ent->r.absmax[i];
-			} else {
-				v[i] = 0;
-			}
-		}
+		entityList[numTargets++] = entityList[e];
+	}
+
+	CanDamageList( origin, entityList, numTargets, canDamage );
+
+	for ( e = 0 ; e < numTargets ; e++ ) {
+		ent = &g_entities[entityList[ e ]];
 
-		dist = VectorLength( v );
-		if ( dist >= radius ) {
+		// damaging an earlier target can take this one out
+		if (!ent->inuse || !ent->takedamage)
+			continue;
+		if ( !G_RadiusDamagePoints( ent, origin, damage, radius, &points ) )
 			continue;
-		}
 
 	//	if ( ent->health <= 0 )
 	//		continue;
 
-		points = damage * ( 1.0 - dist / radius );
-
-		if( CanDamage (ent, origin) ) {
+		if( canDamage[e] ) {
 			if( LogAccuracyHit( ent, attacker ) ) {
 				hitClient = qtrue;
 			}
@@ -463,6 +463,9 @@ void G_MoverTeam( gentity_t *ent ) {
 		if ( !VectorCompare( move, vec3_origin )
 			|| !VectorCompare( amove, vec3_origin ) )
 		{//actually moved
+			if ( part->r.contents & MASK_SOLID ) {
+				G_SplashVisInvalidate();
+			}
 			if ( !G_MoverPush( part, move, amove, &obstacle ) ) {
 				break;	// move was blocked
 			}
@@ -944,6 +944,10 @@ void G_FreeEntity( gentity_t *ed ) {
 		return;
 	}
 
+	if ( ed->r.linked && (ed->r.contents & MASK_SOLID) ) {
+		G_SplashVisInvalidate();
+	}
+
 	trap->UnlinkEntity ((sharedEntity_t *)ed);		// unlink from world
 
 	trap->ICARUS_FreeEnt( (sharedEntity_t *)ed );	//ICARUS information must be added after this point
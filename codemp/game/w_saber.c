@@ -3823,6 +3823,61 @@ void WP_SaberBounceSound( gentity_t *ent, int saberNum, int bladeNum )
 	}
 }
 
+//contents only entities ever have, no map brush can be made of them
+#define SABER_ENTITY_ONLY_CONTENTS (CONTENTS_LIGHTSABER|CONTENTS_BODY)
+
+//rww - saber damage traces. A trace that can only hit entities (the saber-first
+//trace) is checked against the entities around its sweep first, and if none of
+//them has contents it can hit, it can't hit anything and the world doesn't need
+//tracing. The miss is filled in the same as the engine fills one in.
+static QINLINE void G_SaberDamageTrace( trace_t *tr, vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int passEntityNum, int trMask )
+{
+	if ( !(trMask & ~SABER_ENTITY_ONLY_CONTENTS) )
+	{
+		int entityList[MAX_GENTITIES];
+		int numListedEntities;
+		vec3_t boxMins, boxMaxs;
+		int i;
+
+		//same bounds the engine gathers entities to clip against in
+		for ( i = 0; i < 3; i++ )
+		{
+			if ( end[i] > start[i] )
+			{
+				boxMins[i] = start[i] + mins[i] - 1;
+				boxMaxs[i] = end[i] + maxs[i] + 1;
+			}
+			else
+			{
+				boxMins[i] = end[i] + mins[i] - 1;
+				boxMaxs[i] = start[i] + maxs[i] + 1;
+			}
+		}
+
+		numListedEntities = trap->EntitiesInBox( boxMins, boxMaxs, entityList, MAX_GENTITIES );
+
+		for ( i = 0; i < numListedEntities; i++ )
+		{
+			if ( entityList[i] != passEntityNum
+				&& (g_entities[entityList[i]].r.contents & trMask) )
+			{
+				break;
+			}
+		}
+
+		if ( i == numListedEntities )
+		{ //nothing it could hit is anywhere near it
+			memset( tr, 0, sizeof( *tr ) );
+			tr->fraction = 1.0f;
+			tr->entityNum = ENTITYNUM_NONE;
+			VectorCopy( end, tr->endpos );
+			return;
+		}
+	}
+
+	trap->Trace( tr, start, mins, maxs, end, passEntityNum, trMask, qfalse, 0, 0 );
+}
+
 static qboolean saberHitWall = qfalse;
 static qboolean saberHitSaber = qfalse;
 static float saberHitFraction = 1.0f;
@@ -3936,7 +3991,7 @@ static QINLINE qboolean CheckSaberDamage(gentity_t *self, int rSaberNum, int rBl
 			oldSaberEnd[1] = oldSaberStart[1] - (oldSaberDif[1]*trDif);
 			oldSaberEnd[2] = oldSaberStart[2] - (oldSaberDif[2]*trDif);
 
-			trap->Trace(&tr, saberEnd, saberTrMins, saberTrMaxs, saberStart, self->s.number, trMask, qfalse, 0, 0);
+			G_SaberDamageTrace(&tr, saberEnd, saberTrMins, saberTrMaxs, saberStart, self->s.number, trMask);
 
 			VectorCopy(saberEnd, lastValidStart);
 			VectorCopy(saberStart, lastValidEnd);
@@ -3983,7 +4038,7 @@ static QINLINE qboolean CheckSaberDamage(gentity_t *self, int rSaberNum, int rBl
 				oldSaberEnd[1] = oldSaberStart[1] - (oldSaberDif[1]*trDif);
 				oldSaberEnd[2] = oldSaberStart[2] - (oldSaberDif[2]*trDif);
 
-				trap->Trace(&tr, saberEnd, saberTrMins, saberTrMaxs, saberStart, self->s.number, trMask, qfalse, 0, 0);
+				G_SaberDamageTrace(&tr, saberEnd, saberTrMins, saberTrMaxs, saberStart, self->s.number, trMask);
 
 				VectorCopy(saberEnd, lastValidStart);
 				VectorCopy(saberStart, lastValidEnd);
@@ -4019,7 +4074,7 @@ static QINLINE qboolean CheckSaberDamage(gentity_t *self, int rSaberNum, int rBl
 			{
 				VectorCopy( saberEnd, saberEndExtrapolated );
 			}
-			trap->Trace(&tr, saberStart, saberTrMins, saberTrMaxs, saberEndExtrapolated, self->s.number, trMask, qfalse, 0, 0);
+			G_SaberDamageTrace(&tr, saberStart, saberTrMins, saberTrMaxs, saberEndExtrapolated, self->s.number, trMask);
 
 			VectorCopy(saberStart, lastValidStart);
 			VectorCopy(saberEndExtrapolated, lastValidEnd);
@@ -36,6 +36,115 @@ portable C
 
 #include "config.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WINDOW_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef WINDOW_SSE2
+/*-------------------------------------------------------------------------*/
+/* wincoef rearranged so that the coefs of four neighbouring outputs
+   load together, [pass][group of 4 outputs][tap][output in group] */
+static float wincoef4[2][4][16][4];	// effectively constant
+static int wincoef4_done;
+
+static void window_init4(void)
+{
+   int g, j, k, i;
+
+   for (g = 0; g < 4; g++)
+   {
+      for (j = 0; j < 16; j++)
+      {
+	 for (k = 0; k < 4; k++)
+	 {
+	    i = 4 * g + k;
+	    wincoef4[0][g][j][k] = wincoef[16 * i + j];
+	    wincoef4[1][g][j][k] = (i < 15) ? wincoef[255 - 16 * i - j] : 0.0F;	/* only 15 in the back pass */
+	 }
+      }
+   }
+   wincoef4_done = 1;
+}
+
+/* vbuf[p], vbuf[p-1], vbuf[p-2], vbuf[p-3] */
+static __m128 window_load_rev(const float *p)
+{
+   __m128 v = _mm_loadu_ps(p - 3);
+
+   return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static void window_store4(__m128 sum, short *pcm, int step, int n)
+{
+   int tmp[4];
+   int k;
+
+   sum = _mm_max_ps(sum, _mm_set1_ps(-32768.0F));
+   sum = _mm_min_ps(sum, _mm_set1_ps(32767.0F));
+   _mm_storeu_si128((__m128i *) tmp, _mm_cvttps_epi32(sum));
+   for (k = 0; k < n; k++)
+      pcm[k * step] = (short)tmp[k];
+}
+
+/*-------------------------------------------------------------------------*/
+/* window for four outputs at a time, summing in the same order as the
+   portable C does.  vb_ptr must be a multiple of 32, so that the four
+   neighbouring taps of each step never wrap around vbuf. */
+static void window_sse2(float *vbuf, int vb_ptr, short *pcm, int step)
+{
+   int g, j;
+   int si, bx;
+   const float (*coef4)[4];
+   __m128 sum4;
+   float sum;
+   long tmp;
+
+   if (!wincoef4_done)
+      window_init4();
+
+/*-- first 16 --*/
+   for (g = 0; g < 4; g++)
+   {
+      coef4 = wincoef4[0][g];
+      si = vb_ptr + 16 + 4 * g;
+      bx = vb_ptr + 48 - 4 * g;
+      sum4 = _mm_setzero_ps();
+      for (j = 0; j < 8; j++)
+      {
+	 sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_loadu_ps(coef4[2 * j]), _mm_loadu_ps(vbuf + ((si + 64 * j) & 511))));
+	 sum4 = _mm_sub_ps(sum4, _mm_mul_ps(_mm_loadu_ps(coef4[2 * j + 1]), window_load_rev(vbuf + ((bx + 64 * j) & 511))));
+      }
+      window_store4(sum4, pcm + 4 * g * step, step, 4);
+   }
+/*--  special case --*/
+   bx = vb_ptr + 32;
+   sum = 0.0F;
+   for (j = 0; j < 8; j++)
+      sum += wincoef[256 + j] * vbuf[(bx + 64 * j) & 511];
+   tmp = (long) sum;
+   if (tmp > 32767)
+      tmp = 32767;
+   else if (tmp < -32768)
+      tmp = -32768;
+   pcm[16 * step] = (short)tmp;
+/*-- last 15 --*/
+   for (g = 0; g < 4; g++)
+   {
+      coef4 = wincoef4[1][g];
+      si = vb_ptr + 31 - 4 * g;
+      bx = vb_ptr + 33 + 4 * g;
+      sum4 = _mm_setzero_ps();
+      for (j = 0; j < 8; j++)
+      {
+	 sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_loadu_ps(coef4[2 * j]), window_load_rev(vbuf + ((si + 64 * j) & 511))));
+	 sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_loadu_ps(coef4[2 * j + 1]), _mm_loadu_ps(vbuf + ((bx + 64 * j) & 511))));
+      }
+      window_store4(sum4, pcm + (17 + 4 * g) * step, step, (g < 3) ? 4 : 3);
+   }
+}
+#endif
+
 /*-------------------------------------------------------------------------*/
 void window(float *vbuf, int vb_ptr, short *pcm)
 {
@@ -45,6 +154,14 @@ void window(float *vbuf, int vb_ptr, short *pcm)
    float sum;
    long tmp;
 
+#ifdef WINDOW_SSE2
+   if (!(vb_ptr & 31))
+   {
+      window_sse2(vbuf, vb_ptr, pcm, 1);
+      return;
+   }
+#endif
+
    si = vb_ptr + 16;
    bx = (si + 32) & 511;
    coef = wincoef;
@@ -116,6 +233,14 @@ void window_dual(float *vbuf, int vb_ptr, short *pcm)
    float sum;
    long tmp;
 
+#ifdef WINDOW_SSE2
+   if (!(vb_ptr & 31))
+   {
+      window_sse2(vbuf, vb_ptr, pcm, 2);
+      return;
+   }
+#endif
+
    si = vb_ptr + 16;
    bx = (si + 32) & 511;
    coef = wincoef;
@@ -43,6 +43,11 @@ inplace ok.
 #include <float.h>
 #include <math.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMDCT_SSE2
+#include <emmintrin.h>
+#endif
+
 
 /*------ 18 point xform -------*/
 float mdct18w[18];		// effectively constant
@@ -78,14 +83,47 @@ const IMDCT_INIT_BLOCK *imdct_init_addr_6()
    return &imdct_info_6;
 }
 /*--------------------------------------------------------------------*/
+#ifdef IMDCT_SSE2
+/* f[p], f[p-1], f[p-2], f[p-3] */
+static __m128 imdct_load_rev(const float *f)
+{
+   __m128 v = _mm_loadu_ps(f - 3);
+
+   return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+#endif
+/*--------------------------------------------------------------------*/
 void imdct18(float f[18])	/* 18 point */
 {
    int p;
    float a[9], b[9];
+#ifndef IMDCT_SSE2
    float ap, bp, a8p, b8p;
+#endif
    float g1, g2;
 
-
+#ifdef IMDCT_SSE2
+   /* the first butterflies, p = 0..3 side by side */
+   {
+      __m128 g14, g24, ap4, bp4, a8p4, b8p4;
+
+      g14 = _mm_mul_ps(_mm_loadu_ps(mdct18w), _mm_loadu_ps(f));
+      g24 = _mm_mul_ps(imdct_load_rev(mdct18w + 17), imdct_load_rev(f + 17));
+      ap4 = _mm_add_ps(g14, g24);
+      bp4 = _mm_mul_ps(_mm_loadu_ps(mdct18w2), _mm_sub_ps(g14, g24));
+
+      g14 = _mm_mul_ps(imdct_load_rev(mdct18w + 8), imdct_load_rev(f + 8));
+      g24 = _mm_mul_ps(_mm_loadu_ps(mdct18w + 9), _mm_loadu_ps(f + 9));
+      a8p4 = _mm_add_ps(g14, g24);
+      b8p4 = _mm_mul_ps(imdct_load_rev(mdct18w2 + 8), _mm_sub_ps(g14, g24));
+
+      _mm_storeu_ps(a, _mm_add_ps(ap4, a8p4));
+      _mm_storeu_ps(a + 5, _mm_sub_ps(ap4, a8p4));
+      _mm_storeu_ps(b, _mm_add_ps(bp4, b8p4));
+      _mm_storeu_ps(b + 5, _mm_sub_ps(bp4, b8p4));
+      p = 4;
+   }
+#else
    for (p = 0; p < 4; p++)
    {
       g1 = mdct18w[p] * f[p];
@@ -105,6 +143,7 @@ void imdct18(float f[18])	/* 18 point */
       b[p] = bp + b8p;
       b[5 + p] = bp - b8p;
    }
+#endif
    g1 = mdct18w[p] * f[p];
    g2 = mdct18w[17 - p] * f[17 - p];
    a[p] = g1 + g2;
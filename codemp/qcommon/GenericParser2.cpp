@@ -23,6 +23,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "GenericParser2.h"
 
 #include <cstring>
+#include <new>
 #include "qcommon/qcommon.h"
 
 #define MAX_TOKEN_SIZE	1024
@@ -214,6 +215,29 @@ char *CTextPool::AllocText(char *text, bool addNULL, CTextPool **poolPtr)
 	return mPool + mUsed - length;
 }
 
+void *CTextPool::AllocBlock(int size, CTextPool **poolPtr)
+{
+	int	offset = (mUsed + 15) & ~15;
+
+	if (offset + size + 1 > mSize)
+	{	// extra 1 to leave room for AllocText's null on the end
+		if (poolPtr)
+		{
+			(*poolPtr)->SetNext(new CTextPool(mSize));
+			*poolPtr = (*poolPtr)->GetNext();
+
+			return (*poolPtr)->AllocBlock(size);
+		}
+
+		return 0;
+	}
+
+	mUsed = offset + size;
+	mPool[mUsed] = 0;
+
+	return mPool + offset;
+}
+
 void CleanTextPool(CTextPool *pool)
 {
 	CTextPool *next;
@@ -236,10 +260,39 @@ CGPObject::CGPObject(const char *initName) :
 	mName(initName),
 	mNext(0),
 	mInOrderNext(0),
-	mInOrderPrevious(0)
+	mInOrderPrevious(0),
+	mInTextPool(false)
 {
 }
 
+template<typename T>
+T *CGPObject::Create(CTextPool **textPool, const char *initName)
+{
+	T		*object;
+	void	*block;
+
+	if (textPool && (block = (*textPool)->AllocBlock(sizeof(T), textPool)) != 0)
+	{
+		object = new(block) T(initName);
+		object->mInTextPool = true;
+		return object;
+	}
+
+	return new T(initName);
+}
+
+void CGPObject::Destroy(CGPObject *which)
+{
+	if (which->mInTextPool)
+	{	// the memory goes with the text pool
+		which->~CGPObject();
+	}
+	else
+	{
+		delete which;
+	}
+}
+
 bool CGPObject::WriteText(CTextPool **textPool, const char *text)
 {
    if (strchr(text, ' ') || !text[0])
@@ -286,7 +339,7 @@ CGPValue::~CGPValue(void)
 	while(mList)
 	{
 		next = mList->GetNext();
-		delete mList;
+		Destroy(mList);
 		mList = next;
 	}
 }
@@ -347,27 +400,30 @@ const char *CGPValue::GetTopValue(void)
 
 void CGPValue::AddValue(const char *newValue, CTextPool **textPool)
 {
+	CGPObject	*newObject;
+
 	if (textPool)
 	{
 		newValue = (*textPool)->AllocText((char *)newValue, true, textPool);
 	}
 
+	newObject = Create<CGPObject>(textPool, newValue);
+
 	if (mList == 0)
 	{
-		mList = new CGPObject(newValue);
+		mList = newObject;
 		mList->SetInOrderNext(mList);
 	}
 	else
 	{
-		mList->GetInOrderNext()->SetNext(new CGPObject(newValue));
-		mList->SetInOrderNext(mList->GetInOrderNext()->GetNext());
+		mList->GetInOrderNext()->SetNext(newObject);
+		mList->SetInOrderNext(newObject);
 	}
 }
 
 bool CGPValue::Parse(char **dataPtr, CTextPool **textPool)
 {
 	char		*token;
-	char		*value;
 
 	while(1)
 	{
@@ -382,8 +438,7 @@ bool CGPValue::Parse(char **dataPtr, CTextPool **textPool)
 			break;
 		}
 
-		value = (*textPool)->AllocText(token, true, textPool);
-		AddValue(value);
+		AddValue(token, textPool);
 	}
 
 	return true;
@@ -460,6 +515,91 @@ bool CGPValue::Write(CTextPool **textPool, int depth)
 
 
 
+#define GP_MIN_INDEXED	8		// fewer pairs or sub groups than this are just searched in order
+
+static int GP_HashName(const char *name, size_t length)
+{
+	unsigned int	hash = 2166136261u;
+	size_t			i;
+	int				c;
+
+	for(i=0;i<length;i++)
+	{
+		c = (unsigned char)name[i];
+		if (c >= 'A' && c <= 'Z')
+		{
+			c += 'a' - 'A';
+		}
+		hash = (hash ^ c) * 16777619u;
+	}
+
+	return (int)(hash & 0x7fffffff);
+}
+
+static bool GP_NameMatches(CGPObject *object, const char *name, size_t length)
+{
+	return strlen(object->GetName()) == length && Q_stricmpn(object->GetName(), name, length) == 0;
+}
+
+// hashes the list by name with open addressing; the first of several with the same name wins,
+// as it would searching the list in order
+static void BuildIndex(CGPObject *list, CGPObject ***index, int *indexSize)
+{
+	CGPObject	*object;
+	int			count, size, slot;
+	size_t		length;
+
+	count = 0;
+	for(object=list;object;object=object->GetNext())
+	{
+		count++;
+	}
+
+	if (count < GP_MIN_INDEXED)
+	{
+		*indexSize = -1;
+		return;
+	}
+
+	for(size=16;size<count*2;size<<=1)
+	{
+	}
+
+	*index = (CGPObject **)Z_Malloc(size * sizeof(CGPObject *), TAG_TEXTPOOL, qtrue);
+	*indexSize = size;
+
+	for(object=list;object;object=object->GetNext())
+	{
+		length = strlen(object->GetName());
+		slot = GP_HashName(object->GetName(), length) & (size - 1);
+		while((*index)[slot] && !GP_NameMatches((*index)[slot], object->GetName(), length))
+		{
+			slot = (slot + 1) & (size - 1);
+		}
+		if (!(*index)[slot])
+		{
+			(*index)[slot] = object;
+		}
+	}
+}
+
+static CGPObject *FindInIndex(CGPObject **index, int indexSize, const char *name, size_t length)
+{
+	int		slot;
+
+	slot = GP_HashName(name, length) & (indexSize - 1);
+	while(index[slot])
+	{
+		if (GP_NameMatches(index[slot], name, length))
+		{
+			return index[slot];
+		}
+		slot = (slot + 1) & (indexSize - 1);
+	}
+
+	return 0;
+}
+
 CGPGroup::CGPGroup(const char *initName, CGPGroup *initParent) :
 	CGPObject(initName),
 	mPairs(0),
@@ -469,7 +609,11 @@ CGPGroup::CGPGroup(const char *initName, CGPGroup *initParent) :
 	mInOrderSubGroups(0),
 	mCurrentSubGroup(0),
 	mParent(initParent),
-	mWriteable(false)
+	mWriteable(false),
+	mPairIndex(0),
+	mSubGroupIndex(0),
+	mPairIndexSize(0),
+	mSubGroupIndexSize(0)
 {
 }
 
@@ -512,22 +656,39 @@ int CGPGroup::GetNumPairs(void)
 	return(count);
 }
 
+void CGPGroup::ClearIndexes(void)
+{
+	if (mPairIndex)
+	{
+		Z_Free(mPairIndex);
+	}
+	if (mSubGroupIndex)
+	{
+		Z_Free(mSubGroupIndex);
+	}
+
+	mPairIndex = mSubGroupIndex = 0;
+	mPairIndexSize = mSubGroupIndexSize = 0;
+}
+
 void CGPGroup::Clean(void)
 {
 	while(mPairs)
 	{
 		mCurrentPair = (CGPValue *)mPairs->GetNext();
-		delete mPairs;
+		Destroy(mPairs);
 		mPairs = mCurrentPair;
 	}
 
 	while(mSubGroups)
 	{
 		mCurrentSubGroup = (CGPGroup *)mSubGroups->GetNext();
-		delete mSubGroups;
+		Destroy(mSubGroups);
 		mSubGroups = mCurrentSubGroup;
 	}
 
+	ClearIndexes();
+
 	mPairs = mInOrderPairs = mCurrentPair = 0;
 	mSubGroups = mInOrderSubGroups = mCurrentSubGroup = 0;
 	mParent = 0;
@@ -577,6 +738,8 @@ void CGPGroup::SortObject(CGPObject *object, CGPObject **unsortedList, CGPObject
 {
 	CGPObject	*test, *last;
 
+	ClearIndexes();
+
 	if (!*unsortedList)
 	{
 		*unsortedList = *sortedList = object;
@@ -624,13 +787,13 @@ CGPValue *CGPGroup::AddPair(const char *name, const char *value, CTextPool **tex
 	if (textPool)
 	{
 		name = (*textPool)->AllocText((char *)name, true, textPool);
-		if (value)
-		{
-			value = (*textPool)->AllocText((char *)value, true, textPool);
-		}
 	}
 
-	newPair = new CGPValue(name, value);
+	newPair = Create<CGPValue>(textPool, name);
+	if (value)
+	{
+		newPair->AddValue(value, textPool);
+	}
 
 	AddPair(newPair);
 
@@ -652,7 +815,8 @@ CGPGroup *CGPGroup::AddGroup(const char *name, CTextPool **textPool)
 		name = (*textPool)->AllocText((char *)name, true, textPool);
 	}
 
-	newGroup = new CGPGroup(name, this);
+	newGroup = Create<CGPGroup>(textPool, name);
+	newGroup->mParent = this;
 
 	AddGroup(newGroup);
 
@@ -669,6 +833,15 @@ CGPGroup *CGPGroup::FindSubGroup(const char *name)
 {
 	CGPGroup	*group;
 
+	if (!mSubGroupIndexSize)
+	{
+		BuildIndex(mSubGroups, &mSubGroupIndex, &mSubGroupIndexSize);
+	}
+	if (mSubGroupIndex)
+	{
+		return (CGPGroup *)FindInIndex(mSubGroupIndex, mSubGroupIndexSize, name, strlen(name));
+	}
+
 	group = mSubGroups;
 	while(group)
 	{
@@ -818,6 +991,22 @@ CGPValue *CGPGroup::FindPair(const char *key)
 			next = pos + length;
 		}
 
+		if (!mPairIndexSize)
+		{
+			BuildIndex(mPairs, &mPairIndex, &mPairIndexSize);
+		}
+		if (mPairIndex)
+		{
+			pair = (CGPValue *)FindInIndex(mPairIndex, mPairIndexSize, pos, length);
+			if (pair)
+			{
+				return pair;
+			}
+
+			pos = next;
+			continue;
+		}
+
 		pair = mPairs;
 		while(pair)
 		{
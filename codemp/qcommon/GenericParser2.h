@@ -58,6 +58,7 @@ public:
 	int			GetUsed(void) { return mUsed; }
 
 	char		*AllocText(char *text, bool addNULL = true, CTextPool **poolPtr = 0);
+	void		*AllocBlock(int size, CTextPool **poolPtr = 0);
 };
 
 void CleanTextPool(CTextPool *pool);
@@ -67,6 +68,7 @@ class CGPObject
 protected:
 	const char	*mName;
 	CGPObject	*mNext, *mInOrderNext, *mInOrderPrevious;
+	bool		mInTextPool;	// allocated by the parser alongside its text, so freed along with it
 
 public:
 				CGPObject(const char *initName);
@@ -82,6 +84,11 @@ public:
 	void		SetInOrderPrevious(CGPObject *which) { mInOrderPrevious = which; }
 
 	bool		WriteText(CTextPool **textPool, const char *text);
+
+	// objects made while parsing live in the text pool, everything else is new'd
+	template<typename T>
+	static T	*Create(CTextPool **textPool, const char *initName);
+	static void	Destroy(CGPObject *which);
 };
 
 
@@ -121,8 +128,14 @@ private:
 	CGPGroup			*mParent;
 	bool				mWriteable;
 
+	// the pairs and sub groups hashed by name, built the first time they're searched
+	// once there are enough of them to be worth it
+	CGPObject			**mPairIndex, **mSubGroupIndex;
+	int					mPairIndexSize, mSubGroupIndexSize;	// 0 when not built yet, -1 when not worth it
+
 	void	SortObject(CGPObject *object, CGPObject **unsortedList, CGPObject **sortedList,
 					   CGPObject **lastObject);
+	void	ClearIndexes(void);
 
 public:
 				CGPGroup(const char *initName = "Top Level", CGPGroup *initParent = 0);
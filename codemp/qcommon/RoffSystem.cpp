@@ -46,7 +46,8 @@ CROFFSystem::CROFF::CROFF( const char *file, int id )
 	strcpy( mROFFFilePath, file );
 
 	mID				= id;
-	mMoveRotateList = NULL;
+	mFrames			= NULL;
+	mFrameNotes		= NULL;
 	mNoteTrackIndexes = 0;
 	mUsedByClient = mUsedByServer = qfalse;
 }
@@ -64,9 +65,14 @@ CROFFSystem::CROFF::CROFF( const char *file, int id )
 //---------------------------------------------------------------------------
 CROFFSystem::CROFF::~CROFF()
 {
-	if ( mMoveRotateList )
+	if ( mFrames )
 	{
-		delete [] mMoveRotateList;
+		delete [] mFrames;
+	}
+
+	if ( mFrameNotes )
+	{
+		delete [] mFrameNotes;
 	}
 
 	if (mNoteTrackIndexes)
@@ -99,6 +105,7 @@ qboolean CROFFSystem::Restart()
 		mROFFList.erase( itr );
 		itr = mROFFList.begin();
 	}
+	mROFFNames.clear();
 
 	// clear CROFFSystem unique ID counter
 	mID = 0;
@@ -167,33 +174,28 @@ qboolean CROFFSystem::InitROFF( unsigned char *data, CROFF *obj )
 		return InitROFF2(data, obj);
 	}
 
-	obj->mROFFEntries		= LittleLong(hdr->mCount);
-	obj->mMoveRotateList	= new TROFF2Entry[((int)LittleFloat(hdr->mCount))];
+	obj->mROFFEntries		= (int)LittleFloat(hdr->mCount);
+	obj->mFrames			= new float[obj->mROFFEntries * ROFF_FRAME_FLOATS];
+	obj->mFrameNotes		= NULL;
 	obj->mFrameTime			= 1000 / ROFF_SAMPLE_RATE;		// default 10 hz
 	obj->mLerp				= ROFF_SAMPLE_RATE;
 	obj->mNumNoteTracks		= 0;
 	obj->mNoteTrackIndexes	= 0;
 
-	if ( obj->mMoveRotateList != 0 )
+	if ( obj->mFrames != 0 )
 	{ // Step past the header to get to the goods
 		TROFFEntry *roff_data = ( TROFFEntry *)&hdr[1];
+		float *frame = obj->mFrames;
 
 		// Copy all of the goods into our ROFF cache
-		for ( i = 0; i < LittleLong(hdr->mCount); i++ )
+		for ( i = 0; i < obj->mROFFEntries; i++, frame += ROFF_FRAME_FLOATS )
 		{
-#ifdef Q3_BIG_ENDIAN
-			obj->mMoveRotateList[i].mOriginOffset[0] = LittleFloat(roff_data[i].mOriginOffset[0]);
-			obj->mMoveRotateList[i].mOriginOffset[1] = LittleFloat(roff_data[i].mOriginOffset[1]);
-			obj->mMoveRotateList[i].mOriginOffset[2] = LittleFloat(roff_data[i].mOriginOffset[2]);
-			obj->mMoveRotateList[i].mRotateOffset[0] = LittleFloat(roff_data[i].mRotateOffset[0]);
-			obj->mMoveRotateList[i].mRotateOffset[1] = LittleFloat(roff_data[i].mRotateOffset[1]);
-			obj->mMoveRotateList[i].mRotateOffset[2] = LittleFloat(roff_data[i].mRotateOffset[2]);
-#else
-			VectorCopy( roff_data[i].mOriginOffset, obj->mMoveRotateList[i].mOriginOffset );
-			VectorCopy( roff_data[i].mRotateOffset, obj->mMoveRotateList[i].mRotateOffset );
-#endif
-			obj->mMoveRotateList[i].mStartNote = -1;
-			obj->mMoveRotateList[i].mNumNotes = 0;
+			frame[0] = LittleFloat(roff_data[i].mOriginOffset[0]);
+			frame[1] = LittleFloat(roff_data[i].mOriginOffset[1]);
+			frame[2] = LittleFloat(roff_data[i].mOriginOffset[2]);
+			frame[3] = LittleFloat(roff_data[i].mRotateOffset[0]);
+			frame[4] = LittleFloat(roff_data[i].mRotateOffset[1]);
+			frame[5] = LittleFloat(roff_data[i].mRotateOffset[2]);
 		}
 
 		FixBadAngles(obj);
@@ -224,31 +226,33 @@ qboolean CROFFSystem::InitROFF2( unsigned char *data, CROFF *obj )
 	TROFF2Header *hdr = (TROFF2Header *)data;
 
 	obj->mROFFEntries		= LittleLong(hdr->mCount);
-	obj->mMoveRotateList	= new TROFF2Entry[LittleLong(hdr->mCount)];
+	obj->mFrames			= new float[LittleLong(hdr->mCount) * ROFF_FRAME_FLOATS];
 	obj->mFrameTime			= LittleLong(hdr->mFrameRate);
 	obj->mLerp				= 1000 / LittleLong(hdr->mFrameRate);
 	obj->mNumNoteTracks		= LittleLong(hdr->mNumNotes);
+	// notes can only be played if there are note tracks to point at
+	obj->mFrameNotes		= obj->mNumNoteTracks ? new int[LittleLong(hdr->mCount) * 2] : NULL;
 
-	if ( obj->mMoveRotateList != 0 )
+	if ( obj->mFrames != 0 )
 	{ // Step past the header to get to the goods
 		TROFF2Entry *roff_data = ( TROFF2Entry *)&hdr[1];
+		float *frame = obj->mFrames;
 
 		// Copy all of the goods into our ROFF cache
-		for ( i = 0; i < LittleLong(hdr->mCount); i++ )
+		for ( i = 0; i < LittleLong(hdr->mCount); i++, frame += ROFF_FRAME_FLOATS )
 		{
-#ifdef Q3_BIG_ENDIAN
-			obj->mMoveRotateList[i].mOriginOffset[0] = LittleFloat(roff_data[i].mOriginOffset[0]);
-			obj->mMoveRotateList[i].mOriginOffset[1] = LittleFloat(roff_data[i].mOriginOffset[1]);
-			obj->mMoveRotateList[i].mOriginOffset[2] = LittleFloat(roff_data[i].mOriginOffset[2]);
-			obj->mMoveRotateList[i].mRotateOffset[0] = LittleFloat(roff_data[i].mRotateOffset[0]);
-			obj->mMoveRotateList[i].mRotateOffset[1] = LittleFloat(roff_data[i].mRotateOffset[1]);
-			obj->mMoveRotateList[i].mRotateOffset[2] = LittleFloat(roff_data[i].mRotateOffset[2]);
-#else
-			VectorCopy( roff_data[i].mOriginOffset, obj->mMoveRotateList[i].mOriginOffset );
-			VectorCopy( roff_data[i].mRotateOffset, obj->mMoveRotateList[i].mRotateOffset );
-#endif
-			obj->mMoveRotateList[i].mStartNote = LittleLong(roff_data[i].mStartNote);
-			obj->mMoveRotateList[i].mNumNotes = LittleLong(roff_data[i].mNumNotes);
+			frame[0] = LittleFloat(roff_data[i].mOriginOffset[0]);
+			frame[1] = LittleFloat(roff_data[i].mOriginOffset[1]);
+			frame[2] = LittleFloat(roff_data[i].mOriginOffset[2]);
+			frame[3] = LittleFloat(roff_data[i].mRotateOffset[0]);
+			frame[4] = LittleFloat(roff_data[i].mRotateOffset[1]);
+			frame[5] = LittleFloat(roff_data[i].mRotateOffset[2]);
+
+			if ( obj->mFrameNotes )
+			{
+				obj->mFrameNotes[i*2+0] = LittleLong(roff_data[i].mStartNote);
+				obj->mFrameNotes[i*2+1] = LittleLong(roff_data[i].mNumNotes);
+			}
 		}
 
 		FixBadAngles(obj);
@@ -306,19 +310,21 @@ void CROFFSystem::FixBadAngles(CROFF *obj)
 
 	for(index=0;index<obj->mROFFEntries;index++)
 	{
+		float *rotate = &obj->mFrames[index * ROFF_FRAME_FLOATS + 3];
+
 		for ( t = 0; t < 3; t++ )
 		{
-			if ( obj->mMoveRotateList[index].mRotateOffset[t] > 180.0f )
+			if ( rotate[t] > 180.0f )
 			{ // found a bad angle
 			//	Com_Printf( S_COLOR_YELLOW"Fixing bad roff angle\n <%6.2f> changed to <%6.2f>.\n",
 			//				roff_data[i].mRotateOffset[t], roff_data[i].mRotateOffset[t] - 360.0f );
-				obj->mMoveRotateList[index].mRotateOffset[t] -= 360.0f;
+				rotate[t] -= 360.0f;
 			}
-			else if ( obj->mMoveRotateList[index].mRotateOffset[t] < -180.0f )
+			else if ( rotate[t] < -180.0f )
 			{ // found a bad angle
 			//	Com_Printf( S_COLOR_YELLOW"Fixing bad roff angle\n <%6.2f> changed to <%6.2f>.\n",
 			//				roff_data[i].mRotateOffset[t], roff_data[i].mRotateOffset[t] + 360.0f );
-				obj->mMoveRotateList[index].mRotateOffset[t] += 360.0f;
+				rotate[t] += 360.0f;
 			}
 		}
 	}
@@ -328,7 +334,8 @@ void CROFFSystem::FixBadAngles(CROFF *obj)
 //---------------------------------------------------------------------------
 // CROFFSystem::Cache
 //	Pre-caches roff data to avoid file hits during gameplay.  Disallows
-//		repeated caches of existing roffs.
+//		repeated caches of existing roffs, so the client and server share
+//		one converted copy of each file.
 //
 // INPUTS:
 //	pass in the filepath of the roff to cache
@@ -381,11 +388,14 @@ int CROFFSystem::Cache( const char *file, qboolean isClient )
 		cROFF = new CROFF( file, id );
 
 		mROFFList[id] = cROFF;
+		mROFFNames[file] = id;
 
 		if ( !InitROFF( data, cROFF ) )
 		{ // something failed, so get rid of the object
 			Unload( id );
-			id = 0;
+			FS_FreeFile( data );
+
+			return 0;
 		}
 
 		FS_FreeFile( data );
@@ -418,15 +428,11 @@ int CROFFSystem::Cache( const char *file, qboolean isClient )
 //---------------------------------------------------------------------------
 int	CROFFSystem::GetID( const char *file )
 {
-	TROFFList::iterator itr;
+	TROFFNameList::iterator itr = mROFFNames.find( file );
 
-	// Attempt to find the requested roff
-	for ( itr = mROFFList.begin(); itr != mROFFList.end(); ++itr )
-	{
-		if ( !strcmp( ((CROFF *)((*itr).second))->mROFFFilePath, file ) )
-		{ // return the ID to this roff
-			return (*itr).first;
-		}
+	if ( itr != mROFFNames.end() )
+	{ // return the ID to this roff
+		return (*itr).second;
 	}
 
 	// Not found
@@ -453,6 +459,7 @@ qboolean CROFFSystem::Unload( int id )
 
 	if ( itr != mROFFList.end() )
 	{ // requested item found in the list, free mem, then remove from list
+		mROFFNames.erase( itr->second->mROFFFilePath );
 		delete itr->second;
 
 		mROFFList.erase( itr++ );
@@ -475,19 +482,21 @@ qboolean CROFFSystem::Unload( int id )
 
 //---------------------------------------------------------------------------
 // CROFFSystem::Clean
-//	Cleans out all Roffs, freeing up any used resources
+//	Cleans out the roffing entities of one side, and frees any Roffs the
+//		other side isn't using
 //
 // INPUTS:
-//	none
+//	whether the client or the server is done with its roffs
 //
 // RETURN:
 //	success of operation
 //---------------------------------------------------------------------------
 qboolean CROFFSystem::Clean(qboolean isClient)
 {
-#if 0
 	TROFFList::iterator			itr, next;
-	TROFFEntList::iterator		entI, nextEnt;
+	TROFFEntList				&entList = mROFFEntList[isClient ? 1 : 0];
+	TROFFEntList::iterator		entI;
+
 	itr = mROFFList.begin();
 	while ( itr != mROFFList.end() )
 	{
@@ -510,36 +519,13 @@ qboolean CROFFSystem::Clean(qboolean isClient)
 		itr = next;
 	}
 
-	entI = mROFFEntList.begin();
-	while ( entI != mROFFEntList.end() )
+	for ( entI = entList.begin(); entI != entList.end(); ++entI )
 	{
-		nextEnt = entI;
-		++nextEnt;
-
-		if ((*entI)->mIsClient == isClient)
-		{
-			delete (*entI);
-			mROFFEntList.erase( entI );
-		}
-
-		entI = nextEnt;
+		delete (*entI);
 	}
-	mROFFEntList.clear();
-
-	return qtrue;
-#else
-	TROFFList::iterator itr;
-
-	itr = mROFFList.begin();
-
-	while ( itr != mROFFList.end() )
-	{
-		Unload( (*itr).first );
+	entList.clear();
 
-		itr = mROFFList.begin();
-	}
 	return qtrue;
-#endif
 }
 
 //---------------------------------------------------------------------------
@@ -587,7 +573,7 @@ qboolean CROFFSystem::List( int id )
 	if ( itr != mROFFList.end() )
 	{ // requested item found in the list
 		CROFF		*obj = ((CROFF *)((*itr).second));
-		TROFF2Entry	*dat = obj->mMoveRotateList;
+		const float	*dat = obj->mFrames;
 
 		Com_Printf( S_COLOR_GREEN"File: %s\n", obj->mROFFFilePath );
 		Com_Printf( S_COLOR_GREEN"ID: %i\n", id );
@@ -595,11 +581,10 @@ qboolean CROFFSystem::List( int id )
 
 		Com_Printf( S_COLOR_GREEN"MOVE                 ROTATE\n" );
 
-		for ( int i = 0; i < obj->mROFFEntries; i++ )
+		for ( int i = 0; i < obj->mROFFEntries; i++, dat += ROFF_FRAME_FLOATS )
 		{
 			Com_Printf( S_COLOR_GREEN"%6.2f %6.2f %6.2f   %6.2f %6.2f %6.2f\n",
-						dat[i].mOriginOffset[0], dat[i].mOriginOffset[1], dat[i].mOriginOffset[2],
-						dat[i].mRotateOffset[0], dat[i].mRotateOffset[1], dat[i].mRotateOffset[2] );
+						dat[0], dat[1], dat[2], dat[3], dat[4], dat[5] );
 		}
 
 		return qtrue;
@@ -657,7 +642,7 @@ qboolean CROFFSystem::Play( int entID, int id, qboolean doTranslation, qboolean
 	if ( !isClient )
 		VectorCopy(ent->s->apos.trBase, roffing_ent->mStartAngles);
 
-	mROFFEntList.push_back( roffing_ent );
+	mROFFEntList[isClient ? 1 : 0].push_back( roffing_ent );
 
 	return qtrue;
 }
@@ -722,18 +707,19 @@ void CROFFSystem::ListEnts()
 //---------------------------------------------------------------------------
 qboolean CROFFSystem::PurgeEnt( int entID, qboolean isClient )
 {
-	TROFFEntList::iterator itr = mROFFEntList.begin();
+	TROFFEntList &entList = mROFFEntList[isClient ? 1 : 0];
+	TROFFEntList::iterator itr;
 
-	for ( itr = mROFFEntList.begin(); itr != mROFFEntList.end(); ++itr )
+	for ( itr = entList.begin(); itr != entList.end(); ++itr )
 	{
-		if ( (*itr)->mIsClient == isClient && (*itr)->mEntID == entID)
+		if ( (*itr)->mEntID == entID )
 		{
 			// Make sure it won't stay lerping
 			ClearLerp( (*itr) );
 
 			delete (*itr);
 
-			mROFFEntList.erase( itr );
+			entList.erase( itr );
 			return qtrue;
 		}
 	}
@@ -784,66 +770,62 @@ qboolean CROFFSystem::PurgeEnt( char *name )
 //---------------------------------------------------------------------------
 void CROFFSystem::UpdateEntities(qboolean isClient)
 {
-	TROFFEntList::iterator itr = mROFFEntList.begin();
+	TROFFEntList	&entList = mROFFEntList[isClient ? 1 : 0];
 	TROFFList::iterator itrRoff;
+	CROFF			*roff = NULL;
+	int				roffID = 0;
+	size_t			i, count = entList.size(), kept = 0;
 
-	// display everything in the entity list
-	for ( itr = mROFFEntList.begin(); itr != mROFFEntList.end(); ++itr )
+	// roff everything that's due, and pack the survivors down as we go
+	for ( i = 0; i < count; i++ )
 	{
-		if ((*itr)->mIsClient != isClient)
-		{
-			continue;
-		}
-
-		// Get this entities ROFF object
-		itrRoff = mROFFList.find( ((SROFFEntity *)(*itr))->mROFFID );
+		SROFFEntity *roff_ent = entList[i];
 
-		if ( itrRoff != mROFFList.end() )
-		{ // roff that baby!
-			if ( !ApplyROFF( ((SROFFEntity *)(*itr)), ((CROFF *)((*itrRoff).second ))))
-			{ // done roffing, mark for death
-				((SROFFEntity *)(*itr))->mKill = qtrue;
+		if ( sv.time >= roff_ent->mNextROFFTime )
+		{
+			// Get this entities ROFF object, ents playing the same roff tend to be next to each other
+			if ( !roff || roff_ent->mROFFID != roffID )
+			{
+				itrRoff = mROFFList.find( roff_ent->mROFFID );
+				roff = ( itrRoff != mROFFList.end() ) ? (*itrRoff).second : NULL;
+				roffID = roff_ent->mROFFID;
 			}
-		}
-		else
-		{ // roff not found == bad, dump an error message and purge this ent
-			Com_Printf( S_COLOR_RED"ROFF System Error:\n" );
-//			Com_Printf( S_COLOR_RED" -ROFF not found for entity <%s>\n",
-//					entitySystem->GetEntityFromID(((SROFFEntity *)(*itr))->mEntID)->GetName() );
-
-			((SROFFEntity *)(*itr))->mKill = qtrue;
 
-			ClearLerp( (*itr) );
-		}
-	}
+			if ( roff )
+			{ // roff that baby!
+				if ( !ApplyROFF( roff_ent, roff ) )
+				{ // done roffing, mark for death
+					roff_ent->mKill = qtrue;
+				}
+			}
+			else
+			{ // roff not found == bad, dump an error message and purge this ent
+				Com_Printf( S_COLOR_RED"ROFF System Error:\n" );
 
-	itr = mROFFEntList.begin();
+				roff_ent->mKill = qtrue;
 
-	// Delete killed ROFFers from the list
-	// Man, there just has to be a better way to do this
-	while ( itr != mROFFEntList.end() )
-	{
-		if ((*itr)->mIsClient != isClient)
-		{
-			itr++;
-			continue;
+				ClearLerp( roff_ent );
+			}
 		}
 
-		if ( ((SROFFEntity *)(*itr))->mKill == qtrue )
+		if ( roff_ent->mKill == qtrue )
 		{
 			//make sure ICARUS knows ROFF is stopped
-//			CICARUSGameInterface::TaskIDComplete(
-//				entitySystem->GetEntityFromID(((SROFFEntity *)(*itr))->mEntID), TID_MOVE);
 			// trash this guy from the list
-			delete (*itr);
-			mROFFEntList.erase( itr );
-			itr = mROFFEntList.begin();
+			delete roff_ent;
 		}
 		else
 		{
-			itr++;
+			entList[kept++] = roff_ent;
 		}
 	}
+
+	// keep anything a note track started while we were going
+	for ( i = count; i < entList.size(); i++ )
+	{
+		entList[kept++] = entList[i];
+	}
+	entList.resize( kept );
 }
 
 //---------------------------------------------------------------------------
@@ -862,6 +844,7 @@ qboolean CROFFSystem::ApplyROFF( SROFFEntity *roff_ent, CROFFSystem::CROFF *roff
 	sharedEntityMapper_t	*ent = NULL;
 	trajectory_t	*originTrajectory = NULL, *angleTrajectory = NULL;
 	float			*origin = NULL, *angle = NULL;
+	float			*frame;
 
 
 	if ( sv.time < roff_ent->mNextROFFTime )
@@ -909,32 +892,35 @@ qboolean CROFFSystem::ApplyROFF( SROFFEntity *roff_ent, CROFFSystem::CROFF *roff
 		return qfalse;
 	}
 
+	frame = &roff->mFrames[roff_ent->mROFFFrame * ROFF_FRAME_FLOATS];
+
 	if (roff_ent->mTranslated)
 	{
 		AngleVectors(roff_ent->mStartAngles, f, r, u );
-		VectorScale(f, roff->mMoveRotateList[roff_ent->mROFFFrame].mOriginOffset[0], result);
-		VectorMA(result, -roff->mMoveRotateList[roff_ent->mROFFFrame].mOriginOffset[1], r, result);
-		VectorMA(result, roff->mMoveRotateList[roff_ent->mROFFFrame].mOriginOffset[2], u, result);
+		VectorScale(f, frame[0], result);
+		VectorMA(result, -frame[1], r, result);
+		VectorMA(result, frame[2], u, result);
 	}
 	else
 	{
-		VectorCopy(roff->mMoveRotateList[roff_ent->mROFFFrame].mOriginOffset, result);
+		VectorCopy(frame, result);
 	}
 
 	// Set up our origin interpolation
 	SetLerp( originTrajectory, TR_LINEAR, origin, result, sv.time, roff->mLerp );
 
 	// Set up our angle interpolation
-	SetLerp( angleTrajectory, TR_LINEAR, angle,
-				roff->mMoveRotateList[roff_ent->mROFFFrame].mRotateOffset, sv.time, roff->mLerp );
+	SetLerp( angleTrajectory, TR_LINEAR, angle, &frame[3], sv.time, roff->mLerp );
 
-	if (roff->mMoveRotateList[roff_ent->mROFFFrame].mStartNote >= 0)
+	if (roff->mFrameNotes && roff->mFrameNotes[roff_ent->mROFFFrame*2] >= 0)
 	{
-		int		i;
+		const int	startNote = roff->mFrameNotes[roff_ent->mROFFFrame*2+0];
+		const int	numNotes = roff->mFrameNotes[roff_ent->mROFFFrame*2+1];
+		int			i;
 
-		for(i=0;i<roff->mMoveRotateList[roff_ent->mROFFFrame].mNumNotes;i++)
+		for(i=0;i<numNotes;i++)
 		{
-			ProcessNote(roff_ent, roff->mNoteTrackIndexes[roff->mMoveRotateList[roff_ent->mROFFFrame].mStartNote + i]);
+			ProcessNote(roff_ent, roff->mNoteTrackIndexes[startNote + i]);
 		}
 	}
 
@@ -27,6 +27,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include <vector>
 #include <map>
+#include <string>
 
 // ROFF Defines
 //-------------------
@@ -34,6 +35,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #define ROFF_NEW_VERSION			2
 #define ROFF_STRING					"ROFF"
 #define ROFF_SAMPLE_RATE			10	// 10hz
+#define ROFF_FRAME_FLOATS			6	// origin offset, then rotate offset
 #define ROFF_AUTO_FIX_BAD_ANGLES	// exporter can mess up angles,
 									//	defining this attempts to detect and fix these problems
 
@@ -52,12 +54,14 @@ private:
 	struct			SROFFEntity;
 
 	typedef	std::map	<int, CROFF *> TROFFList;
+	typedef	std::map	<std::string, int> TROFFNameList;
 	typedef std::vector	<SROFFEntity *> TROFFEntList;
 
 	TROFFList		mROFFList;				// List of cached roffs
+	TROFFNameList	mROFFNames;				// ids of cached roffs by file path
 	int				mID;					// unique ID generator for new roff objects
 
-	TROFFEntList	mROFFEntList;			// List of roffing entities
+	TROFFEntList	mROFFEntList[2];		// List of roffing entities, server then client
 
 	// ROFF Header file definition, nothing else needs to see this
 	typedef struct tROFFHeader
@@ -111,7 +115,8 @@ private:
 		int			mROFFEntries;				// count of move/rotate commands
 		int			mFrameTime;					// frame rate
 		int			mLerp;						// Lerp rate (FPS)
-		TROFF2Entry	*mMoveRotateList;			// move rotate/command list
+		float		*mFrames;					// ROFF_FRAME_FLOATS per move/rotate command
+		int			*mFrameNotes;				// start note and note count per command, NULL without notes
 		int			mNumNoteTracks;
 		char		**mNoteTrackIndexes;
 		qboolean	mUsedByClient;
@@ -167,7 +172,7 @@ private:
 public:
 //------
 
-	CROFFSystem()	{	mID = 0; mROFFEntList.clear();	}
+	CROFFSystem()	{	mID = 0;	}
 	~CROFFSystem()	{	Restart();	}
 
 
@@ -176,7 +181,7 @@ public:
 	int			Cache( const char *file, qboolean isClient );			// roffs should be precached at the start of each level
 	int			GetID( const char *file );			// find the roff id by filename
 	qboolean		Unload( int id );				// when a roff is done, it can be removed to free up resources
-	qboolean	Clean(qboolean isClient);					// should be called when level is done, frees all roff resources
+	qboolean	Clean(qboolean isClient);					// should be called when level is done, frees what only that side used
 	void		List(void);						// dumps a list of all cached roff files to the console
 	qboolean		List( int id );					// dumps the contents of the specified roff to the console
 
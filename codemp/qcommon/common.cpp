@@ -28,6 +28,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "qcommon/cm_public.h"
 #include "qcommon/game_version.h"
 #include "qcommon/q_version.h"
+#include "qcommon/logwriter.h"
 #include "../server/NPCNav/navigator.h"
 #include "../shared/sys/sys_local.h"
 #if defined(_WIN32)
@@ -35,8 +36,10 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include <windows.h>
 #endif
 #include <setjmp.h>
+#include <thread>
 
 static jmp_buf abortframe;
+static std::thread::id com_mainThread;
 
 FILE *debuglogfile;
 fileHandle_t logfile;
@@ -54,6 +57,7 @@ cvar_t	*com_timedemo;
 cvar_t	*com_sv_running;
 cvar_t	*com_cl_running;
 cvar_t	*com_logfile;		// 1 = buffer log, 2 = flush after each print
+cvar_t	*com_logfileMaxSize;	// KB before qconsole.log is rotated, 0 = never
 cvar_t	*com_showtrace;
 
 cvar_t	*com_optvehtrace;
@@ -136,6 +140,9 @@ void QDECL Com_Printf( const char *fmt, ... ) {
 	char		msg[MAXPRINTMSG];
 	static qboolean opening_qconsole = qfalse;
 	const char *p;
+	// the r_smp render thread prints too, but only the main thread may open
+	// or rotate qconsole.log; nothing else runs before Com_Init
+	const bool mainThread = com_mainThread == std::thread::id() || com_mainThread == std::this_thread::get_id();
 
 	va_start (argptr,fmt);
 	Q_vsnprintf (msg, sizeof(msg), fmt, argptr);
@@ -187,7 +194,11 @@ void QDECL Com_Printf( const char *fmt, ... ) {
 		Sys_Print( line );
 
 		// logfile
-		if ( com_logfile && com_logfile->integer ) {
+		if ( com_logfile && com_logfile->integer && !mainThread ) {
+			// the writer ignores this unless the main thread has the log open
+			LogWriter_Append(line, strlen(line));
+		}
+		else if ( com_logfile && com_logfile->integer ) {
 		// TTimo: only open the qconsole.log if the filesystem is in an initialized state
 		//   also, avoid recursing in the qconsole.log opening (i.e. if fs_debug is on)
 			if ( !logfile && FS_Initialized() && !opening_qconsole ) {
@@ -202,12 +213,10 @@ void QDECL Com_Printf( const char *fmt, ... ) {
 				logfile = FS_FOpenFileWrite( "qconsole.log" );
 
 				if ( logfile ) {
+					// with logfile 2, write and flush every line as it's printed
+					// so we get valid data even if we are crashing
+					LogWriter_Start( FS_FileForHandle( logfile ), com_logfile->integer > 1 );
 					Com_Printf( "logfile opened on %s\n", asctime( newtime ) );
-					if ( com_logfile->integer > 1 ) {
-						// force it to not buffer so we get valid
-						// data even if we are crashing
-						FS_ForceFlush(logfile);
-					}
 				}
 				else {
 					Com_Printf( "Opening qconsole.log failed!\n" );
@@ -216,11 +225,22 @@ void QDECL Com_Printf( const char *fmt, ... ) {
 			}
 			opening_qconsole = qfalse;
 			if ( logfile && FS_Initialized()) {
-				FS_Write(line, strlen(line), logfile);
+				LogWriter_Append(line, strlen(line));
 			}
 		}
 	}
 
+	// start a new qconsole.log once this one is big enough
+	if ( mainThread && logfile && com_logfileMaxSize && com_logfileMaxSize->integer > 0 && !opening_qconsole &&
+		LogWriter_Size() >= (size_t)com_logfileMaxSize->integer * 1024 ) {
+		opening_qconsole = qtrue;
+		LogWriter_Stop();
+		FS_FCloseFile( logfile );
+		logfile = 0;
+		FS_Rename( "qconsole.log", "qconsole.old.log" );
+		opening_qconsole = qfalse;
+	}
+
 
 #if defined(_WIN32) && defined(_DEBUG)
 	if ( *msg )
@@ -289,6 +309,9 @@ void NORETURN QDECL Com_Error( int code, const char *fmt, ... ) {
 	}
 	com_errorEntered = qtrue;
 
+	// get everything that led up to this on disk
+	LogWriter_Flush();
+
 	// when we are running automated scripts, make sure we
 	// know if anything failed
 	if ( com_buildScript && com_buildScript->integer ) {
@@ -1162,6 +1185,8 @@ void Com_Init( char *commandLine ) {
 	int		qport;
 	int		errCode;
 
+	com_mainThread = std::this_thread::get_id();
+
 	Com_Printf( "%s %s %s\n", JK_VERSION, PLATFORM_STRING, SOURCE_DATE );
 
 	if ( (errCode = setjmp(abortframe)) )
@@ -1258,6 +1283,7 @@ void Com_Init( char *commandLine ) {
 		// init commands and vars
 		//
 		com_logfile = Cvar_Get ("logfile", "0", CVAR_TEMP );
+		com_logfileMaxSize = Cvar_Get ("logfile_maxsize", "0", CVAR_ARCHIVE_ND, "Rotate qconsole.log to qconsole.old.log past this many KB, 0 to never rotate" );
 
 		com_timescale = Cvar_Get ("timescale", "1", CVAR_CHEAT | CVAR_SYSTEMINFO );
 		com_fixedtime = Cvar_Get ("fixedtime", "0", CVAR_CHEAT);
@@ -1711,6 +1737,7 @@ void Com_Shutdown (void)
 	CM_ClearMap();
 
 	if (logfile) {
+		LogWriter_Stop ();
 		FS_FCloseFile (logfile);
 		logfile = 0;
 		com_logfile->integer = 0;//don't open up the log file again!!
@@ -468,7 +468,7 @@ static fileHandle_t FS_HandleForFile(void) {
 	return 0;
 }
 
-static FILE	*FS_FileForHandle( fileHandle_t f ) {
+FILE	*FS_FileForHandle( fileHandle_t f ) {
 	if ( f < 1 || f >= MAX_FILE_HANDLES ) {
 		Com_Error( ERR_DROP, "FS_FileForHandle: out of range" );
 	}
@@ -2007,6 +2007,84 @@ int	FS_FileIsInPAK(const char *filename, int *pChecksum ) {
 	return -1;
 }
 
+/*
+===========
+FS_FileStamp
+
+Finds the copy of filename FS_FOpenFileRead would open and returns its
+length, or -1 if there is none. *stamp identifies that copy: the pak's
+checksum and the file's position in it, or a loose file's modification
+time. It changes whenever the file is replaced, so it can key caches of
+data derived from the file without reading it.
+===========
+*/
+long FS_FileStamp( const char *filename, int *stamp ) {
+	searchpath_t	*search;
+	fileInPack_t	*pakFile;
+	char			*netpath;
+	FILE			*f;
+	long			hash, len;
+	int				l;
+
+	FS_AssertInitialised();
+
+	if ( !filename ) {
+		Com_Error( ERR_FATAL, "FS_FileStamp: NULL 'filename' parameter passed\n" );
+	}
+
+	// qpaths are not supposed to have a leading slash
+	if ( filename[0] == '/' || filename[0] == '\\' ) {
+		filename++;
+	}
+
+	if ( strstr( filename, ".." ) || strstr( filename, "::" ) ) {
+		return -1;
+	}
+
+	l = strlen( filename );
+
+	for ( search = fs_searchpaths ; search ; search = search->next ) {
+		if ( search->pack ) {
+			hash = FS_HashFileName( filename, search->pack->hashSize );
+			if ( !search->pack->hashTable[hash] || !FS_PakIsPure( search->pack ) ) {
+				continue;
+			}
+
+			for ( pakFile = search->pack->hashTable[hash]; pakFile; pakFile = pakFile->next ) {
+				if ( !FS_FilenameCompare( pakFile->name, filename ) ) {
+					*stamp = search->pack->checksum ^ (int)pakFile->pos;
+					return pakFile->len;
+				}
+			}
+		} else if ( search->dir ) {
+			// the same files FS_FOpenFileRead allows from directories
+			if ( fs_numServerPaks ) {
+				if ( !FS_IsExt( filename, ".cfg", l ) &&
+					!FS_IsExt( filename, ".fcf", l ) &&
+					!FS_IsExt( filename, ".menu", l ) &&
+					!FS_IsExt( filename, ".game", l ) &&
+					!FS_IsExt( filename, ".dat", l ) &&
+					!FS_IsDemoExt( filename, l ) ) {
+					continue;
+				}
+			}
+
+			netpath = FS_BuildOSPath( search->dir->path, search->dir->gamedir, filename );
+			f = fopen( netpath, "rb" );
+			if ( !f ) {
+				continue;
+			}
+			len = FS_fplength( f );
+			fclose( f );
+
+			*stamp = (int)Sys_FileTime( netpath );
+			return len;
+		}
+	}
+
+	return -1;
+}
+
 /*
 ============
 FS_ReadFile
@@ -0,0 +1,315 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+#include "logwriter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+	struct logWriterState_t
+	{
+		std::thread					thread;
+		std::mutex					appendMutex;	// one appender at a time
+		std::atomic<std::thread::id> appendOwner;	// who holds appendMutex
+		std::mutex					mutex;			// only the thread sleeps on it
+		std::condition_variable		appended;		// wakes the thread
+
+		char						ring[LOGWRITER_RING_SIZE];
+		std::atomic<size_t>			head{ 0 };		// bytes ever appended
+		std::atomic<size_t>			tail{ 0 };		// bytes ever written
+		size_t						start = 0;		// head at LogWriter_Start
+
+		FILE						*file = nullptr;
+		bool						flushEachWrite = false;
+		std::atomic<bool>			shutdown{ false };
+		bool						exitHooked = false;
+	};
+
+	logWriterState_t ls;
+
+	// a signal can land on the writer thread too
+	thread_local bool onWriterThread = false;
+
+	// Holds appendMutex, unless this thread does already. Sys_SigHandler
+	// prints and exits from wherever the thread it interrupted was, which
+	// can be inside LogWriter_Append, or on the writer thread; waiting for
+	// the mutex or the ring then would wait forever.
+	class appendLock_t
+	{
+	public:
+		appendLock_t()
+		{
+			if ( onWriterThread || ls.appendOwner.load() == std::this_thread::get_id() )
+			{
+				return;
+			}
+
+			ls.appendMutex.lock();
+			ls.appendOwner = std::this_thread::get_id();
+			locked = true;
+		}
+
+		~appendLock_t()
+		{
+			if ( locked )
+			{
+				ls.appendOwner = std::thread::id();
+				ls.appendMutex.unlock();
+			}
+		}
+
+		// the thread was interrupted inside the writer, whose state may be
+		// half updated
+		bool Reentered( void ) const
+		{
+			return !locked;
+		}
+
+	private:
+		bool locked = false;
+	};
+
+	// exit() would destroy the state with the thread still joinable, which
+	// terminates, and the ring would never reach the file
+	void LogWriterAtExit( void )
+	{
+		LogWriter_Stop();
+	}
+
+	// Writes out whatever is in the ring. Only the thread calls this while
+	// it runs.
+	bool WriteRing( void )
+	{
+		const size_t head = ls.head.load( std::memory_order_acquire );
+		size_t tail = ls.tail.load( std::memory_order_relaxed );
+
+		if ( head == tail )
+		{
+			return false;
+		}
+
+		while ( tail != head )
+		{
+			const size_t offset = tail % LOGWRITER_RING_SIZE;
+			const size_t size = std::min( head - tail, LOGWRITER_RING_SIZE - offset );
+
+			fwrite( &ls.ring[offset], 1, size, ls.file );
+			tail += size;
+		}
+
+		ls.tail.store( tail, std::memory_order_release );
+		return true;
+	}
+
+	void LogWriterThreadMain( void )
+	{
+		onWriterThread = true;
+
+		for ( ;; )
+		{
+			if ( WriteRing() )
+			{
+				continue;
+			}
+
+			if ( ls.shutdown.load() )
+			{
+				break;
+			}
+
+			// appending doesn't take the lock, so a wakeup can be missed;
+			// the timeout bounds how late that makes the file
+			std::unique_lock<std::mutex> lock( ls.mutex );
+			ls.appended.wait_for( lock, std::chrono::milliseconds( 100 ), [] {
+				return ls.head.load() != ls.tail.load() || ls.shutdown.load();
+			} );
+		}
+	}
+
+	// Waits for the thread to write out everything before target. This
+	// doesn't take the thread's mutex, so that the thread can always finish
+	// when the exit path joins it, whatever the waiter was interrupted in.
+	void WaitForTail( size_t target )
+	{
+		while ( (ptrdiff_t)( target - ls.tail.load( std::memory_order_acquire ) ) > 0 )
+		{
+			ls.appended.notify_one();
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+	}
+}
+
+void LogWriter_Start( FILE *file, bool flushEachWrite )
+{
+	LogWriter_Stop();
+
+	appendLock_t lock;
+
+	if ( !ls.exitHooked )
+	{
+		ls.exitHooked = atexit( LogWriterAtExit ) == 0;
+	}
+
+	ls.file = file;
+	ls.flushEachWrite = flushEachWrite;
+	ls.start = ls.head.load();
+	ls.shutdown = false;
+
+	if ( flushEachWrite )
+	{
+		// every append is written out by the appender
+		return;
+	}
+
+	try
+	{
+		ls.thread = std::thread( LogWriterThreadMain );
+	}
+	catch ( const std::system_error& )
+	{
+		// write on the caller's thread instead
+	}
+}
+
+void LogWriter_Stop( void )
+{
+	// re-entered from the exit path, the thread can still be joined, as
+	// it never needs the lock
+	appendLock_t lock;
+
+	if ( !ls.file )
+	{
+		return;
+	}
+
+	if ( onWriterThread )
+	{
+		// exiting on the writer thread, which can't join itself
+		WriteRing();
+		ls.thread.detach();
+	}
+	else if ( ls.thread.joinable() )
+	{
+		ls.shutdown = true;
+		ls.appended.notify_one();
+		ls.thread.join();
+	}
+
+	fflush( ls.file );
+	ls.file = nullptr;
+}
+
+bool LogWriter_Active( void )
+{
+	appendLock_t lock;
+
+	return ls.file != nullptr;
+}
+
+void LogWriter_Append( const char *text, size_t size )
+{
+	appendLock_t lock;
+
+	if ( !ls.file )
+	{
+		return;
+	}
+
+	if ( lock.Reentered() )
+	{
+		// straight to the file, the ring may be half way through an append;
+		// this can come out ahead of what the thread has yet to write
+		fwrite( text, 1, size, ls.file );
+		fflush( ls.file );
+		return;
+	}
+
+	if ( !ls.thread.joinable() )
+	{
+		fwrite( text, 1, size, ls.file );
+		if ( ls.flushEachWrite )
+		{
+			fflush( ls.file );
+		}
+		ls.head.store( ls.head.load() + size );
+		ls.tail.store( ls.head.load() );
+		return;
+	}
+
+	size_t head = ls.head.load( std::memory_order_relaxed );
+
+	while ( size )
+	{
+		size_t room = LOGWRITER_RING_SIZE - ( head - ls.tail.load( std::memory_order_acquire ) );
+
+		if ( !room )
+		{
+			// full, wait for the thread to write some of it
+			WaitForTail( head - LOGWRITER_RING_SIZE + 1 );
+			continue;
+		}
+
+		const size_t offset = head % LOGWRITER_RING_SIZE;
+		const size_t chunk = std::min( std::min( size, room ), LOGWRITER_RING_SIZE - offset );
+
+		memcpy( &ls.ring[offset], text, chunk );
+		text += chunk;
+		size -= chunk;
+		head += chunk;
+		ls.head.store( head, std::memory_order_release );
+	}
+
+	ls.appended.notify_one();
+}
+
+void LogWriter_Flush( void )
+{
+	appendLock_t lock;
+
+	if ( !ls.file )
+	{
+		return;
+	}
+
+	if ( ls.thread.joinable() && !lock.Reentered() )
+	{
+		WaitForTail( ls.head.load( std::memory_order_relaxed ) );
+	}
+
+	// stdio locks the file, so this is safe with the thread idle or not
+	fflush( ls.file );
+}
+
+size_t LogWriter_Size( void )
+{
+	appendLock_t lock;
+
+	return ls.head.load( std::memory_order_relaxed ) - ls.start;
+}
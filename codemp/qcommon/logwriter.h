@@ -0,0 +1,62 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+// Filename:-	logwriter.h
+//
+// A thread that writes the console log out, so that a busy server's logging
+// doesn't put disk I/O on the frame.
+//
+// Whoever prints appends text to a ring buffer and the thread drains it into
+// the file. Appending is serialized by a mutex, as the render thread prints
+// too. When the ring is full, appending waits for the thread to make room,
+// so nothing is lost. Whatever is left in the ring is written out when the
+// process exits.
+//
+// It takes a FILE * rather than a fileHandle_t, since the filesystem isn't
+// thread safe; Com_Printf opens qconsole.log through it and hands the writer
+// the FILE behind the handle.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define LOGWRITER_RING_SIZE		(256 * 1024)
+
+// Starts writing to file, which stays open until LogWriter_Stop. With
+// flushEachWrite, text is written and flushed before LogWriter_Append
+// returns, so a crash can't lose it. Without it, text is written on the
+// caller's thread only if the writer thread can't be started.
+void LogWriter_Start( FILE *file, bool flushEachWrite );
+
+// Stops writing, after everything appended so far is in the file. The
+// caller closes the file.
+void LogWriter_Stop( void );
+
+bool LogWriter_Active( void );
+
+// Queues size bytes of text for the file.
+void LogWriter_Append( const char *text, size_t size );
+
+// Waits for everything appended so far to be written, and flushes the file.
+void LogWriter_Flush( void );
+
+// Bytes appended since LogWriter_Start.
+size_t LogWriter_Size( void );
@@ -1057,6 +1057,326 @@ void Info_SetValueForKey_Big( char *s, const char *key, const char *value ) {
 	strcat (s, newi);
 }
 
+/*
+==================
+InfoDict_Hash
+==================
+*/
+static int InfoDict_Hash( const char *key ) {
+	unsigned int hash = 0;
+
+	for ( ; *key; key++ ) {
+		char c = *key;
+		if ( c >= 'A' && c <= 'Z' )
+			c += 'a' - 'A';
+		hash = hash * 31 + (unsigned char)c;
+	}
+
+	return (int)(hash & (INFO_DICT_HASH_SIZE - 1));
+}
+
+/*
+==================
+InfoDict_Find
+
+Returns the index of the pair that Info_ValueForKey would find, or -1
+==================
+*/
+static int InfoDict_Find( const infoDict_t *dict, const char *key ) {
+	int i;
+
+	for ( i = dict->hash[InfoDict_Hash( key )]; i != -1; i = dict->pairs[i].next ) {
+		if ( !Q_stricmp( &dict->text[dict->pairs[i].key], key ) )
+			return i;
+	}
+
+	return -1;
+}
+
+/*
+==================
+InfoDict_Link
+
+Makes the pair findable, unless an earlier pair already has its key
+==================
+*/
+static void InfoDict_Link( infoDict_t *dict, int index ) {
+	const char *key = &dict->text[dict->pairs[index].key];
+	int hash = InfoDict_Hash( key );
+	int i;
+
+	for ( i = dict->hash[hash]; i != -1; i = dict->pairs[i].next ) {
+		if ( !Q_stricmp( &dict->text[dict->pairs[i].key], key ) )
+			return;
+	}
+
+	dict->pairs[index].next = dict->hash[hash];
+	dict->hash[hash] = index;
+}
+
+/*
+==================
+InfoDict_Clear
+==================
+*/
+static void InfoDict_Clear( infoDict_t *dict ) {
+	int i;
+
+	dict->textUsed = 0;
+	dict->numPairs = 0;
+	for ( i = 0; i < INFO_DICT_HASH_SIZE; i++ )
+		dict->hash[i] = -1;
+	dict->length = 0;
+	dict->string[0] = '\0';
+	dict->dirty = qfalse;
+}
+
+/*
+==================
+InfoDict_AddPair
+
+The caller makes sure there's room, see InfoDict_Reserve
+==================
+*/
+static void InfoDict_AddPair( infoDict_t *dict, const char *key, const char *value ) {
+	infoPair_t *pair = &dict->pairs[dict->numPairs];
+	int keyLen = (int)strlen( key ) + 1, valueLen = (int)strlen( value ) + 1;
+
+	pair->key = (short)dict->textUsed;
+	memcpy( &dict->text[dict->textUsed], key, keyLen );
+	dict->textUsed += keyLen;
+
+	pair->value = (short)dict->textUsed;
+	memcpy( &dict->text[dict->textUsed], value, valueLen );
+	dict->textUsed += valueLen;
+
+	pair->next = -1;
+	InfoDict_Link( dict, dict->numPairs++ );
+
+	dict->length += keyLen + valueLen;	// the two nuls stand in for the two backslashes
+	dict->dirty = qtrue;
+}
+
+/*
+==================
+InfoDict_Reserve
+
+Makes room for textSize more bytes of text and another pair, packing out
+removed pairs and replaced values if it has to. Pair indexes don't survive.
+==================
+*/
+static qboolean InfoDict_Reserve( infoDict_t *dict, size_t textSize ) {
+	char		text[sizeof( dict->text )];
+	infoPair_t	pairs[INFO_DICT_MAX_PAIRS];
+	int			numPairs = dict->numPairs, i;
+
+	if ( dict->textUsed + textSize <= sizeof( dict->text ) && dict->numPairs < INFO_DICT_MAX_PAIRS )
+		return qtrue;
+
+	memcpy( text, dict->text, dict->textUsed );
+	memcpy( pairs, dict->pairs, numPairs * sizeof( pairs[0] ) );
+
+	InfoDict_Clear( dict );
+	for ( i = 0; i < numPairs; i++ ) {
+		if ( pairs[i].key != -1 )
+			InfoDict_AddPair( dict, &text[pairs[i].key], &text[pairs[i].value] );
+	}
+
+	return (qboolean)( dict->textUsed + textSize <= sizeof( dict->text ) && dict->numPairs < INFO_DICT_MAX_PAIRS );
+}
+
+/*
+==================
+InfoDict_Parse
+
+Fills the dictionary with the pairs of an info string
+==================
+*/
+void InfoDict_Parse( infoDict_t *dict, const char *s ) {
+	char key[MAX_INFO_KEY], value[MAX_INFO_VALUE];
+	const char *head = s;
+
+	if ( strlen( s ) >= MAX_INFO_STRING ) {
+		Com_Error( ERR_DROP, "InfoDict_Parse: oversize infostring" );
+	}
+
+	InfoDict_Clear( dict );
+
+	while ( 1 ) {
+		if ( !Info_NextPair( &head, key, value ) ) {
+			// keep what came before the bad pair, as Info_ValueForKey would
+			return;
+		}
+		if ( !key[0] )
+			break;
+		if ( dict->numPairs == INFO_DICT_MAX_PAIRS )
+			return;
+		InfoDict_AddPair( dict, key, value );
+	}
+
+	// until something changes, the string is what was parsed
+	Q_strncpyz( dict->string, s, sizeof( dict->string ) );
+	dict->dirty = qfalse;
+}
+
+/*
+==================
+InfoDict_ValueForKey
+
+Returns the value for key, or an empty string. The value stays valid until
+the dictionary is changed.
+==================
+*/
+const char *InfoDict_ValueForKey( const infoDict_t *dict, const char *key ) {
+	int i;
+
+	if ( !key ) {
+		return "";
+	}
+
+	i = InfoDict_Find( dict, key );
+	if ( i == -1 ) {
+		return "";
+	}
+
+	return &dict->text[dict->pairs[i].value];
+}
+
+/*
+==================
+InfoDict_RemoveKey
+==================
+*/
+void InfoDict_RemoveKey( infoDict_t *dict, const char *key ) {
+	int index = InfoDict_Find( dict, key ), i;
+	short *link;
+
+	if ( index == -1 ) {
+		return;
+	}
+
+	for ( link = &dict->hash[InfoDict_Hash( key )]; *link != index; link = &dict->pairs[*link].next )
+		;
+	*link = dict->pairs[index].next;
+
+	dict->length -= (int)( strlen( &dict->text[dict->pairs[index].key] ) + strlen( &dict->text[dict->pairs[index].value] ) ) + 2;
+	dict->pairs[index].key = -1;
+	dict->dirty = qtrue;
+
+	// a later pair with the same key shows through, as with Info_RemoveKey
+	for ( i = index + 1; i < dict->numPairs; i++ ) {
+		if ( dict->pairs[i].key != -1 && !Q_stricmp( &dict->text[dict->pairs[i].key], key ) ) {
+			InfoDict_Link( dict, i );
+			break;
+		}
+	}
+}
+
+/*
+==================
+InfoDict_SetValueForKey
+
+Changes or adds a key/value pair, or removes it for an empty value, with the
+limits of Info_SetValueForKey
+==================
+*/
+void InfoDict_SetValueForKey( infoDict_t *dict, const char *key, const char *value ) {
+	const char* blacklist = "\\;\"";
+	int valueLen, i, length;
+
+	for(; *blacklist; ++blacklist)
+	{
+		if (strchr (key, *blacklist) || strchr (value, *blacklist))
+		{
+			Com_Printf (S_COLOR_YELLOW "Can't use keys or values with a '%c': %s = %s\n", *blacklist, key, value);
+			return;
+		}
+	}
+
+	if ( !value || !value[0] ) {
+		InfoDict_RemoveKey( dict, key );
+		return;
+	}
+
+	valueLen = (int)strlen( value );
+	i = InfoDict_Find( dict, key );
+	if ( i != -1 ) {
+		char *oldValue = &dict->text[dict->pairs[i].value];
+		int oldLen = (int)strlen( oldValue );
+
+		if ( !strcmp( oldValue, value ) )
+			return;
+
+		length = dict->length - oldLen + valueLen;
+		if ( length >= MAX_INFO_STRING ) {
+			// Info_SetValueForKey loses the old value too
+			InfoDict_RemoveKey( dict, key );
+			Com_Printf ("Info string length exceeded: %s\n", InfoDict_String( dict ));
+			return;
+		}
+
+		if ( valueLen > oldLen ) {
+			if ( !InfoDict_Reserve( dict, valueLen + 1 ) )
+				return;
+			i = InfoDict_Find( dict, key );
+			dict->pairs[i].value = (short)dict->textUsed;
+			dict->textUsed += valueLen + 1;
+		}
+		memcpy( &dict->text[dict->pairs[i].value], value, valueLen + 1 );
+
+		dict->length = length;
+		dict->dirty = qtrue;
+		return;
+	}
+
+	if ( dict->length + (int)strlen( key ) + valueLen + 2 >= MAX_INFO_STRING ) {
+		Com_Printf ("Info string length exceeded: %s\n", InfoDict_String( dict ));
+		return;
+	}
+
+	if ( InfoDict_Reserve( dict, strlen( key ) + valueLen + 2 ) )
+		InfoDict_AddPair( dict, key, value );
+}
+
+/*
+==================
+InfoDict_String
+
+Returns the info string the dictionary holds, rebuilding it only if the
+dictionary changed since it was last asked for
+==================
+*/
+const char *InfoDict_String( infoDict_t *dict ) {
+	char *o = dict->string;
+	int i;
+
+	if ( !dict->dirty ) {
+		return dict->string;
+	}
+
+	for ( i = 0; i < dict->numPairs; i++ ) {
+		const infoPair_t *pair = &dict->pairs[i];
+		size_t keyLen, valueLen;
+
+		if ( pair->key == -1 )
+			continue;
+
+		keyLen = strlen( &dict->text[pair->key] );
+		valueLen = strlen( &dict->text[pair->value] );
+
+		*o++ = '\\';
+		memcpy( o, &dict->text[pair->key], keyLen );
+		o += keyLen;
+		*o++ = '\\';
+		memcpy( o, &dict->text[pair->value], valueLen );
+		o += valueLen;
+	}
+	*o = '\0';
+
+	dict->dirty = qfalse;
+	return dict->string;
+}
+
 /*
 ==================
 Com_CharIsOneOfCharset
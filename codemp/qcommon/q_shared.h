@@ -682,6 +682,34 @@ void Info_SetValueForKey_Big( char *s, const char *key, const char *value );
 qboolean Info_Validate( const char *s );
 qboolean Info_NextPair( const char **s, char *key, char *value );
 
+// an info string parsed once into an indexed table, for code that looks up
+// or changes many keys of the same string. keys are matched without regard
+// to case, as Info_ValueForKey does.
+#define INFO_DICT_HASH_SIZE		64
+#define INFO_DICT_MAX_PAIRS		(MAX_INFO_STRING / 3)	// "\k\" is the shortest pair
+
+typedef struct infoPair_s {
+	short		key, value;					// offsets into text, key is -1 once removed
+	short		next;						// next pair in the same hash chain, or -1
+} infoPair_t;
+
+typedef struct infoDict_s {
+	char		text[MAX_INFO_STRING * 2];	// keys and values, nul terminated
+	int			textUsed;
+	infoPair_t	pairs[INFO_DICT_MAX_PAIRS];
+	int			numPairs;					// including removed ones
+	short		hash[INFO_DICT_HASH_SIZE];	// first pair of each hash chain, or -1
+	int			length;						// of the info string the pairs make
+	char		string[MAX_INFO_STRING];	// that info string, rebuilt when dirty
+	qboolean	dirty;
+} infoDict_t;
+
+void InfoDict_Parse( infoDict_t *dict, const char *s );
+const char *InfoDict_ValueForKey( const infoDict_t *dict, const char *key );
+void InfoDict_SetValueForKey( infoDict_t *dict, const char *key, const char *value );
+void InfoDict_RemoveKey( infoDict_t *dict, const char *key );
+const char *InfoDict_String( infoDict_t *dict );
+
 // this is only here so the functions in q_shared.c and bg_*.c can link
 #if defined( _GAME ) || defined( _CGAME ) || defined( UI_BUILD )
 	extern NORETURN_PTR void (*Com_Error)( int level, const char *error, ... );
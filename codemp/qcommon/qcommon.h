@@ -668,6 +668,10 @@ long		FS_FOpenFileRead( const char *qpath, fileHandle_t *file, qboolean uniqueFI
 int		FS_FileIsInPAK(const char *filename, int *pChecksum );
 // returns 1 if a file is in the PAK file, otherwise -1
 
+long	FS_FileStamp( const char *filename, int *stamp );
+// returns the length of the file FS_FOpenFileRead would open, or -1, and
+// sets stamp to something that changes whenever that file is replaced
+
 qboolean FS_FindPureDLL(const char *name);
 
 int		FS_Write( const void *buffer, int len, fileHandle_t f );
@@ -689,6 +693,9 @@ long		FS_ReadFile( const char *qpath, void **buffer );
 void	FS_ForceFlush( fileHandle_t f );
 // forces flush on files we're writing to.
 
+FILE	*FS_FileForHandle( fileHandle_t f );
+// the stdio file behind a handle that isn't in a pak file
+
 void	FS_FreeFile( void *buffer );
 // frees the memory returned by FS_ReadFile
 
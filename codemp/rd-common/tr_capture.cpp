@@ -0,0 +1,246 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+#include "tr_capture.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct captureSlot_t
+	{
+		captureJob_t				job;
+		std::vector<unsigned char>	pixels;
+		std::vector<unsigned char>	encoded;
+	};
+
+	// an encoded job waiting for the front end to write it, owning its output
+	struct captureWrite_t
+	{
+		captureJob_t				job;
+		std::vector<unsigned char>	encoded;
+	};
+
+	struct captureState_t
+	{
+		std::thread					thread;
+		std::mutex					mutex;
+		std::condition_variable		changed;
+
+		captureSlot_t				slots[CAPTURE_MAX_JOBS];
+		unsigned					numQueued = 0;	// jobs ever handed to the worker
+		unsigned					numEncoded = 0;	// jobs the worker is done with
+		std::vector<captureWrite_t>	writes;
+
+		bool						started = false;
+		bool						shutdown = false;
+	};
+
+	captureState_t cs;
+
+	captureSlot_t *SlotForJob( captureJob_t *job )
+	{
+		for ( captureSlot_t& slot : cs.slots )
+		{
+			if ( &slot.job == job )
+			{
+				return &slot;
+			}
+		}
+		assert( !"not a capture job" );
+		return nullptr;
+	}
+
+	// Encodes the slot's job, and hands its output over to the front end if
+	// it has to be written. Called without the lock.
+	void EncodeSlot( captureSlot_t *slot, std::vector<captureWrite_t>& writes )
+	{
+		captureJob_t *job = &slot->job;
+
+		job->encoded = slot->encoded.data();
+		job->encodedSize = 0;
+		job->encode( job );
+
+		if ( job->write )
+		{
+			captureWrite_t write;
+			write.job = *job;
+			write.encoded = std::move( slot->encoded );
+			write.job.encoded = write.encoded.data();
+			slot->encoded.clear();
+			writes.push_back( std::move( write ) );
+		}
+	}
+
+	void CaptureThreadMain( void )
+	{
+		std::unique_lock<std::mutex> lock( cs.mutex );
+
+		for ( ;; )
+		{
+			cs.changed.wait( lock, [] { return cs.numEncoded != cs.numQueued || cs.shutdown; } );
+
+			if ( cs.numEncoded == cs.numQueued )
+			{
+				break;
+			}
+
+			captureSlot_t *slot = &cs.slots[cs.numEncoded % CAPTURE_MAX_JOBS];
+			std::vector<captureWrite_t> writes;
+			lock.unlock();
+
+			EncodeSlot( slot, writes );
+
+			lock.lock();
+			for ( captureWrite_t& write : writes )
+			{
+				cs.writes.push_back( std::move( write ) );
+			}
+			cs.numEncoded++;
+			cs.changed.notify_all();
+		}
+	}
+}
+
+captureJob_t *R_GetCaptureJob( size_t pixelsSize )
+{
+	std::unique_lock<std::mutex> lock( cs.mutex );
+
+	if ( !cs.started )
+	{
+		cs.started = true;
+		cs.shutdown = false;
+		try
+		{
+			cs.thread = std::thread( CaptureThreadMain );
+		}
+		catch ( const std::system_error& )
+		{
+			// encode on the caller's thread instead
+		}
+	}
+
+	cs.changed.wait( lock, [] { return cs.numQueued - cs.numEncoded < CAPTURE_MAX_JOBS; } );
+
+	// the worker doesn't look at this slot until it's queued
+	captureSlot_t *slot = &cs.slots[cs.numQueued % CAPTURE_MAX_JOBS];
+	lock.unlock();
+
+	if ( slot->pixels.size() < pixelsSize )
+	{
+		slot->pixels.resize( pixelsSize );
+	}
+
+	captureJob_t *job = &slot->job;
+	*job = captureJob_t();
+	job->pixels = slot->pixels.data();
+	return job;
+}
+
+void R_QueueCaptureJob( captureJob_t *job )
+{
+	captureSlot_t *slot = SlotForJob( job );
+	assert( slot == &cs.slots[cs.numQueued % CAPTURE_MAX_JOBS] );
+	assert( job->encode );
+
+	if ( !cs.thread.joinable() )
+	{
+		std::vector<captureWrite_t> writes;
+		EncodeSlot( slot, writes );
+
+		std::lock_guard<std::mutex> lock( cs.mutex );
+		for ( captureWrite_t& write : writes )
+		{
+			cs.writes.push_back( std::move( write ) );
+		}
+		cs.numQueued++;
+		cs.numEncoded++;
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock( cs.mutex );
+	cs.numQueued++;
+	cs.changed.notify_all();
+}
+
+unsigned char *R_CaptureEncodeBuffer( captureJob_t *job, size_t size )
+{
+	captureSlot_t *slot = SlotForJob( job );
+
+	if ( slot->encoded.size() < size )
+	{
+		slot->encoded.resize( size );
+	}
+	job->encoded = slot->encoded.data();
+	return job->encoded;
+}
+
+void R_PollCaptureJobs( void )
+{
+	std::vector<captureWrite_t> writes;
+	{
+		std::lock_guard<std::mutex> lock( cs.mutex );
+		writes.swap( cs.writes );
+	}
+
+	for ( captureWrite_t& write : writes )
+	{
+		write.job.write( &write.job );
+	}
+}
+
+void R_FinishCaptureJobs( void )
+{
+	{
+		std::unique_lock<std::mutex> lock( cs.mutex );
+		cs.changed.wait( lock, [] { return cs.numEncoded == cs.numQueued; } );
+	}
+	R_PollCaptureJobs();
+}
+
+void R_ShutdownCaptureThread( void )
+{
+	R_FinishCaptureJobs();
+
+	if ( cs.thread.joinable() )
+	{
+		{
+			std::lock_guard<std::mutex> lock( cs.mutex );
+			cs.shutdown = true;
+			cs.changed.notify_all();
+		}
+		cs.thread.join();
+	}
+
+	for ( captureSlot_t& slot : cs.slots )
+	{
+		std::vector<unsigned char>().swap( slot.pixels );
+		std::vector<unsigned char>().swap( slot.encoded );
+	}
+	cs.numQueued = cs.numEncoded = 0;
+	cs.started = false;
+	cs.shutdown = false;
+}
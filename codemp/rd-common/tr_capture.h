@@ -0,0 +1,87 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+// Filename:-	tr_capture.h
+//
+// A worker thread that encodes captured frames, so that /video and
+// screenshots don't stall the renderer while a frame is gamma corrected,
+// compressed and written out.
+//
+// The renderer reads the pixels back into a job, then queues it. The worker
+// runs the job's encode function, in the order the jobs were queued. Jobs
+// that need the filesystem, which isn't thread safe, also get a write
+// function that runs on the front end from R_PollCaptureJobs. Only a few
+// jobs can be in flight at a time; getting a new one waits for the worker
+// when they're all taken.
+//
+// What a job does is entirely up to its functions, which is how rd-vanilla
+// and rend2 share the worker; tests/rd-common/capture.cpp queues jobs whose
+// functions only record the order they ran in.
+
+#pragma once
+
+#include <stddef.h>
+
+#define CAPTURE_MAX_JOBS		4
+#define CAPTURE_MAX_FILENAME	256
+
+typedef struct captureJob_s captureJob_t;
+typedef void (*captureFunc_t)( captureJob_t *job );
+
+struct captureJob_s {
+	captureFunc_t	encode;			// runs on the worker
+	captureFunc_t	write;			// runs on the front end afterwards, may be NULL
+
+	// filled in by the caller
+	unsigned char	*pixels;		// as many bytes as were asked for
+	int				width;
+	int				height;
+	int				stride;			// bytes from one row of pixels to the next
+	int				format;			// up to the encoder
+	int				quality;
+	bool			gammaCorrect;
+	char			fileName[CAPTURE_MAX_FILENAME];
+
+	// filled in by encode for write
+	unsigned char	*encoded;		// see R_CaptureEncodeBuffer
+	size_t			encodedSize;	// bytes of it that were used
+};
+
+// Returns a free job with room for pixelsSize bytes of pixels. Fill it in and
+// pass it to R_QueueCaptureJob before getting the next one.
+captureJob_t *R_GetCaptureJob( size_t pixelsSize );
+
+// Hands the job to the worker. Runs it right away if the worker couldn't be
+// started.
+void R_QueueCaptureJob( captureJob_t *job );
+
+// Makes job->encoded at least size bytes, keeping what's already in it, and
+// returns it. For encode functions; the buffer is reused by later jobs.
+unsigned char *R_CaptureEncodeBuffer( captureJob_t *job, size_t size );
+
+// Runs the write function of every job the worker is done with. Call from the
+// front end, once a frame.
+void R_PollCaptureJobs( void );
+
+// Waits for every queued job to be encoded and written.
+void R_FinishCaptureJobs( void );
+
+// Finishes every queued job, stops the worker and frees its buffers.
+void R_ShutdownCaptureThread( void );
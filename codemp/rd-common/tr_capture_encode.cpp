@@ -0,0 +1,159 @@
+/*
+===========================================================================
+Copyright (C) 1999 - 2005, Id Software, Inc.
+Copyright (C) 2000 - 2013, Raven Software, Inc.
+Copyright (C) 2001 - 2013, Activision, Inc.
+Copyright (C) 2005 - 2015, ioquake3 contributors
+Copyright (C) 2013 - 2015, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+#include "tr_common.h"
+#include "../qcommon/qcommon.h"
+
+/*
+==================
+R_CaptureToBGR
+
+Swaps the pixels to BGR and pads each row to rowAlign bytes, as TGA and raw
+AVI frames want them.
+==================
+*/
+static void R_CaptureToBGR( const captureJob_t *job, byte *out, int rowAlign )
+{
+	const int linelen = job->width * 3;
+	const int outPadlen = PAD( linelen, rowAlign ) - linelen;
+
+	const byte *row = job->pixels;
+	for ( int y = 0; y < job->height; y++, row += job->stride )
+	{
+		const byte *src = row;
+		for ( int x = 0; x < job->width; x++, src += 3 )
+		{
+			*out++ = src[2];
+			*out++ = src[1];
+			*out++ = src[0];
+		}
+
+		Com_Memset( out, 0, outPadlen );
+		out += outPadlen;
+	}
+}
+
+static void R_CaptureAppend( void *data, const byte *bytes, size_t length )
+{
+	captureJob_t *job = (captureJob_t *)data;
+	byte *out = R_CaptureEncodeBuffer( job, job->encodedSize + length );
+
+	Com_Memcpy( out + job->encodedSize, bytes, length );
+	job->encodedSize += length;
+}
+
+/*
+==================
+R_EncodeCapture
+==================
+*/
+void R_EncodeCapture( captureJob_t *job )
+{
+	const int linelen = job->width * 3;
+	const int padlen = job->stride - linelen;
+
+	if ( job->gammaCorrect )
+		R_GammaCorrect( job->pixels, job->stride * job->height );
+
+	switch ( job->format )
+	{
+		case CAPTURE_AVI_MJPEG:
+		case CAPTURE_JPEG:
+		{
+			const size_t bufSize = linelen * job->height;
+			byte *out = R_CaptureEncodeBuffer( job, bufSize );
+
+			job->encodedSize = RE_SaveJPGToBuffer( out, bufSize, job->quality,
+				job->width, job->height, job->pixels, padlen );
+			break;
+		}
+
+		case CAPTURE_AVI_RAW:
+		{
+			job->encodedSize = PAD( linelen, AVI_LINE_PADDING ) * job->height;
+			R_CaptureToBGR( job, R_CaptureEncodeBuffer( job, job->encodedSize ), AVI_LINE_PADDING );
+			break;
+		}
+
+		case CAPTURE_TGA:
+		{
+			const size_t headerSize = 18;
+			byte *out;
+
+			job->encodedSize = headerSize + linelen * job->height;
+			out = R_CaptureEncodeBuffer( job, job->encodedSize );
+
+			Com_Memset( out, 0, headerSize );
+			out[2] = 2;		// uncompressed type
+			out[12] = job->width & 255;
+			out[13] = job->width >> 8;
+			out[14] = job->height & 255;
+			out[15] = job->height >> 8;
+			out[16] = 24;	// pixel size
+
+			R_CaptureToBGR( job, out + headerSize, 1 );
+			break;
+		}
+
+		case CAPTURE_PNG:
+		{
+			// RE_SavePNGToWriter wants rows without padding
+			if ( padlen )
+			{
+				for ( int y = 1; y < job->height; y++ )
+					memmove( job->pixels + y * linelen, job->pixels + y * job->stride, linelen );
+			}
+
+			if ( RE_SavePNGToWriter( job->pixels, job->width, job->height, 3, R_CaptureAppend, job ) != 0 )
+				job->encodedSize = 0;
+			break;
+		}
+	}
+}
+
+/*
+==================
+R_WriteCaptureVideoFrame
+==================
+*/
+void R_WriteCaptureVideoFrame( captureJob_t *job )
+{
+	ri.CL_WriteAVIVideoFrame( job->encoded, job->encodedSize );
+}
+
+/*
+==================
+R_WriteCapture
+==================
+*/
+void R_WriteCapture( captureJob_t *job )
+{
+	if ( !job->encodedSize )
+	{
+		ri.Printf( PRINT_ALL, S_COLOR_RED "Failed to encode %s\n", job->fileName );
+		return;
+	}
+
+	ri.FS_WriteFile( job->fileName, job->encoded, job->encodedSize );
+}
@@ -26,6 +26,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include "../rd-common/tr_public.h"
 #include "../rd-common/tr_font.h"
+#include "../rd-common/tr_capture.h"
 
 extern refimport_t ri;
 
@@ -60,6 +61,13 @@ qboolean R_ImageLoader_Add( const char *extension, ImageLoaderFn imageLoader );
 // Load an image from file.
 void R_LoadImage( const char *shortname, byte **pic, int *width, int *height );
 
+// Load an image from file, and give the name of the file that was decoded.
+void R_LoadImageFile( const char *shortname, byte **pic, int *width, int *height, char *filename, int filenameSize );
+
+// Find the first file R_LoadImage tries for shortname that exists, without
+// reading it. Returns its length and FS_FileStamp, or -1 if there is none.
+long R_FindImageSource( const char *shortname, char *filename, int filenameSize, int *stamp );
+
 // Load raw image data from TGA image.
 void LoadTGA( const char *name, byte **pic, int *width, int *height );
 
@@ -69,6 +77,12 @@ void LoadJPG( const char *filename, byte **pic, int *width, int *height );
 // Load raw image data from PNG image.
 void LoadPNG( const char *filename, byte **data, int *width, int *height );
 
+// Decode JPEG or PNG image data that has already been read from file. These
+// are safe to call from any thread: nothing is printed on failure, and the
+// image is allocated with malloc and must be released with free.
+qboolean R_DecodeJPG( const byte *buf, int len, byte **pic, int *width, int *height );
+qboolean R_DecodePNG( const byte *buf, int len, byte **data, int *width, int *height );
+
 
 /*
 ================================================================================
@@ -84,4 +98,36 @@ void RE_SaveJPG( const char * filename, int quality, int image_width, int image_
 // Save raw image data as PNG image file.
 int RE_SavePNG( const char *filename, byte *buf, size_t width, size_t height, int byteDepth );
 
+// Convert raw image data to PNG format and hand it to write a piece at a time.
+// Doesn't touch the filesystem, so that it can run off the main thread.
+typedef void (*pngWriteFunc_t)( void *data, const byte *bytes, size_t length );
+int RE_SavePNGToWriter( byte *buf, size_t width, size_t height, int byteDepth, pngWriteFunc_t write, void *writeData );
+
+/*
+================================================================================
+ Frame capture
+================================================================================
+*/
+// Formats for captureJob_t::format.
+typedef enum {
+	CAPTURE_TGA,
+	CAPTURE_JPEG,
+	CAPTURE_PNG,
+	CAPTURE_AVI_RAW,		// written to the open video, not to fileName
+	CAPTURE_AVI_MJPEG
+} captureFormat_t;
+
+// Gamma corrects and encodes a job's pixels, which are RGB rows bottom to top
+// as glReadPixels gives them. Safe to call from any thread.
+void R_EncodeCapture( captureJob_t *job );
+
+// Hands an encoded video frame to the client. Call from the main thread.
+void R_WriteCaptureVideoFrame( captureJob_t *job );
+
+// Writes an encoded screenshot to its file. Call from the main thread.
+void R_WriteCapture( captureJob_t *job );
+
+// Gamma corrects pixels with the current gamma table; each renderer has one.
+void R_GammaCorrect( byte *buffer, int bufSize );
+
 #endif
@@ -32,6 +32,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
  * You may also wish to include "jerror.h".
  */
 
+#include <setjmp.h>
 #include <jpeglib.h>
 
 static void R_JPGErrorExit(j_common_ptr cinfo)
@@ -221,6 +222,101 @@ void LoadJPG( const char *filename, unsigned char **pic, int *width, int *height
 	/* And we're done! */
 }
 
+typedef struct jpegDecodeError_s {
+	struct jpeg_error_mgr pub;
+	jmp_buf setjmpBuffer;
+} jpegDecodeError_t;
+
+static void R_JPGDecodeErrorExit(j_common_ptr cinfo)
+{
+	jpegDecodeError_t *err = (jpegDecodeError_t *)cinfo->err;
+
+	longjmp(err->setjmpBuffer, 1);
+}
+
+static void R_JPGDecodeOutputMessage(j_common_ptr cinfo)
+{
+}
+
+/*
+Decodes a JPEG image that has already been read into memory. Safe to call
+from any thread: nothing is printed and the image is allocated with malloc.
+*/
+qboolean R_DecodeJPG( const byte *buf, int len, byte **pic, int *width, int *height ) {
+	struct jpeg_decompress_struct cinfo = { NULL };
+	jpegDecodeError_t jerr;
+	byte * volatile out = NULL;
+	unsigned int row_stride;
+	unsigned int pixelcount, memcount;
+	unsigned int sindex, dindex;
+	JSAMPROW row;
+
+	*pic = NULL;
+	*width = 0;
+	*height = 0;
+
+	cinfo.err = jpeg_std_error(&jerr.pub);
+	cinfo.err->error_exit = R_JPGDecodeErrorExit;
+	cinfo.err->output_message = R_JPGDecodeOutputMessage;
+
+	if ( setjmp(jerr.setjmpBuffer) ) {
+		jpeg_destroy_decompress(&cinfo);
+		free(out);
+		return qfalse;
+	}
+
+	jpeg_create_decompress(&cinfo);
+	jpeg_mem_src(&cinfo, (unsigned char *)buf, len);
+	(void) jpeg_read_header(&cinfo, TRUE);
+
+	cinfo.out_color_space = JCS_RGB;
+	(void) jpeg_start_decompress(&cinfo);
+
+	pixelcount = cinfo.output_width * cinfo.output_height;
+
+	if(!cinfo.output_width || !cinfo.output_height
+		|| ((pixelcount * 4) / cinfo.output_width) / 4 != cinfo.output_height
+		|| pixelcount > 0x1FFFFFFF || cinfo.output_components != 3
+		)
+	{
+		jpeg_destroy_decompress(&cinfo);
+		return qfalse;
+	}
+
+	memcount = pixelcount * 4;
+	row_stride = cinfo.output_width * cinfo.output_components;
+
+	out = (byte *)malloc(memcount);
+	if ( !out ) {
+		jpeg_destroy_decompress(&cinfo);
+		return qfalse;
+	}
+
+	while (cinfo.output_scanline < cinfo.output_height) {
+		row = out + row_stride * cinfo.output_scanline;
+		(void) jpeg_read_scanlines(&cinfo, &row, 1);
+	}
+
+	// Expand from RGB to RGBA
+	sindex = pixelcount * cinfo.output_components;
+	dindex = memcount;
+
+	do {
+		out[--dindex] = 255;
+		out[--dindex] = out[--sindex];
+		out[--dindex] = out[--sindex];
+		out[--dindex] = out[--sindex];
+	} while(sindex);
+
+	(void) jpeg_finish_decompress(&cinfo);
+	jpeg_destroy_decompress(&cinfo);
+
+	*pic = out;
+	*width = cinfo.output_width;
+	*height = cinfo.output_height;
+	return qtrue;
+}
+
 
 /* Expanded data destination object for stdio output */
 
@@ -102,6 +102,16 @@ Loads any of the supported image types into a cannonical
 =================
 */
 void R_LoadImage( const char *shortname, byte **pic, int *width, int *height ) {
+	R_LoadImageFile (shortname, pic, width, height, NULL, 0);
+}
+
+/*
+=================
+Same as R_LoadImage, and copies the name of the file that was
+decoded into filename, if it isn't NULL.
+=================
+*/
+void R_LoadImageFile( const char *shortname, byte **pic, int *width, int *height, char *filename, int filenameSize ) {
 	*pic = NULL;
 	*width = 0;
 	*height = 0;
@@ -114,6 +124,10 @@ void R_LoadImage( const char *shortname, byte **pic, int *width, int *height ) {
 		imageLoader->loader (shortname, pic, width, height);
 		if ( *pic )
 		{
+			if ( filename )
+			{
+				Q_strncpyz (filename, shortname, filenameSize);
+			}
 			return;
 		}
 	}
@@ -134,7 +148,55 @@ void R_LoadImage( const char *shortname, byte **pic, int *width, int *height ) {
 		tryLoader->loader (name, pic, width, height);
 		if ( *pic )
 		{
+			if ( filename )
+			{
+				Q_strncpyz (filename, name, filenameSize);
+			}
 			return;
 		}
 	}
 }
+
+/*
+=================
+Finds the first file R_LoadImage would try for shortname that exists,
+in the same order, without reading it. A file that fails to
+decode is still returned; R_LoadImageFile tells when that happened.
+=================
+*/
+long R_FindImageSource( const char *shortname, char *filename, int filenameSize, int *stamp ) {
+	long length;
+
+	const char *extension = COM_GetExtension (shortname);
+	const ImageLoaderMap *imageLoader = FindImageLoader (extension);
+	if ( imageLoader != NULL )
+	{
+		length = ri.FS_FileStamp (shortname, stamp);
+		if ( length > 0 )
+		{
+			Q_strncpyz (filename, shortname, filenameSize);
+			return length;
+		}
+	}
+
+	char extensionlessName[MAX_QPATH];
+	COM_StripExtension(shortname, extensionlessName, sizeof( extensionlessName ));
+	for ( int i = 0; i < numImageLoaders; i++ )
+	{
+		const ImageLoaderMap *tryLoader = &imageLoaders[i];
+		if ( tryLoader == imageLoader )
+		{
+			continue;
+		}
+
+		Com_sprintf (filename, filenameSize, "%s.%s", extensionlessName, tryLoader->extension);
+		length = ri.FS_FileStamp (filename, stamp);
+		if ( length > 0 )
+		{
+			return length;
+		}
+	}
+
+	filename[0] = '\0';
+	return -1;
+}
@@ -25,16 +25,41 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "tr_common.h"
 #include <png.h>
 
+typedef struct pngWriter_s {
+	pngWriteFunc_t	write;
+	void			*data;
+} pngWriter_t;
+
 void user_write_data( png_structp png_ptr, png_bytep data, png_size_t length ) {
-	fileHandle_t fp = *(fileHandle_t*)png_get_io_ptr( png_ptr );
-	ri.FS_Write( data, length, fp );
+	pngWriter_t *writer = (pngWriter_t *)png_get_io_ptr( png_ptr );
+	writer->write( writer->data, data, length );
 }
 void user_flush_data( png_structp png_ptr ) {
 	//TODO: ri.FS_Flush?
 }
 
+static void PNG_WriteToFile( void *data, const byte *bytes, size_t length ) {
+	fileHandle_t fp = *(fileHandle_t *)data;
+	ri.FS_Write( bytes, length, fp );
+}
+
 int RE_SavePNG( const char *filename, byte *buf, size_t width, size_t height, int byteDepth ) {
 	fileHandle_t fp;
+	int status;
+
+	fp = ri.FS_FOpenFileWrite( filename, qtrue );
+	if ( !fp ) {
+		return -1;
+	}
+
+	status = RE_SavePNGToWriter( buf, width, height, byteDepth, PNG_WriteToFile, &fp );
+
+	ri.FS_FCloseFile( fp );
+	return status;
+}
+
+int RE_SavePNGToWriter( byte *buf, size_t width, size_t height, int byteDepth, pngWriteFunc_t write, void *writeData ) {
+	pngWriter_t writer;
 	png_structp png_ptr = NULL;
 	png_infop info_ptr = NULL;
 	unsigned int x, y;
@@ -49,11 +74,6 @@ int RE_SavePNG( const char *filename, byte *buf, size_t width, size_t height, in
 	*/
 	int depth = 8;
 
-	fp = ri.FS_FOpenFileWrite( filename, qtrue );
-	if ( !fp ) {
-		goto fopen_failed;
-	}
-
 	png_ptr = png_create_write_struct (PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
 	if (png_ptr == NULL) {
 		goto png_create_write_struct_failed;
@@ -96,10 +116,11 @@ int RE_SavePNG( const char *filename, byte *buf, size_t width, size_t height, in
 		}
 	}
 
-	/* Write the image data to "fp". */
+	/* Write the image data to the writer. */
 
-//	png_init_io (png_ptr, fp);
-	png_set_write_fn( png_ptr, (png_voidp)&fp, user_write_data, user_flush_data );
+	writer.write = write;
+	writer.data = writeData;
+	png_set_write_fn( png_ptr, (png_voidp)&writer, user_write_data, user_flush_data );
 	png_set_rows (png_ptr, info_ptr, row_pointers);
 	png_write_png (png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
 
@@ -117,8 +138,6 @@ png_failure:
 png_create_info_struct_failed:
 	png_destroy_write_struct (&png_ptr, &info_ptr);
 png_create_write_struct_failed:
-	ri.FS_FCloseFile( fp );
-fopen_failed:
 	return status;
 }
 
@@ -133,17 +152,39 @@ void png_print_warning ( png_structp png_ptr, png_const_charp warning )
 	ri.Printf (PRINT_WARNING, "%s\n", warning);
 }
 
+static void png_silent_error ( png_structp png_ptr, png_const_charp err )
+{
+	png_longjmp (png_ptr, 1);
+}
+
+static void png_silent_warning ( png_structp png_ptr, png_const_charp warning )
+{
+}
+
 bool IsPowerOfTwo ( int i ) { return (i & (i - 1)) == 0; }
 
+// A threaded reader does not own buf, never prints and allocates the image
+// with malloc, so that R_DecodePNG can run it away from the main thread.
 struct PNGFileReader
 {
-	PNGFileReader ( char *buf ) : buf(buf), offset(0), png_ptr(NULL), info_ptr(NULL) {}
+	PNGFileReader ( char *buf, bool threaded = false ) : buf(buf), offset(0), threaded(threaded), png_ptr(NULL), info_ptr(NULL) {}
 	~PNGFileReader()
 	{
-		ri.FS_FreeFile (buf);
+		if ( !threaded )
+		{
+			ri.FS_FreeFile (buf);
+		}
 		png_destroy_read_struct (&png_ptr, &info_ptr, NULL);
 	}
 
+	void Error ( const char *message )
+	{
+		if ( !threaded )
+		{
+			ri.Printf (PRINT_ERROR, "%s", message);
+		}
+	}
+
 	int Read ( byte **data, int *width, int *height )
 	{
 		// Setup the pointers
@@ -159,14 +200,21 @@ struct PNGFileReader
 
 		if ( !png_check_sig (ident, SIGNATURE_LEN) )
 		{
-			ri.Printf (PRINT_ERROR, "PNG signature not found in given image.");
+			Error ("PNG signature not found in given image.");
 			return 0;
 		}
 
-		png_ptr = png_create_read_struct (PNG_LIBPNG_VER_STRING, NULL, png_print_error, png_print_warning);
+		if ( threaded )
+		{
+			png_ptr = png_create_read_struct (PNG_LIBPNG_VER_STRING, NULL, png_silent_error, png_silent_warning);
+		}
+		else
+		{
+			png_ptr = png_create_read_struct (PNG_LIBPNG_VER_STRING, NULL, png_print_error, png_print_warning);
+		}
 		if ( png_ptr == NULL )
 		{
-			ri.Printf (PRINT_ERROR, "Could not allocate enough memory to load the image.");
+			Error ("Could not allocate enough memory to load the image.");
 			return 0;
 		}
 
@@ -199,7 +247,7 @@ struct PNGFileReader
 		// so that the graphics driver doesn't have to fiddle about with the texture when uploading.
 		if ( !IsPowerOfTwo (width_) || !IsPowerOfTwo (height_) )
 		{
-			ri.Printf (PRINT_ERROR, "Width or height is not a power-of-two.\n");
+			Error ("Width or height is not a power-of-two.\n");
 			return 0;
 		}
 
@@ -209,7 +257,7 @@ struct PNGFileReader
 		// PNG_COLOR_TYPE_GRAY.
 		if ( colortype != PNG_COLOR_TYPE_RGB && colortype != PNG_COLOR_TYPE_RGBA )
 		{
-			ri.Printf (PRINT_ERROR, "Image is not 24-bit or 32-bit.");
+			Error ("Image is not 24-bit or 32-bit.");
 			return 0;
 		}
 
@@ -223,20 +271,20 @@ struct PNGFileReader
 		png_read_update_info (png_ptr, info_ptr);
 
 		// We always assume there are 4 channels. RGB channels are expanded to RGBA when read.
-		byte *tempData = (byte *)ri.Z_Malloc (width_ * height_ * 4, TAG_TEMP_PNG, qfalse, 4);
+		byte *tempData = (byte *)AllocImage (width_ * height_ * 4);
 		if ( !tempData )
 		{
-			ri.Printf (PRINT_ERROR, "Could not allocate enough memory to load the image.");
+			Error ("Could not allocate enough memory to load the image.");
 			return 0;
 		}
 
 		// Dynamic array of row pointers, with 'height' elements, initialized to NULL.
-		byte **row_pointers = (byte **)ri.Hunk_AllocateTempMemory (sizeof (byte *) * height_);
+		byte **row_pointers = (byte **)AllocRows (sizeof (byte *) * height_);
 		if ( !row_pointers )
 		{
-			ri.Printf (PRINT_ERROR, "Could not allocate enough memory to load the image.");
+			Error ("Could not allocate enough memory to load the image.");
 
-			ri.Z_Free (tempData);
+			FreeImage (tempData);
 
 			return 0;
 		}
@@ -244,8 +292,8 @@ struct PNGFileReader
 		// Re-set the jmp so that these new memory allocations can be reclaimed
 		if ( setjmp (png_jmpbuf (png_ptr)) )
 		{
-			ri.Hunk_FreeTempMemory (row_pointers);
-			ri.Z_Free (tempData);
+			FreeRows (row_pointers);
+			FreeImage (tempData);
 			return 0;
 		}
 
@@ -259,7 +307,7 @@ struct PNGFileReader
 		// Finish reading
 		png_read_end (png_ptr, NULL);
 
-		ri.Hunk_FreeTempMemory (row_pointers);
+		FreeRows (row_pointers);
 
 		// Finally assign all the parameters
 		*data = tempData;
@@ -276,8 +324,35 @@ struct PNGFileReader
 	}
 
 private:
+	void *AllocImage ( size_t size )
+	{
+		return threaded ? malloc (size) : ri.Z_Malloc (size, TAG_TEMP_PNG, qfalse, 4);
+	}
+
+	void FreeImage ( void *ptr )
+	{
+		if ( threaded )
+			free (ptr);
+		else
+			ri.Z_Free (ptr);
+	}
+
+	void *AllocRows ( size_t size )
+	{
+		return threaded ? malloc (size) : ri.Hunk_AllocateTempMemory (size);
+	}
+
+	void FreeRows ( void *ptr )
+	{
+		if ( threaded )
+			free (ptr);
+		else
+			ri.Hunk_FreeTempMemory (ptr);
+	}
+
 	char *buf;
 	size_t offset;
+	bool threaded;
 	png_structp png_ptr;
 	png_infop info_ptr;
 };
@@ -302,3 +377,20 @@ void LoadPNG ( const char *filename, byte **data, int *width, int *height )
 	reader.Read (data, width, height);
 }
 
+
+// Decodes a PNG image that has already been read into memory. Safe to call
+// from any thread.
+qboolean R_DecodePNG ( const byte *buf, int len, byte **data, int *width, int *height )
+{
+	*data = NULL;
+	*width = 0;
+	*height = 0;
+
+	if ( len < 8 )
+	{
+		return qfalse;
+	}
+
+	PNGFileReader reader ((char *)buf, true);
+	return (qboolean)(reader.Read (data, width, height) != 0);
+}
@@ -30,7 +30,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "../qcommon/qcommon.h"
 #include "../ghoul2/ghoul2_shared.h"
 
-#define	REF_API_VERSION 9
+#define	REF_API_VERSION 12
 
 //
 // these are the functions exported by the refresh module
@@ -138,7 +138,8 @@ typedef struct refexport_s {
 	qboolean			(*RegisterModels_LevelLoadEnd)			( qboolean bDeleteEverythingNotUsedThisLevel );
 
 	// AVI recording
-	void				(*TakeVideoFrame)						( int h, int w, byte* captureBuffer, byte *encodeBuffer, qboolean motionJpeg );
+	void				(*TakeVideoFrame)						( int width, int height, qboolean motionJpeg );
+	void				(*FinishVideoFrames)					( void ); // hands every frame taken so far to CL_WriteAVIVideoFrame
 
 	// G2 stuff
 	void				(*InitSkins)							( void );
@@ -296,9 +297,11 @@ typedef struct refimport_s {
 	int				(*FS_FOpenFileByMode)				( const char *qpath, fileHandle_t *f, fsMode_t mode );
 	qboolean		(*FS_FileExists)					( const char *file );
 	int				(*FS_FileIsInPAK)					( const char *filename, int *pChecksum );
+	long			(*FS_FileStamp)						( const char *filename, int *stamp );
 	char **			(*FS_ListFiles)						( const char *directory, const char *extension, int *numfiles );
 	int				(*FS_Write)							( const void *buffer, int len, fileHandle_t f );
 	void			(*FS_WriteFile)						( const char *qpath, const void *buffer, int size );
+	void			(*FS_HomeRemove)					( const char *homePath );
 	void			(*CM_BoxTrace)						( trace_t *results, const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs, clipHandle_t model, int brushmask, int capsule );
 	void			(*CM_DrawDebugSurface)				( void (*drawPoly)(int color, int numPoints, float *points) );
 	bool			(*CM_CullWorldBox)					( const cplane_t *frustum, const vec3pair_t bounds );
@@ -332,6 +335,7 @@ typedef struct refimport_s {
 	// OpenGL-specific
 	void *			(*GL_GetProcAddress)				( const char *name );
 	qboolean		(*GL_ExtensionSupported)			( const char *extension );
+	void			(*GL_MakeCurrent)					( qboolean current ); // on the calling thread
 
 	// gpvCachedMapDiskImage
 	void *			(*CM_GetCachedMapDiskImage)			( void );
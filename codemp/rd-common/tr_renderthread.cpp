@@ -0,0 +1,202 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+#include "tr_renderthread.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+	struct renderThreadState_t
+	{
+		std::thread					thread;
+		std::mutex					mutex;
+		std::condition_variable		changed;
+
+		renderThreadExecute_t		execute = nullptr;
+		renderThreadMakeCurrent_t	makeCurrent = nullptr;
+
+		const void					*pendingData = nullptr;	// set while a command list is queued or running
+		bool						releaseContext = false;	// the front end wants the context back
+		bool						shutdown = false;
+
+		// only touched by the front end
+		bool						active = false;
+		bool						frontEndHasContext = false;
+	};
+
+	renderThreadState_t rt;
+
+	// code shared with the front end may wait for the render thread
+	bool OnRenderThread( void )
+	{
+		return std::this_thread::get_id() == rt.thread.get_id();
+	}
+
+	void RenderThreadMain( void )
+	{
+		bool hasContext = false;
+		std::unique_lock<std::mutex> lock( rt.mutex );
+
+		for ( ;; )
+		{
+			rt.changed.wait( lock, [] { return rt.pendingData || rt.releaseContext || rt.shutdown; } );
+
+			if ( rt.pendingData )
+			{
+				const void *data = rt.pendingData;
+				lock.unlock();
+
+				if ( !hasContext )
+				{
+					rt.makeCurrent( true );
+					hasContext = true;
+				}
+				rt.execute( data );
+
+				lock.lock();
+				rt.pendingData = nullptr;
+				rt.changed.notify_all();
+				continue;
+			}
+
+			if ( rt.releaseContext || rt.shutdown )
+			{
+				if ( hasContext )
+				{
+					rt.makeCurrent( false );
+					hasContext = false;
+				}
+				rt.releaseContext = false;
+				rt.changed.notify_all();
+
+				if ( rt.shutdown )
+				{
+					break;
+				}
+			}
+		}
+	}
+}
+
+bool R_SpawnRenderThread( renderThreadExecute_t execute, renderThreadMakeCurrent_t makeCurrent )
+{
+	assert( !rt.active );
+
+	rt.execute = execute;
+	rt.makeCurrent = makeCurrent;
+	rt.pendingData = nullptr;
+	rt.releaseContext = false;
+	rt.shutdown = false;
+
+	try
+	{
+		rt.thread = std::thread( RenderThreadMain );
+	}
+	catch ( const std::system_error& )
+	{
+		return false;
+	}
+
+	rt.active = true;
+	rt.frontEndHasContext = true;
+	return true;
+}
+
+void R_ShutdownRenderThread( void )
+{
+	if ( !rt.active )
+	{
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock( rt.mutex );
+		rt.changed.wait( lock, [] { return !rt.pendingData; } );
+		rt.shutdown = true;
+		rt.changed.notify_all();
+	}
+	rt.thread.join();
+
+	if ( !rt.frontEndHasContext )
+	{
+		rt.makeCurrent( true );
+	}
+	rt.active = false;
+	rt.frontEndHasContext = false;
+}
+
+bool R_RenderThreadActive( void )
+{
+	return rt.active;
+}
+
+void R_WakeRenderThread( const void *data )
+{
+	assert( rt.active && data );
+
+	std::unique_lock<std::mutex> lock( rt.mutex );
+	rt.changed.wait( lock, [] { return !rt.pendingData; } );
+
+	if ( rt.frontEndHasContext )
+	{
+		rt.makeCurrent( false );
+		rt.frontEndHasContext = false;
+	}
+
+	rt.pendingData = data;
+	rt.changed.notify_all();
+}
+
+void R_WaitRenderThread( void )
+{
+	if ( !rt.active || OnRenderThread() )
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock( rt.mutex );
+	rt.changed.wait( lock, [] { return !rt.pendingData; } );
+}
+
+void R_SyncRenderThread( void )
+{
+	if ( !rt.active || OnRenderThread() )
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock( rt.mutex );
+	rt.changed.wait( lock, [] { return !rt.pendingData; } );
+
+	if ( !rt.frontEndHasContext )
+	{
+		rt.releaseContext = true;
+		rt.changed.notify_all();
+		rt.changed.wait( lock, [] { return !rt.releaseContext; } );
+
+		rt.makeCurrent( true );
+		rt.frontEndHasContext = true;
+	}
+}
@@ -0,0 +1,65 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+// Filename:-	tr_renderthread.h
+//
+// A thread that runs the renderer's back end while the front end builds the
+// next frame, as the old r_smp did.
+//
+// The front end hands the thread one command list at a time; handing it the
+// next one waits for the previous one to be done, so two command buffers are
+// enough. The GL context belongs to whichever thread last needed it: the
+// render thread takes it to execute a command list, and keeps it until the
+// front end syncs to get it back.
+//
+// Only rd-vanilla uses it. Anything the back end reads has to be copied into
+// backEndData by the front end, or waited for with R_WaitRenderThread before
+// it's changed; ghoul2 skinning matrices are copied, so animated models don't
+// stall the front end. rend2's front end calls GL every frame, so it stays
+// synchronous.
+
+#pragma once
+
+// Runs one command list on the render thread.
+typedef void (*renderThreadExecute_t)( const void *data );
+
+// Makes the GL context current on the calling thread, or releases it.
+typedef void (*renderThreadMakeCurrent_t)( bool current );
+
+// Starts the render thread. The calling thread must have the GL context.
+bool R_SpawnRenderThread( renderThreadExecute_t execute, renderThreadMakeCurrent_t makeCurrent );
+
+// Waits for the render thread to finish what it's doing, stops it and gives
+// the GL context back to the calling thread.
+void R_ShutdownRenderThread( void );
+
+bool R_RenderThreadActive( void );
+
+// Waits for the previous command list to be done, then has the render thread
+// execute data. data must stay valid until the next call into here.
+void R_WakeRenderThread( const void *data );
+
+// Waits for the render thread to be idle. Use before touching anything the
+// back end reads, without needing GL. Does nothing on the render thread.
+void R_WaitRenderThread( void );
+
+// Waits for the render thread to be idle and takes the GL context back, so
+// that the calling thread can use GL until the next R_WakeRenderThread.
+void R_SyncRenderThread( void );
@@ -0,0 +1,427 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+// tr_vertexlerp.cpp -- interpolation of animated mesh vertexes
+#include "tr_vertexlerp.h"
+
+#include <math.h>
+
+#if defined(R_VERTEXLERP_SSE2)
+#include <emmintrin.h>
+#elif defined(R_VERTEXLERP_NEON)
+#include <arm_neon.h>
+#endif
+
+#define SINTABLE_MASK		(VERTEXLERP_SINTABLE_SIZE - 1)
+#define XYZ_SCALE			(1.0/64)	// MD3_XYZ_SCALE
+
+static inline uint32_t R_PackNormal( const float *v )
+{
+	return (((uint32_t)(v[2] * 511.5f + 512.0f)) << 20)
+		| (((uint32_t)(v[1] * 511.5f + 512.0f)) << 10)
+		| (((uint32_t)(v[0] * 511.5f + 512.0f)));
+}
+
+static inline void R_NormalizeNormal( float *v )
+{
+	const float length = sqrtf( v[0]*v[0] + v[1]*v[1] + v[2]*v[2] );
+
+	if ( length )
+	{
+		const float ilength = 1.0f / length;
+		v[0] *= ilength;
+		v[1] *= ilength;
+		v[2] *= ilength;
+	}
+}
+
+// decode X as cos( lat ) * sin( long )
+// decode Y as sin( lat ) * sin( long )
+// decode Z as cos( long )
+static inline void R_DecodeMD3Normal( short packed, const float *sinTable, float *normal )
+{
+	unsigned lat = ( packed >> 8 ) & 0xff;
+	unsigned lng = ( packed & 0xff );
+	lat *= (VERTEXLERP_SINTABLE_SIZE/256);
+	lng *= (VERTEXLERP_SINTABLE_SIZE/256);
+
+	normal[0] = sinTable[(lat+(VERTEXLERP_SINTABLE_SIZE/4))&SINTABLE_MASK] * sinTable[lng];
+	normal[1] = sinTable[lat] * sinTable[lng];
+	normal[2] = sinTable[(lng+(VERTEXLERP_SINTABLE_SIZE/4))&SINTABLE_MASK];
+}
+
+void R_LerpFloatVertexes_scalar( const float *newVerts, const float *oldVerts, int vertStride,
+	float backlerp, int numVerts, float *outXyz, uint32_t *outNormals )
+{
+	const float frontlerp = 1.0f - backlerp;
+
+	for ( int i = 0; i < numVerts; i++, newVerts += vertStride, outXyz += 4 )
+	{
+		float normal[3];
+
+		if ( backlerp == 0.0f )
+		{
+			outXyz[0] = newVerts[0];
+			outXyz[1] = newVerts[1];
+			outXyz[2] = newVerts[2];
+
+			normal[0] = newVerts[3];
+			normal[1] = newVerts[4];
+			normal[2] = newVerts[5];
+		}
+		else
+		{
+			const float *oldVert = oldVerts + i * vertStride;
+
+			outXyz[0] = newVerts[0] * frontlerp + oldVert[0] * backlerp;
+			outXyz[1] = newVerts[1] * frontlerp + oldVert[1] * backlerp;
+			outXyz[2] = newVerts[2] * frontlerp + oldVert[2] * backlerp;
+
+			normal[0] = newVerts[3] * frontlerp + oldVert[3] * backlerp;
+			normal[1] = newVerts[4] * frontlerp + oldVert[4] * backlerp;
+			normal[2] = newVerts[5] * frontlerp + oldVert[5] * backlerp;
+			R_NormalizeNormal( normal );
+		}
+
+		outXyz[3] = 1.0f;
+		outNormals[i] = R_PackNormal( normal );
+	}
+}
+
+void R_LerpMD3Vertexes_scalar( const short *newXyzNormals, const short *oldXyzNormals,
+	float backlerp, const float *sinTable, int numVerts, float *outXyz, float *outNormals )
+{
+	const float newXyzScale = XYZ_SCALE * (1.0 - backlerp);
+	const float newNormalScale = 1.0 - backlerp;
+
+	if ( backlerp == 0.0f )
+	{
+		for ( int i = 0; i < numVerts; i++, newXyzNormals += 4, outXyz += 4, outNormals += 4 )
+		{
+			outXyz[0] = newXyzNormals[0] * newXyzScale;
+			outXyz[1] = newXyzNormals[1] * newXyzScale;
+			outXyz[2] = newXyzNormals[2] * newXyzScale;
+			outXyz[3] = 1.0f;
+
+			R_DecodeMD3Normal( newXyzNormals[3], sinTable, outNormals );
+			outNormals[3] = 0.0f;
+		}
+		return;
+	}
+
+	const float oldXyzScale = XYZ_SCALE * backlerp;
+	const float oldNormalScale = backlerp;
+
+	for ( int i = 0; i < numVerts; i++, newXyzNormals += 4, oldXyzNormals += 4, outXyz += 4, outNormals += 4 )
+	{
+		float newNormal[3], oldNormal[3];
+
+		outXyz[0] = oldXyzNormals[0] * oldXyzScale + newXyzNormals[0] * newXyzScale;
+		outXyz[1] = oldXyzNormals[1] * oldXyzScale + newXyzNormals[1] * newXyzScale;
+		outXyz[2] = oldXyzNormals[2] * oldXyzScale + newXyzNormals[2] * newXyzScale;
+		outXyz[3] = 1.0f;
+
+		// FIXME: interpolate lat/long instead?
+		R_DecodeMD3Normal( newXyzNormals[3], sinTable, newNormal );
+		R_DecodeMD3Normal( oldXyzNormals[3], sinTable, oldNormal );
+
+		outNormals[0] = oldNormal[0] * oldNormalScale + newNormal[0] * newNormalScale;
+		outNormals[1] = oldNormal[1] * oldNormalScale + newNormal[1] * newNormalScale;
+		outNormals[2] = oldNormal[2] * oldNormalScale + newNormal[2] * newNormalScale;
+		outNormals[3] = 0.0f;
+		R_NormalizeNormal( outNormals );
+	}
+}
+
+#ifdef R_VERTEXLERP_SIMD
+
+/*
+================================================================================
+ Four-wide helpers
+
+ The _simd versions below are written once against these. Each lane holds one
+ vertex, and the arithmetic is done in the same order as in the _scalar
+ versions.
+================================================================================
+*/
+#if defined(R_VERTEXLERP_SSE2)
+
+typedef __m128 vec4f_t;
+
+static inline vec4f_t V4_Splat( float f ) { return _mm_set1_ps( f ); }
+static inline vec4f_t V4_Add( vec4f_t a, vec4f_t b ) { return _mm_add_ps( a, b ); }
+static inline vec4f_t V4_Mul( vec4f_t a, vec4f_t b ) { return _mm_mul_ps( a, b ); }
+static inline vec4f_t V4_Load( const float *f ) { return _mm_loadu_ps( f ); }
+
+// components [ofs, ofs+3) of four float vertexes, one per lane
+static inline void V4_LoadFloat3( const float *v, int stride, int ofs, vec4f_t *x, vec4f_t *y, vec4f_t *z )
+{
+	__m128 r0 = _mm_loadu_ps( v + ofs );
+	__m128 r1 = _mm_loadu_ps( v + stride + ofs );
+	__m128 r2 = _mm_loadu_ps( v + stride * 2 + ofs );
+	__m128 r3 = _mm_loadu_ps( v + stride * 3 + ofs );
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	*x = r0;
+	*y = r1;
+	*z = r2;
+}
+
+// the unscaled positions of four MD3 vertexes
+static inline void V4_LoadMD3Xyz( const short *v, vec4f_t *x, vec4f_t *y, vec4f_t *z )
+{
+	const __m128i lo = _mm_loadu_si128( (const __m128i *)v );
+	const __m128i hi = _mm_loadu_si128( (const __m128i *)(v + 8) );
+
+	// sign extend each short into the top half of an int and shift it back down
+	__m128 r0 = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpacklo_epi16( lo, lo ), 16 ) );
+	__m128 r1 = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpackhi_epi16( lo, lo ), 16 ) );
+	__m128 r2 = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpacklo_epi16( hi, hi ), 16 ) );
+	__m128 r3 = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpackhi_epi16( hi, hi ), 16 ) );
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	*x = r0;
+	*y = r1;
+	*z = r2;
+}
+
+static inline void V4_Normalize( vec4f_t *x, vec4f_t *y, vec4f_t *z )
+{
+	const __m128 length = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( *x, *x ), _mm_mul_ps( *y, *y ) ), _mm_mul_ps( *z, *z ) ) );
+	const __m128 nonZero = _mm_cmpneq_ps( length, _mm_setzero_ps() );
+	const __m128 ilength = _mm_div_ps( _mm_set1_ps( 1.0f ), length );
+
+	*x = _mm_or_ps( _mm_and_ps( nonZero, _mm_mul_ps( *x, ilength ) ), _mm_andnot_ps( nonZero, *x ) );
+	*y = _mm_or_ps( _mm_and_ps( nonZero, _mm_mul_ps( *y, ilength ) ), _mm_andnot_ps( nonZero, *y ) );
+	*z = _mm_or_ps( _mm_and_ps( nonZero, _mm_mul_ps( *z, ilength ) ), _mm_andnot_ps( nonZero, *z ) );
+}
+
+// four vec4s, one per lane
+static inline void V4_StoreVec4( float *out, vec4f_t x, vec4f_t y, vec4f_t z, vec4f_t w )
+{
+	_MM_TRANSPOSE4_PS( x, y, z, w );
+	_mm_storeu_ps( out, x );
+	_mm_storeu_ps( out + 4, y );
+	_mm_storeu_ps( out + 8, z );
+	_mm_storeu_ps( out + 12, w );
+}
+
+static inline void V4_StorePackedNormals( uint32_t *out, vec4f_t x, vec4f_t y, vec4f_t z )
+{
+	const __m128 scale = _mm_set1_ps( 511.5f );
+	const __m128 bias = _mm_set1_ps( 512.0f );
+	const __m128i ix = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( x, scale ), bias ) );
+	const __m128i iy = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( y, scale ), bias ) );
+	const __m128i iz = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( z, scale ), bias ) );
+
+	_mm_storeu_si128( (__m128i *)out, _mm_or_si128( _mm_or_si128( _mm_slli_epi32( iz, 20 ), _mm_slli_epi32( iy, 10 ) ), ix ) );
+}
+
+#elif defined(R_VERTEXLERP_NEON)
+
+typedef float32x4_t vec4f_t;
+
+static inline vec4f_t V4_Splat( float f ) { return vdupq_n_f32( f ); }
+static inline vec4f_t V4_Add( vec4f_t a, vec4f_t b ) { return vaddq_f32( a, b ); }
+static inline vec4f_t V4_Mul( vec4f_t a, vec4f_t b ) { return vmulq_f32( a, b ); }
+static inline vec4f_t V4_Load( const float *f ) { return vld1q_f32( f ); }
+
+static inline vec4f_t V4_Gather( const float *v, int stride )
+{
+	vec4f_t r = vdupq_n_f32( v[0] );
+	r = vsetq_lane_f32( v[stride], r, 1 );
+	r = vsetq_lane_f32( v[stride * 2], r, 2 );
+	r = vsetq_lane_f32( v[stride * 3], r, 3 );
+	return r;
+}
+
+static inline void V4_LoadFloat3( const float *v, int stride, int ofs, vec4f_t *x, vec4f_t *y, vec4f_t *z )
+{
+	*x = V4_Gather( v + ofs, stride );
+	*y = V4_Gather( v + ofs + 1, stride );
+	*z = V4_Gather( v + ofs + 2, stride );
+}
+
+static inline void V4_LoadMD3Xyz( const short *v, vec4f_t *x, vec4f_t *y, vec4f_t *z )
+{
+	const int16x4x4_t r = vld4_s16( v );
+
+	*x = vcvtq_f32_s32( vmovl_s16( r.val[0] ) );
+	*y = vcvtq_f32_s32( vmovl_s16( r.val[1] ) );
+	*z = vcvtq_f32_s32( vmovl_s16( r.val[2] ) );
+}
+
+static inline void V4_Normalize( vec4f_t *x, vec4f_t *y, vec4f_t *z )
+{
+	const float32x4_t length = vsqrtq_f32( vaddq_f32( vaddq_f32( vmulq_f32( *x, *x ), vmulq_f32( *y, *y ) ), vmulq_f32( *z, *z ) ) );
+	const uint32x4_t nonZero = vmvnq_u32( vceqq_f32( length, vdupq_n_f32( 0.0f ) ) );
+	const float32x4_t ilength = vdivq_f32( vdupq_n_f32( 1.0f ), length );
+
+	*x = vbslq_f32( nonZero, vmulq_f32( *x, ilength ), *x );
+	*y = vbslq_f32( nonZero, vmulq_f32( *y, ilength ), *y );
+	*z = vbslq_f32( nonZero, vmulq_f32( *z, ilength ), *z );
+}
+
+static inline void V4_StoreVec4( float *out, vec4f_t x, vec4f_t y, vec4f_t z, vec4f_t w )
+{
+	float32x4x4_t v;
+	v.val[0] = x;
+	v.val[1] = y;
+	v.val[2] = z;
+	v.val[3] = w;
+	vst4q_f32( out, v );
+}
+
+static inline void V4_StorePackedNormals( uint32_t *out, vec4f_t x, vec4f_t y, vec4f_t z )
+{
+	const float32x4_t scale = vdupq_n_f32( 511.5f );
+	const float32x4_t bias = vdupq_n_f32( 512.0f );
+	const uint32x4_t ix = vcvtq_u32_f32( vaddq_f32( vmulq_f32( x, scale ), bias ) );
+	const uint32x4_t iy = vcvtq_u32_f32( vaddq_f32( vmulq_f32( y, scale ), bias ) );
+	const uint32x4_t iz = vcvtq_u32_f32( vaddq_f32( vmulq_f32( z, scale ), bias ) );
+
+	vst1q_u32( out, vorrq_u32( vorrq_u32( vshlq_n_u32( iz, 20 ), vshlq_n_u32( iy, 10 ) ), ix ) );
+}
+
+#endif
+
+void R_LerpFloatVertexes_simd( const float *newVerts, const float *oldVerts, int vertStride,
+	float backlerp, int numVerts, float *outXyz, uint32_t *outNormals )
+{
+	const vec4f_t front = V4_Splat( 1.0f - backlerp );
+	const vec4f_t back = V4_Splat( backlerp );
+	const vec4f_t one = V4_Splat( 1.0f );
+	int i;
+
+	for ( i = 0; i + 4 <= numVerts; i += 4 )
+	{
+		const float *newVert = newVerts + i * vertStride;
+		vec4f_t x, y, z, nx, ny, nz;
+
+		V4_LoadFloat3( newVert, vertStride, 0, &x, &y, &z );
+		V4_LoadFloat3( newVert, vertStride, 3, &nx, &ny, &nz );
+
+		if ( backlerp != 0.0f )
+		{
+			const float *oldVert = oldVerts + i * vertStride;
+			vec4f_t ox, oy, oz, onx, ony, onz;
+
+			V4_LoadFloat3( oldVert, vertStride, 0, &ox, &oy, &oz );
+			V4_LoadFloat3( oldVert, vertStride, 3, &onx, &ony, &onz );
+
+			x = V4_Add( V4_Mul( x, front ), V4_Mul( ox, back ) );
+			y = V4_Add( V4_Mul( y, front ), V4_Mul( oy, back ) );
+			z = V4_Add( V4_Mul( z, front ), V4_Mul( oz, back ) );
+
+			nx = V4_Add( V4_Mul( nx, front ), V4_Mul( onx, back ) );
+			ny = V4_Add( V4_Mul( ny, front ), V4_Mul( ony, back ) );
+			nz = V4_Add( V4_Mul( nz, front ), V4_Mul( onz, back ) );
+			V4_Normalize( &nx, &ny, &nz );
+		}
+
+		V4_StoreVec4( outXyz + i * 4, x, y, z, one );
+		V4_StorePackedNormals( outNormals + i, nx, ny, nz );
+	}
+
+	if ( i < numVerts )
+	{
+		R_LerpFloatVertexes_scalar( newVerts + i * vertStride, oldVerts ? oldVerts + i * vertStride : oldVerts,
+			vertStride, backlerp, numVerts - i, outXyz + i * 4, outNormals + i );
+	}
+}
+
+void R_LerpMD3Vertexes_simd( const short *newXyzNormals, const short *oldXyzNormals,
+	float backlerp, const float *sinTable, int numVerts, float *outXyz, float *outNormals )
+{
+	const vec4f_t newXyzScale = V4_Splat( XYZ_SCALE * (1.0 - backlerp) );
+	const vec4f_t oldXyzScale = V4_Splat( XYZ_SCALE * backlerp );
+	const vec4f_t newNormalScale = V4_Splat( 1.0 - backlerp );
+	const vec4f_t oldNormalScale = V4_Splat( backlerp );
+	const vec4f_t one = V4_Splat( 1.0f );
+	const vec4f_t zero = V4_Splat( 0.0f );
+	int i;
+
+	for ( i = 0; i + 4 <= numVerts; i += 4 )
+	{
+		const short *newVert = newXyzNormals + i * 4;
+		float normals[3][4];
+		vec4f_t x, y, z, nx, ny, nz;
+		int j;
+
+		// the normals are table lookups, so decode them one at a time
+		for ( j = 0; j < 4; j++ )
+		{
+			float normal[3];
+			R_DecodeMD3Normal( newVert[j * 4 + 3], sinTable, normal );
+			normals[0][j] = normal[0];
+			normals[1][j] = normal[1];
+			normals[2][j] = normal[2];
+		}
+		nx = V4_Load( normals[0] );
+		ny = V4_Load( normals[1] );
+		nz = V4_Load( normals[2] );
+
+		V4_LoadMD3Xyz( newVert, &x, &y, &z );
+
+		if ( backlerp == 0.0f )
+		{
+			x = V4_Mul( x, newXyzScale );
+			y = V4_Mul( y, newXyzScale );
+			z = V4_Mul( z, newXyzScale );
+		}
+		else
+		{
+			const short *oldVert = oldXyzNormals + i * 4;
+			vec4f_t ox, oy, oz, onx, ony, onz;
+
+			for ( j = 0; j < 4; j++ )
+			{
+				float normal[3];
+				R_DecodeMD3Normal( oldVert[j * 4 + 3], sinTable, normal );
+				normals[0][j] = normal[0];
+				normals[1][j] = normal[1];
+				normals[2][j] = normal[2];
+			}
+			onx = V4_Load( normals[0] );
+			ony = V4_Load( normals[1] );
+			onz = V4_Load( normals[2] );
+
+			V4_LoadMD3Xyz( oldVert, &ox, &oy, &oz );
+
+			x = V4_Add( V4_Mul( ox, oldXyzScale ), V4_Mul( x, newXyzScale ) );
+			y = V4_Add( V4_Mul( oy, oldXyzScale ), V4_Mul( y, newXyzScale ) );
+			z = V4_Add( V4_Mul( oz, oldXyzScale ), V4_Mul( z, newXyzScale ) );
+
+			nx = V4_Add( V4_Mul( onx, oldNormalScale ), V4_Mul( nx, newNormalScale ) );
+			ny = V4_Add( V4_Mul( ony, oldNormalScale ), V4_Mul( ny, newNormalScale ) );
+			nz = V4_Add( V4_Mul( onz, oldNormalScale ), V4_Mul( nz, newNormalScale ) );
+			V4_Normalize( &nx, &ny, &nz );
+		}
+
+		V4_StoreVec4( outXyz + i * 4, x, y, z, one );
+		V4_StoreVec4( outNormals + i * 4, nx, ny, nz, zero );
+	}
+
+	if ( i < numVerts )
+	{
+		R_LerpMD3Vertexes_scalar( newXyzNormals + i * 4, oldXyzNormals ? oldXyzNormals + i * 4 : oldXyzNormals,
+			backlerp, sinTable, numVerts - i, outXyz + i * 4, outNormals + i * 4 );
+	}
+}
+
+#endif // R_VERTEXLERP_SIMD
@@ -0,0 +1,70 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+// Filename:-	tr_vertexlerp.h
+//
+// Interpolation of animated mesh vertexes between two frames.
+//
+// Every function comes in a portable _scalar version and a _simd version
+// that does four vertexes at a time with SSE2 or NEON. The _simd versions
+// only exist if R_VERTEXLERP_SIMD is defined; callers pick one at runtime.
+// Both write the positions and normals of numVerts vertexes, four floats
+// apart, with the fourth component set to 1 for positions and 0 for float
+// normals.
+//
+// This file doesn't depend on anything else in the renderer, so that the
+// unit tests can compare the two versions.
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define R_VERTEXLERP_SSE2
+	#define R_VERTEXLERP_SIMD
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	#define R_VERTEXLERP_NEON
+	#define R_VERTEXLERP_SIMD
+#endif
+
+// Size of the sine table the MD3 normals are decoded with, the same as the
+// renderer's tr.sinTable.
+#define VERTEXLERP_SINTABLE_SIZE	1024
+
+// Vertexes made of floats that start with a position followed by a normal,
+// vertStride floats apart (at least 7), as in rend2's mdvVertex_t. Lerped
+// normals are renormalized, and all normals are written packed into 10 bits
+// per component like R_VboPackNormal does. oldVerts is not read if backlerp
+// is 0.
+void R_LerpFloatVertexes_scalar( const float *newVerts, const float *oldVerts, int vertStride,
+	float backlerp, int numVerts, float *outXyz, uint32_t *outNormals );
+
+// MD3 vertexes: three shorts of position scaled by MD3_XYZ_SCALE and a short
+// holding the normal as latitude and longitude bytes, looked up in sinTable.
+// Lerped normals are renormalized. oldXyzNormals is not read if backlerp is 0.
+void R_LerpMD3Vertexes_scalar( const short *newXyzNormals, const short *oldXyzNormals,
+	float backlerp, const float *sinTable, int numVerts, float *outXyz, float *outNormals );
+
+#ifdef R_VERTEXLERP_SIMD
+void R_LerpFloatVertexes_simd( const float *newVerts, const float *oldVerts, int vertStride,
+	float backlerp, int numVerts, float *outXyz, uint32_t *outNormals );
+void R_LerpMD3Vertexes_simd( const short *newXyzNormals, const short *oldXyzNormals,
+	float backlerp, const float *sinTable, int numVerts, float *outXyz, float *outNormals );
+#endif
@@ -196,6 +196,25 @@ struct SBoneCalc
 	float			blendLerp;
 };
 
+// G2API_GetBoltMatrix results, kept per bone cache until its bones are
+// transformed again
+#define G2_BOLT_CACHE_SIZE 16
+
+struct boltCache_t
+{
+	int			touch;			// mCurrentTouch when this was made, 0 for never
+	int			boltIndex;
+	int			boneNumber;		// what the bolt was on, in case it was removed
+	int			surfaceNumber;	// and its index reused since
+	bool		spMethod;
+	vec3_t		angles;
+	vec3_t		position;
+	vec3_t		scale;
+	mdxaBone_t	matrix;
+	mdxaBone_t	world;			// worldMatrix and worldMatrixInv as the call
+	mdxaBone_t	worldInv;		// left them
+};
+
 class CBoneCache;
 void G2_TransformBone(int index,CBoneCache &CB);
 
@@ -338,6 +357,8 @@ public:
 	bool			mUnsquash;
 	float			mSmoothFactor;
 
+	boltCache_t		mBoltCache[G2_BOLT_CACHE_SIZE];
+
 	CBoneCache(const model_t *amod,const mdxaHeader_t *aheader) :
 		header(aheader),
 		mod(amod)
@@ -371,6 +392,10 @@ public:
 		mLastTouch=2;
 		mLastLastTouch=1;
 //rww - RAGDOLL_END
+		for (i=0;i<G2_BOLT_CACHE_SIZE;i++)
+		{
+			mBoltCache[i].touch=0;
+		}
 	}
 
 	SBoneCalc &Root()
@@ -2799,6 +2824,83 @@ void G2_GetBoltMatrixLow(CGhoul2Info &ghoul2,int boltNum,const vec3_t scale,mdxa
 	}
 }
 
+/*
+==============
+G2_GetCachedBoltMatrix
+
+Finds the result of an earlier G2API_GetBoltMatrix with the same arguments,
+made since the bones were last transformed. Puts worldMatrix back how that
+call left it too.
+==============
+*/
+bool G2_GetCachedBoltMatrix(CGhoul2Info &ghoul2,int boltNum,const vec3_t angles,const vec3_t position,const vec3_t scale,bool spMethod,mdxaBone_t &retMatrix)
+{
+	if (!ghoul2.mBoneCache)
+	{
+		return false;
+	}
+
+	const CBoneCache &boneCache=*ghoul2.mBoneCache;
+	const boltCache_t &cached=boneCache.mBoltCache[boltNum&(G2_BOLT_CACHE_SIZE-1)];
+	const boltInfo_t &bolt=ghoul2.mBltlist[boltNum];
+
+	// compare bits, not values, so -0 doesn't stand in for 0
+	if (cached.touch!=boneCache.mCurrentTouch||
+		cached.boltIndex!=boltNum||
+		cached.boneNumber!=bolt.boneNumber||
+		cached.surfaceNumber!=bolt.surfaceNumber||
+		cached.spMethod!=spMethod||
+		memcmp(cached.angles,angles,sizeof(vec3_t))||
+		memcmp(cached.position,position,sizeof(vec3_t))||
+		memcmp(cached.scale,scale,sizeof(vec3_t)))
+	{
+		return false;
+	}
+
+	retMatrix=cached.matrix;
+	worldMatrix=cached.world;
+	worldMatrixInv=cached.worldInv;
+	return true;
+}
+
+void G2_CacheBoltMatrix(CGhoul2Info &ghoul2,int boltNum,const vec3_t angles,const vec3_t position,const vec3_t scale,bool spMethod,const mdxaBone_t &matrix)
+{
+	if (!ghoul2.mBoneCache)
+	{
+		return;
+	}
+
+	CBoneCache &boneCache=*ghoul2.mBoneCache;
+	boltCache_t &cached=boneCache.mBoltCache[boltNum&(G2_BOLT_CACHE_SIZE-1)];
+	const boltInfo_t &bolt=ghoul2.mBltlist[boltNum];
+
+	cached.touch=boneCache.mCurrentTouch;
+	cached.boltIndex=boltNum;
+	cached.boneNumber=bolt.boneNumber;
+	cached.surfaceNumber=bolt.surfaceNumber;
+	cached.spMethod=spMethod;
+	VectorCopy(angles,cached.angles);
+	VectorCopy(position,cached.position);
+	VectorCopy(scale,cached.scale);
+	cached.matrix=matrix;
+	cached.world=worldMatrix;
+	cached.worldInv=worldMatrixInv;
+}
+
+// for changes that move bolts without the bones being transformed again
+void G2_ClearBoltCache(CGhoul2Info &ghoul2)
+{
+	if (!ghoul2.mBoneCache)
+	{
+		return;
+	}
+
+	for (int i=0;i<G2_BOLT_CACHE_SIZE;i++)
+	{
+		ghoul2.mBoneCache->mBoltCache[i].touch=0;
+	}
+}
+
 static void RootMatrix(CGhoul2Info_v &ghoul2,int time,const vec3_t scale,mdxaBone_t &retMatrix)
 {
 	int i;
@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "tr_cache.h"
 #include "tr_weather.h"
+#include <algorithm>
 #include <vector>
 
 #include <cmath>
@@ -1884,6 +1885,106 @@ int R_StitchPatches( world_t *worldData, int grid1num, int grid2num ) {
 	return qfalse;
 }
 
+/*
+===============
+R_StitchHash
+
+Buckets the border vertices of every grid into a spatial hash so that a
+grid only has to be tested against grids that have a border vertex close
+enough to one of its own. R_StitchPatches can only join two grids when a
+border vertex of the first lies within STITCH_EPSILON of a border vertex of
+the second on every axis, so the hash never drops a real candidate.
+
+Buckets are never pruned. Stitching only ever adds vertices to a grid, so a
+stale entry just yields a candidate that R_StitchPatches will reject.
+===============
+*/
+#define STITCH_CELL_SIZE	32.0f
+#define STITCH_EPSILON		0.125f	// slightly wider than the .1 used by R_StitchPatches
+
+struct stitchHash_t
+{
+	std::vector<std::vector<int>> buckets;
+	unsigned int mask;
+};
+
+static unsigned int R_StitchHashCell( int x, int y, int z )
+{
+	return (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u ^ (unsigned int)z * 83492791u;
+}
+
+static void R_StitchHashAddPoint( stitchHash_t *hash, const vec3_t xyz, int surfNum )
+{
+	const int x = (int)floorf(xyz[0] / STITCH_CELL_SIZE);
+	const int y = (int)floorf(xyz[1] / STITCH_CELL_SIZE);
+	const int z = (int)floorf(xyz[2] / STITCH_CELL_SIZE);
+	std::vector<int>& bucket = hash->buckets[R_StitchHashCell(x, y, z) & hash->mask];
+
+	// border points of one grid are added in a row, so this catches most duplicates
+	if ( bucket.empty() || bucket.back() != surfNum )
+		bucket.push_back(surfNum);
+}
+
+static void R_StitchHashAddGrid( stitchHash_t *hash, const srfBspSurface_t *grid, int surfNum )
+{
+	int i;
+
+	for ( i = 0; i < grid->width; i++ ) {
+		R_StitchHashAddPoint(hash, grid->verts[i].xyz, surfNum);
+		R_StitchHashAddPoint(hash, grid->verts[(grid->height-1) * grid->width + i].xyz, surfNum);
+	}
+	for ( i = 0; i < grid->height; i++ ) {
+		R_StitchHashAddPoint(hash, grid->verts[grid->width * i].xyz, surfNum);
+		R_StitchHashAddPoint(hash, grid->verts[grid->width * i + grid->width-1].xyz, surfNum);
+	}
+}
+
+static void R_StitchHashGatherPoint( const stitchHash_t *hash, const vec3_t xyz, std::vector<int>& candidates )
+{
+	int mins[3], maxs[3];
+	int x, y, z, i;
+
+	for ( i = 0; i < 3; i++ ) {
+		mins[i] = (int)floorf((xyz[i] - STITCH_EPSILON) / STITCH_CELL_SIZE);
+		maxs[i] = (int)floorf((xyz[i] + STITCH_EPSILON) / STITCH_CELL_SIZE);
+	}
+
+	for ( x = mins[0]; x <= maxs[0]; x++ ) {
+		for ( y = mins[1]; y <= maxs[1]; y++ ) {
+			for ( z = mins[2]; z <= maxs[2]; z++ ) {
+				const std::vector<int>& bucket = hash->buckets[R_StitchHashCell(x, y, z) & hash->mask];
+				candidates.insert(candidates.end(), bucket.begin(), bucket.end());
+			}
+		}
+	}
+}
+
+/*
+===============
+R_StitchHashGatherGrid
+
+Fills candidates with the sorted, unique surface numbers of every grid
+that may share a border vertex with grid1, including grid1 itself.
+===============
+*/
+static void R_StitchHashGatherGrid( const stitchHash_t *hash, const srfBspSurface_t *grid1, std::vector<int>& candidates )
+{
+	int i;
+
+	candidates.clear();
+	for ( i = 0; i < grid1->width; i++ ) {
+		R_StitchHashGatherPoint(hash, grid1->verts[i].xyz, candidates);
+		R_StitchHashGatherPoint(hash, grid1->verts[(grid1->height-1) * grid1->width + i].xyz, candidates);
+	}
+	for ( i = 0; i < grid1->height; i++ ) {
+		R_StitchHashGatherPoint(hash, grid1->verts[grid1->width * i].xyz, candidates);
+		R_StitchHashGatherPoint(hash, grid1->verts[grid1->width * i + grid1->width-1].xyz, candidates);
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
 /*
 ===============
 R_TryStitchPatch
@@ -1895,19 +1996,23 @@ Only single missing vertice cracks will be fixed.
 Vertices will be joined at the patch side a crack is first found, at the other side
 of the patch (on the same row or column) the vertices will not be joined and cracks
 might still appear at that side.
+
+Candidates are visited in ascending surface order, the same order the full
+surface walk used, so the stitching result is unchanged.
 ===============
 */
-int R_TryStitchingPatch( world_t *worldData, int grid1num ) {
-	int j, numstitches;
+int R_TryStitchingPatch( world_t *worldData, stitchHash_t *hash, int grid1num ) {
+	int j, c, numstitches, gridstitches;
 	srfBspSurface_t *grid1, *grid2;
+	std::vector<int> candidates;
 
 	numstitches = 0;
 	grid1 = (srfBspSurface_t *) worldData->surfaces[grid1num].data;
-	for ( j = 0; j < worldData->numsurfaces; j++ ) {
+	R_StitchHashGatherGrid(hash, grid1, candidates);
+	for ( c = 0; c < (int)candidates.size(); c++ ) {
 		//
+		j = candidates[c];
 		grid2 = (srfBspSurface_t *) worldData->surfaces[j].data;
-		// if this surface is not a grid
-		if ( grid2->surfaceType != SF_GRID ) continue;
 		// grids in the same LOD group should have the exact same lod radius
 		if ( grid1->lodRadius != grid2->lodRadius ) continue;
 		// grids in the same LOD group should have the exact same lod origin
@@ -1915,9 +2020,23 @@ int R_TryStitchingPatch( world_t *worldData, int grid1num ) {
 		if ( grid1->lodOrigin[1] != grid2->lodOrigin[1] ) continue;
 		if ( grid1->lodOrigin[2] != grid2->lodOrigin[2] ) continue;
 		//
+		gridstitches = 0;
 		while (R_StitchPatches(worldData, grid1num, j))
 		{
-			numstitches++;
+			gridstitches++;
+		}
+		if ( !gridstitches )
+			continue;
+		numstitches += gridstitches;
+
+		// grid2 got new border vertices
+		R_StitchHashAddGrid(hash, (srfBspSurface_t *) worldData->surfaces[j].data, j);
+		if ( j == grid1num ) {
+			// grid1 itself changed, so the grids after it have to be matched
+			// against its new border
+			grid1 = (srfBspSurface_t *) worldData->surfaces[grid1num].data;
+			R_StitchHashGatherGrid(hash, grid1, candidates);
+			c = std::upper_bound(candidates.begin(), candidates.end(), j) - candidates.begin() - 1;
 		}
 	}
 	return numstitches;
@@ -1929,8 +2048,30 @@ R_StitchAllPatches
 ===============
 */
 void R_StitchAllPatches( world_t *worldData ) {
-	int i, stitched, numstitches;
+	int i, stitched, numstitches, numgridverts;
 	srfBspSurface_t *grid1;
+	stitchHash_t hash;
+
+	numgridverts = 0;
+	for ( i = 0; i < worldData->numsurfaces; i++ ) {
+		grid1 = (srfBspSurface_t *) worldData->surfaces[i].data;
+		if ( grid1->surfaceType != SF_GRID )
+			continue;
+		numgridverts += 2 * (grid1->width + grid1->height);
+	}
+
+	hash.mask = 1;
+	while ( hash.mask < (unsigned int)numgridverts )
+		hash.mask <<= 1;
+	hash.buckets.resize(hash.mask);
+	hash.mask--;
+
+	for ( i = 0; i < worldData->numsurfaces; i++ ) {
+		grid1 = (srfBspSurface_t *) worldData->surfaces[i].data;
+		if ( grid1->surfaceType != SF_GRID )
+			continue;
+		R_StitchHashAddGrid(&hash, grid1, i);
+	}
 
 	numstitches = 0;
 	do
@@ -1949,7 +2090,7 @@ void R_StitchAllPatches( world_t *worldData ) {
 			grid1->lodStitched = qtrue;
 			stitched = qtrue;
 			//
-			numstitches += R_TryStitchingPatch( worldData, i );
+			numstitches += R_TryStitchingPatch( worldData, &hash, i );
 		}
 	}
 	while (stitched);
@@ -2040,6 +2181,32 @@ static int BSPSurfaceCompare(const void *a, const void *b)
 R_CreateWorldVBOs
 ===============
 */
+struct worldTangentJob_t
+{
+	msurface_t **surfaces;
+	packedVertex_t *verts;
+	glIndex_t *indexes;
+};
+
+/*
+===============
+R_CalcWorldSurfaceTangents
+
+Surfaces of a world VBO never share vertices, so each one can get its
+tangents on a separate thread.
+===============
+*/
+static void R_CalcWorldSurfaceTangents( void *data, int index )
+{
+	worldTangentJob_t *job = (worldTangentJob_t *)data;
+	srfBspSurface_t *bspSurf = (srfBspSurface_t *)job->surfaces[index]->data;
+
+	R_CalcMikkTSpaceBSPSurface(
+		bspSurf->numIndexes / 3,
+		job->verts,
+		job->indexes + bspSurf->firstIndex);
+}
+
 static void R_CreateWorldVBOs( world_t *worldData )
 {
 	int             i, j, k;
@@ -2226,7 +2393,29 @@ static void R_CreateWorldVBOs( world_t *worldData )
 			}
 		}
 
-		R_CalcMikkTSpaceBSPSurface(numIndexes/3, verts, indexes);
+		// generate the tangents of this VBO, or reuse them from an earlier load
+		uint32_t checksum = R_TangentCacheChecksum(verts, sizeof(*verts) * numVerts, worldData->checksum);
+		checksum = R_TangentCacheChecksum(indexes, sizeof(*indexes) * numIndexes, checksum);
+
+		uint32_t *tangents = (uint32_t *)ri.Hunk_AllocateTempMemory(sizeof(*tangents) * numVerts);
+		if (R_LoadCachedTangents(worldData->name, k, checksum, tangents, numVerts))
+		{
+			for (i = 0; i < numVerts; i++)
+				verts[i].tangent = tangents[i];
+		}
+		else
+		{
+			worldTangentJob_t tangentJob;
+			tangentJob.surfaces = firstSurf;
+			tangentJob.verts = verts;
+			tangentJob.indexes = indexes;
+			R_ParallelFor(numSurfaces, R_CalcWorldSurfaceTangents, &tangentJob);
+
+			for (i = 0; i < numVerts; i++)
+				tangents[i] = verts[i].tangent;
+			R_SaveCachedTangents(worldData->name, k, checksum, tangents, numVerts);
+		}
+		ri.Hunk_FreeTempMemory(tangents);
 
 		vbo = R_CreateVBO((byte *)verts, sizeof (packedVertex_t) * numVerts, VBO_USAGE_STATIC);
 		ibo = R_CreateIBO((byte *)indexes, numIndexes * sizeof (glIndex_t), VBO_USAGE_STATIC);
@@ -2619,6 +2808,9 @@ static	void R_LoadShaders( world_t *worldData, lump_t *l ) {
 		out[i].surfaceFlags = LittleLong( out[i].surfaceFlags );
 		out[i].contentFlags = LittleLong( out[i].contentFlags );
 	}
+
+	// start decoding the images while the rest of the map loads
+	R_PrefetchShaderImages( out, count );
 }
 
 
@@ -4221,7 +4413,7 @@ world_t *R_LoadBSP(const char *name, int *bspIndex)
 	}
 
 	// load it
-    ri.FS_ReadFile(name, &buffer.v);
+	const long fileSize = ri.FS_ReadFile(name, &buffer.v);
 	if (!buffer.b)
 	{
 		if (bspIndex == nullptr)
@@ -4234,6 +4426,7 @@ world_t *R_LoadBSP(const char *name, int *bspIndex)
 
 	Com_Memset(worldData, 0, sizeof(*worldData));
 	Q_strncpyz(worldData->name, name, sizeof(worldData->name));
+	worldData->checksum = R_TangentCacheChecksum(buffer.b, fileSize, 0);
 	Q_strncpyz(worldData->baseName, COM_SkipPath(worldData->name), sizeof(worldData->name));
 	COM_StripExtension(worldData->baseName, worldData->baseName, sizeof(worldData->baseName));
 
@@ -548,6 +548,9 @@ void RE_BeginFrame( stereoFrame_t stereoFrame ) {
 		if (thisFrame->screenshotReadback.pbo > 0)
 			R_SaveScreenshot(&thisFrame->screenshotReadback);
 
+		if (thisFrame->videoReadback.pending)
+			R_QueueVideoReadback(&thisFrame->videoReadback);
+
 		// Resets resources
 		qglBindBuffer(GL_UNIFORM_BUFFER, thisFrame->ubo);
 		glState.currentGlobalUBO = thisFrame->ubo;
@@ -562,6 +565,12 @@ void RE_BeginFrame( stereoFrame_t stereoFrame ) {
 		backEndData->perFrameMemory->Reset();
 	}
 
+	// write out screenshots the capture thread is done with
+	R_PollCaptureJobs();
+
+	// and the image cache entries the GPU has read back
+	R_UpdateImageCacheSaves();
+
 	tr.frameCount++;
 	tr.frameSceneNum = 0;
 
@@ -798,8 +807,7 @@ void RE_EndFrame( int *frontEndMsec, int *backEndMsec ) {
 RE_TakeVideoFrame
 =============
 */
-void RE_TakeVideoFrame( int width, int height,
-		byte *captureBuffer, byte *encodeBuffer, qboolean motionJpeg )
+void RE_TakeVideoFrame( int width, int height, qboolean motionJpeg )
 {
 	videoFrameCommand_t	*cmd;
 
@@ -816,7 +824,5 @@ void RE_TakeVideoFrame( int width, int height,
 
 	cmd->width = width;
 	cmd->height = height;
-	cmd->captureBuffer = captureBuffer;
-	cmd->encodeBuffer = encodeBuffer;
 	cmd->motionJpeg = motionJpeg;
 }
@@ -3702,6 +3702,31 @@ void RB_SurfaceGhoul( CRenderableSurface *surf )
 	glState.skeletalAnimation = qtrue;
 }
 
+struct glmTangentJob_t
+{
+	mdxmSurface_t **surfaces;
+	glIndex_t *indices;
+	uint32_t *tangents;
+	const int *baseVertexes;
+	const int *indexOffsets;
+};
+
+static void R_CalcGlmSurfaceTangents( void *data, int index )
+{
+	glmTangentJob_t *job = (glmTangentJob_t *)data;
+	mdxmSurface_t *surf = job->surfaces[index];
+	mdxmVertex_t *vertices = (mdxmVertex_t *)((byte *)surf + surf->ofsVerts);
+	mdxmVertexTexCoord_t *textureCoordinates = (mdxmVertexTexCoord_t *)(vertices + surf->numVerts);
+
+	R_CalcMikkTSpaceGlmSurface(
+		surf->numTriangles,
+		vertices,
+		textureCoordinates,
+		job->tangents + job->baseVertexes[index],
+		job->indices + job->indexOffsets[index]
+	);
+}
+
 /*
 =================
 R_LoadMDXM - load a Ghoul 2 Mesh file
@@ -4332,18 +4357,24 @@ qboolean R_LoadMDXM(model_t *mod, void *buffer, const char *mod_name, qboolean &
 		tangents = (uint32_t *)(data + ofsTangents);
 		stride += sizeof (*tangents);
 
-		// Fill in the index buffer and compute tangents
+		// Fill in the index buffer
 		glIndex_t *indices = (glIndex_t *)ri.Hunk_AllocateTempMemory(sizeof(glIndex_t) * numTriangles * 3);
 		glIndex_t *index = indices;
 		uint32_t *tangentsf = (uint32_t *)ri.Hunk_AllocateTempMemory(sizeof(uint32_t) * numVerts);
+		glIndex_t *surfIndices = (glIndex_t *)ri.Hunk_AllocateTempMemory(sizeof(glIndex_t) * numTriangles * 3);
+		glIndex_t *surf_index = surfIndices;
+		mdxmSurface_t **surfaces = (mdxmSurface_t **)ri.Hunk_AllocateTempMemory(sizeof(*surfaces) * mdxm->numSurfaces);
+		uint32_t checksum = 0;
 
 		surf = (mdxmSurface_t *)((byte *)lod + sizeof(mdxmLOD_t) + (mdxm->numSurfaces * sizeof(mdxmLODSurfOffset_t)));
 
 		for (int n = 0; n < mdxm->numSurfaces; n++)
 		{
 			mdxmTriangle_t *t = (mdxmTriangle_t *)((byte *)surf + surf->ofsTriangles);
-			glIndex_t *surf_indices = (glIndex_t *)ri.Hunk_AllocateTempMemory(sizeof(glIndex_t) * surf->numTriangles * 3);
-			glIndex_t *surf_index = surf_indices;
+			mdxmVertex_t *vertices = (mdxmVertex_t *)((byte *)surf + surf->ofsVerts);
+			mdxmVertexTexCoord_t *textureCoordinates = (mdxmVertexTexCoord_t *)(vertices + surf->numVerts);
+
+			surfaces[n] = surf;
 
 			for (int k = 0; k < surf->numTriangles; k++, index += 3, surf_index += 3)
 			{
@@ -4361,23 +4392,30 @@ qboolean R_LoadMDXM(model_t *mod, void *buffer, const char *mod_name, qboolean &
 				surf_index[2] = t[k].indexes[2];
 			}
 
-			// Build tangent space
-			mdxmVertex_t *vertices = (mdxmVertex_t *)((byte *)surf + surf->ofsVerts);
-			mdxmVertexTexCoord_t *textureCoordinates = (mdxmVertexTexCoord_t *)(vertices + surf->numVerts);
-
-			R_CalcMikkTSpaceGlmSurface(
-				surf->numTriangles,
-				vertices,
-				textureCoordinates,
-				tangentsf + baseVertexes[n],
-				surf_indices
-			);
-
-			ri.Hunk_FreeTempMemory(surf_indices);
+			checksum = R_TangentCacheChecksum(vertices, sizeof(*vertices) * surf->numVerts, checksum);
+			checksum = R_TangentCacheChecksum(textureCoordinates, sizeof(*textureCoordinates) * surf->numVerts, checksum);
+			checksum = R_TangentCacheChecksum(t, sizeof(*t) * surf->numTriangles, checksum);
 
 			surf = (mdxmSurface_t *)((byte *)surf + surf->ofsEnd);
 		}
 
+		// Build tangent space, or reuse it from an earlier load
+		if (!R_LoadCachedTangents(mod_name, l, checksum, tangentsf, numVerts))
+		{
+			glmTangentJob_t tangentJob;
+			tangentJob.surfaces = surfaces;
+			tangentJob.indices = surfIndices;
+			tangentJob.tangents = tangentsf;
+			tangentJob.baseVertexes = baseVertexes;
+			tangentJob.indexOffsets = indexOffsets;
+			R_ParallelFor(mdxm->numSurfaces, R_CalcGlmSurfaceTangents, &tangentJob);
+
+			R_SaveCachedTangents(mod_name, l, checksum, tangentsf, numVerts);
+		}
+
+		ri.Hunk_FreeTempMemory(surfaces);
+		ri.Hunk_FreeTempMemory(surfIndices);
+
 		assert(index == (indices + numTriangles * 3));
 
 		surf = (mdxmSurface_t *)((byte *)lod + sizeof (mdxmLOD_t) + (mdxm->numSurfaces * sizeof (mdxmLODSurfOffset_t)));
@@ -4460,9 +4498,9 @@ qboolean R_LoadMDXM(model_t *mod, void *buffer, const char *mod_name, qboolean &
 		VBO_t *vbo = R_CreateVBO (data, dataSize, VBO_USAGE_STATIC);
 		IBO_t *ibo = R_CreateIBO((byte *)indices, sizeof(glIndex_t) * numTriangles * 3, VBO_USAGE_STATIC);
 
-		ri.Hunk_FreeTempMemory (data);
 		ri.Hunk_FreeTempMemory (tangentsf);
 		ri.Hunk_FreeTempMemory (indices);
+		ri.Hunk_FreeTempMemory (data);
 
 		vbo->offsets[ATTR_INDEX_POSITION] = ofsPosition;
 		vbo->offsets[ATTR_INDEX_NORMAL] = ofsNormals;
@@ -23,6 +23,15 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "tr_local.h"
 #include "glext.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 static byte			 s_intensitytable[256];
 static unsigned char s_gammatable[256];
 
@@ -2080,229 +2089,1031 @@ static bool IsPowerOfTwo ( int i )
 	return (i & (i - 1)) == 0;
 }
 
+static void RawImage_SetFilter( int flags )
+{
+	if (flags & IMGFLAG_MIPMAP)
+	{
+		if (r_ext_texture_filter_anisotropic->value > 1.0f && glConfig.maxTextureFilterAnisotropy > 0.0f)
+		{
+			qglTexParameterf ( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+							  Com_Clamp( 1.0f, glConfig.maxTextureFilterAnisotropy, r_ext_texture_filter_anisotropic->value ) );
+		}
+
+		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, gl_filter_min);
+		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, gl_filter_max);
+	}
+	else
+	{
+		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	}
+}
+
 /*
 ===============
-Upload32
-
+Processed image cache
+
+Mipmapped images go through a fair amount of CPU work before they reach
+the driver: decoding, resampling and FCBI upsampling to a power of two,
+normal map swizzling, light scaling and building the mip chain, which the
+driver may then compress. Once an image is created, every level of the
+finished texture is read back and written to imagecache/, compressed if
+the driver compressed it. The readbacks go through pixel buffers a few
+images a frame, so that loading doesn't wait for the GPU. Entries are named after the source file (its
+path, length and FS_FileStamp), the image type and flags, and every cvar
+that changes the result, so a later load finds its entry without reading
+the source file and only has to upload it.
+
+imagecache/index.dat records the size and last use of every entry. When
+the entries add up to more than r_imageCacheSize megabytes, the least
+recently used ones are deleted. Files the index doesn't know about, such
+as those of an older cache version, are deleted when it is first loaded.
 ===============
 */
-extern qboolean charSet;
-static void Upload32( byte *data, int width, int height, imgType_t type, int flags,
-	qboolean lightMap, GLenum internalFormat, int *pUploadWidth, int *pUploadHeight)
+#define IMAGE_CACHE_IDENT			(('G'<<24)+('M'<<16)+('I'<<8)+'R')
+#define IMAGE_CACHE_INDEX_IDENT		(('X'<<24)+('D'<<16)+('N'<<8)+'I')
+#define IMAGE_CACHE_VERSION			2
+#define IMAGE_CACHE_MAX_LEVELS		16
+#define IMAGE_CACHE_INDEX_PATH		"imagecache/index.dat"
+
+// followed by numLevels of an int size and that many bytes of texels
+typedef struct imageCacheHeader_s
 {
-	byte		*scaledBuffer = NULL;
-	byte		*resampledBuffer = NULL;
-	int			scaled_width = width;
-	int			scaled_height = height;
-	int			i, c;
-	byte		*scan;
+	int			ident;
+	int			version;
+	uint32_t	key[2];
+	int			width;				// of the source image
+	int			height;
+	int			uploadWidth;
+	int			uploadHeight;
+	int			internalFormat;
+	int			compressed;
+	int			numLevels;
+} imageCacheHeader_t;
+
+typedef struct imageCacheIndexHeader_s
+{
+	int			ident;
+	int			version;
+	int			useCounter;
+	int			numEntries;
+} imageCacheIndexHeader_t;
 
-	if ( !IsPowerOfTwo (width) || !IsPowerOfTwo (height) )
+typedef struct imageCacheIndexEntry_s
+{
+	uint32_t	key[2];
+	uint32_t	source[2];
+	int			size;
+	int			lastUse;
+} imageCacheIndexEntry_t;
+
+typedef uint64_t imageCacheKey_t;
+
+// what the cached texels were made from the source file as
+typedef enum
+{
+	IMAGECACHE_IMAGE,				// R_FindImageFile
+	IMAGECACHE_PACKED_MATERIAL,		// R_LoadPackedMaterialImage
+	IMAGECACHE_SDR_SPECULAR,		// R_BuildSDRSpecGlossImage
+} imageCacheVariant_t;
+
+typedef struct imageCacheEntry_s
+{
+	imageCacheKey_t	source;
+	int				size;
+	int				lastUse;
+} imageCacheEntry_t;
+
+static struct
+{
+	qboolean	loaded;
+	qboolean	dirty;
+	int			useCounter;
+	size_t		totalSize;
+
+	std::unordered_map<imageCacheKey_t, imageCacheEntry_t>	entries;
+	std::unordered_map<imageCacheKey_t, int>				sources;	// number of entries made from each
+} imageCache;
+
+static imageCacheKey_t R_ImageCacheHash( const void *data, size_t size, imageCacheKey_t hash )
+{
+	const byte *bytes = (const byte *)data;
+
+	for ( size_t i = 0; i < size; i++ )
 	{
-		RawImage_ScaleToPower2(&data, &width, &height, &scaled_width, &scaled_height, type, flags, &resampledBuffer);
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
 	}
 
-	scaledBuffer = (byte *)ri.Hunk_AllocateTempMemory( sizeof( unsigned ) * scaled_width * scaled_height );
+	return hash;
+}
 
-	//
-	// scan the texture for each channel's max values
-	// and verify if the alpha channel is being used or not
-	//
-	c = width*height;
-	scan = data;
+static void R_ImageCachePath( char *path, int pathSize, imageCacheKey_t key )
+{
+	Com_sprintf(path, pathSize, "imagecache/%08x%08x.img", (uint32_t)(key >> 32), (uint32_t)key);
+}
 
-	if( r_greyscale->integer )
+static void R_RemoveImageCacheEntry( imageCacheKey_t key, qboolean deleteFile );
+
+static void R_AddImageCacheEntry( imageCacheKey_t key, imageCacheKey_t source, int size, int lastUse )
+{
+	R_RemoveImageCacheEntry(key, qfalse);
+
+	imageCacheEntry_t& entry = imageCache.entries[key];
+	entry.source = source;
+	entry.size = size;
+	entry.lastUse = lastUse;
+
+	imageCache.sources[source]++;
+	imageCache.totalSize += size;
+}
+
+static void R_RemoveImageCacheEntry( imageCacheKey_t key, qboolean deleteFile )
+{
+	auto it = imageCache.entries.find(key);
+	if ( it == imageCache.entries.end() )
+		return;
+
+	auto source = imageCache.sources.find(it->second.source);
+	if ( --source->second == 0 )
+		imageCache.sources.erase(source);
+
+	imageCache.totalSize -= it->second.size;
+	imageCache.entries.erase(it);
+	imageCache.dirty = qtrue;
+
+	if ( deleteFile )
 	{
-		for ( i = 0; i < c; i++ )
-		{
-			byte luma = LUMA(scan[i*4], scan[i*4 + 1], scan[i*4 + 2]);
-			scan[i*4] = luma;
-			scan[i*4 + 1] = luma;
-			scan[i*4 + 2] = luma;
-		}
+		char path[MAX_QPATH];
+
+		R_ImageCachePath(path, sizeof(path), key);
+		ri.FS_HomeRemove(path);
 	}
-	else if( r_greyscale->value )
+}
+
+/*
+===============
+R_LoadImageCacheIndex
+
+Reads the index the first time the cache is used, and deletes entry files
+that are missing from it.
+===============
+*/
+static void R_LoadImageCacheIndex( void )
+{
+	union {
+		imageCacheIndexHeader_t *h;
+		void *v;
+	} buffer;
+
+	if ( imageCache.loaded )
+		return;
+
+	imageCache.loaded = qtrue;
+
+	const long fileSize = ri.FS_ReadFile(IMAGE_CACHE_INDEX_PATH, &buffer.v);
+	if ( buffer.h )
 	{
-		for ( i = 0; i < c; i++ )
+		const imageCacheIndexHeader_t *header = buffer.h;
+		const int numEntries = fileSize >= (long)sizeof(*header) ? LittleLong(header->numEntries) : -1;
+
+		if ( numEntries >= 0 &&
+			LittleLong(header->ident) == IMAGE_CACHE_INDEX_IDENT &&
+			LittleLong(header->version) == IMAGE_CACHE_VERSION &&
+			fileSize == (long)(sizeof(*header) + numEntries * sizeof(imageCacheIndexEntry_t)) )
 		{
-			float luma = LUMA(scan[i*4], scan[i*4 + 1], scan[i*4 + 2]);
-			scan[i*4] = LERP(scan[i*4], luma, r_greyscale->value);
-			scan[i*4 + 1] = LERP(scan[i*4 + 1], luma, r_greyscale->value);
-			scan[i*4 + 2] = LERP(scan[i*4 + 2], luma, r_greyscale->value);
+			const imageCacheIndexEntry_t *in = (const imageCacheIndexEntry_t *)(header + 1);
+
+			imageCache.useCounter = LittleLong(header->useCounter);
+			for ( int i = 0; i < numEntries; i++, in++ )
+			{
+				const imageCacheKey_t key = ((imageCacheKey_t)(uint32_t)LittleLong(in->key[0]) << 32) | (uint32_t)LittleLong(in->key[1]);
+				const imageCacheKey_t source = ((imageCacheKey_t)(uint32_t)LittleLong(in->source[0]) << 32) | (uint32_t)LittleLong(in->source[1]);
+
+				R_AddImageCacheEntry(key, source, LittleLong(in->size), LittleLong(in->lastUse));
+			}
 		}
-	}
 
-	// normals are always swizzled
-	if (type == IMGTYPE_NORMAL || type == IMGTYPE_NORMALHEIGHT)
-	{
-		RawImage_SwizzleRA(data, width, height);
+		ri.FS_FreeFile(buffer.v);
 	}
 
-	// LATC2 is only used for normals
-	if (internalFormat == GL_COMPRESSED_LUMINANCE_ALPHA_LATC2_EXT)
+	// drop what is on one side only: files left by an older version of the
+	// cache or by a crash before the index was saved, and index entries
+	// whose file was deleted
+	int numFiles = 0;
+	char **files = ri.FS_ListFiles("imagecache", ".img", &numFiles);
+	std::unordered_set<imageCacheKey_t> onDisk;
+
+	for ( int i = 0; i < numFiles; i++ )
 	{
-		byte *in = data;
-		int c = width * height;
-		while (c--)
+		char *end;
+		const imageCacheKey_t key = strtoull(files[i], &end, 16);
+
+		if ( end == files[i] + 16 && !Q_stricmp(end, ".img") && imageCache.entries.count(key) )
 		{
-			in[0] = in[1];
-			in[2] = in[1];
-			in += 4;
+			onDisk.insert(key);
 		}
-	}
-
-	// copy or resample data as appropriate for first MIP level
-	if ( ( scaled_width == width ) &&
-		( scaled_height == height ) ) {
-		if (!(flags & IMGFLAG_MIPMAP))
+		else
 		{
-			RawImage_UploadTexture( data, 0, 0, scaled_width, scaled_height, internalFormat, type, flags, qfalse );
-			//qglTexImage2D (GL_TEXTURE_2D, 0, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-			*pUploadWidth = scaled_width;
-			*pUploadHeight = scaled_height;
-
-			goto done;
+			ri.FS_HomeRemove(va("imagecache/%s", files[i]));
 		}
-		Com_Memcpy (scaledBuffer, data, width*height*4);
 	}
-	else if ( !r_simpleMipMaps->integer )
-	{
-		// use the normal mip-mapping function to go down from here
-		while ( width > scaled_width || height > scaled_height ) {
+	ri.FS_FreeFileList(files);
 
-			if (flags & IMGFLAG_SRGB)
-			{
-				R_MipMapsRGB( (byte *)data, width, height );
-			}
-			else
-			{
-				R_MipMap( (byte *)data, width, height );
-			}
+	for ( auto it = imageCache.entries.begin(); it != imageCache.entries.end(); )
+	{
+		const imageCacheKey_t key = (it++)->first;
 
-			width >>= 1;
-			height >>= 1;
-			if ( width < 1 ) {
-				width = 1;
-			}
-			if ( height < 1 ) {
-				height = 1;
-			}
-		}
-		Com_Memcpy( scaledBuffer, data, width * height * 4 );
+		if ( !onDisk.count(key) )
+			R_RemoveImageCacheEntry(key, qfalse);
 	}
+}
 
-	if (!(flags & IMGFLAG_NOLIGHTSCALE))
-		R_LightScaleTexture (scaledBuffer, scaled_width, scaled_height, (qboolean)(!(flags & IMGFLAG_MIPMAP)) );
-
-	*pUploadWidth = scaled_width;
-	*pUploadHeight = scaled_height;
-
-	RawImage_UploadTexture(scaledBuffer, 0, 0, scaled_width, scaled_height, internalFormat, type, flags, qfalse);
+/*
+===============
+R_SaveImageCacheIndex
+===============
+*/
+void R_SaveImageCacheIndex( void )
+{
+	if ( !imageCache.dirty )
+		return;
 
-done:
+	const int numEntries = (int)imageCache.entries.size();
+	const int fileSize = sizeof(imageCacheIndexHeader_t) + numEntries * sizeof(imageCacheIndexEntry_t);
+	byte *buffer = (byte *)ri.Hunk_AllocateTempMemory(fileSize);
+	imageCacheIndexHeader_t *header = (imageCacheIndexHeader_t *)buffer;
+	imageCacheIndexEntry_t *out = (imageCacheIndexEntry_t *)(header + 1);
 
-	if (flags & IMGFLAG_MIPMAP)
-	{
-		if (r_ext_texture_filter_anisotropic->value > 1.0f && glConfig.maxTextureFilterAnisotropy > 0.0f)
-		{
-			qglTexParameterf ( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
-							  Com_Clamp( 1.0f, glConfig.maxTextureFilterAnisotropy, r_ext_texture_filter_anisotropic->value ) );
-		}
+	header->ident = LittleLong(IMAGE_CACHE_INDEX_IDENT);
+	header->version = LittleLong(IMAGE_CACHE_VERSION);
+	header->useCounter = LittleLong(imageCache.useCounter);
+	header->numEntries = LittleLong(numEntries);
 
-		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, gl_filter_min);
-		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, gl_filter_max);
-	}
-	else
+	for ( const auto& it : imageCache.entries )
 	{
-		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		out->key[0] = LittleLong((uint32_t)(it.first >> 32));
+		out->key[1] = LittleLong((uint32_t)it.first);
+		out->source[0] = LittleLong((uint32_t)(it.second.source >> 32));
+		out->source[1] = LittleLong((uint32_t)it.second.source);
+		out->size = LittleLong(it.second.size);
+		out->lastUse = LittleLong(it.second.lastUse);
+		out++;
 	}
 
-	GL_CheckErrors();
+	ri.FS_WriteFile(IMAGE_CACHE_INDEX_PATH, buffer, fileSize);
+	ri.Hunk_FreeTempMemory(buffer);
 
-	if ( scaledBuffer != 0 )
-		ri.Hunk_FreeTempMemory( scaledBuffer );
-	if ( resampledBuffer != 0 )
-		ri.Hunk_FreeTempMemory( resampledBuffer );
+	imageCache.dirty = qfalse;
 }
 
+/*
+===============
+R_EvictImageCache
 
-static void EmptyTexture( int width, int height, imgType_t type, int flags,
-	qboolean lightMap, GLenum internalFormat, int *pUploadWidth, int *pUploadHeight )
+Deletes the least recently used entries until the cache fits in
+r_imageCacheSize, with some room to spare so the next few entries don't
+each have to evict again.
+===============
+*/
+static void R_EvictImageCache( void )
 {
-	int			scaled_width, scaled_height;
-
-	RawImage_ScaleToPower2(NULL, &width, &height, &scaled_width, &scaled_height, type, flags, NULL);
-
-	*pUploadWidth = scaled_width;
-	*pUploadHeight = scaled_height;
+	const size_t maxSize = (size_t)Q_max(0, r_imageCacheSize->integer) * 1024 * 1024;
 
-	RawImage_UploadTexture(NULL, 0, 0, scaled_width, scaled_height, internalFormat, type, flags, qfalse);
-
-	if (flags & IMGFLAG_MIPMAP)
-	{
-		if (r_ext_texture_filter_anisotropic->integer > 1 && glConfig.maxTextureFilterAnisotropy > 0.0f)
-		{
-			qglTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
-					(GLint)Com_Clamp( 1, glConfig.maxTextureFilterAnisotropy, r_ext_texture_filter_anisotropic->integer ) );
-		}
+	if ( imageCache.totalSize <= maxSize )
+		return;
 
-		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, gl_filter_min);
-		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, gl_filter_max);
-	}
-	else
+	std::vector<std::pair<int, imageCacheKey_t>> byLastUse;
+	byLastUse.reserve(imageCache.entries.size());
+	for ( const auto& it : imageCache.entries )
 	{
-		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		byLastUse.emplace_back(it.second.lastUse, it.first);
 	}
+	std::sort(byLastUse.begin(), byLastUse.end());
 
-	// Fix for sampling depth buffer on old nVidia cards
-	// from http://www.idevgames.com/forums/thread-4141-post-34844.html#pid34844
-	switch(internalFormat)
+	const size_t targetSize = maxSize - maxSize / 8;
+	for ( const auto& it : byLastUse )
 	{
-		case GL_DEPTH_COMPONENT:
-		case GL_DEPTH_COMPONENT16:
-		case GL_DEPTH_COMPONENT24:
-		case GL_DEPTH_COMPONENT32:
-			//qglTexParameterf(GL_TEXTURE_2D, GL_DEPTH_TEXTURE_MODE, GL_LUMINANCE );
-			qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-			qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
-			break;
-		default:
+		if ( imageCache.totalSize <= targetSize )
 			break;
-	}
 
-	GL_CheckErrors();
+		R_RemoveImageCacheEntry(it.second, qtrue);
+	}
 }
 
-static image_t *R_AllocImage()
+static imageCacheKey_t R_ImageCacheSourceKey( const char *filename, long length, int stamp )
 {
-	image_t *result;
+	imageCacheKey_t key = 14695981039346656037ull;
+	key = R_ImageCacheHash(filename, strlen(filename), key);
+	key = R_ImageCacheHash(&length, sizeof(length), key);
+	key = R_ImageCacheHash(&stamp, sizeof(stamp), key);
 
-	if ( !tr.imagesFreeList )
-	{
-		R_ExtendImagesPool();
-	}
+	// 0 means "don't cache"
+	return key ? key : 1;
+}
 
-	// Remove from free list
-	result = tr.imagesFreeList;
-	tr.imagesFreeList = tr.imagesFreeList->poolNext;
+/*
+===============
+R_ImageCacheSource
 
-	// Add to list of used images
-	result->poolNext = tr.images;
-	tr.images = result;
+Identifies the file R_LoadImage would load for name without reading it.
+Returns 0 if there is none or the cache is off.
+===============
+*/
+static imageCacheKey_t R_ImageCacheSource( const char *name )
+{
+	char filename[MAX_QPATH];
+	int stamp = 0;
 
-	tr.numImages++;
+	if ( !r_imageCache->integer || r_imageCacheSize->integer <= 0 || !name[0] || name[0] == '*' )
+		return 0;
 
-	return result;
+	const long length = R_FindImageSource(name, filename, sizeof(filename), &stamp);
+	if ( length <= 0 )
+		return 0;
+
+	return R_ImageCacheSourceKey(filename, length, stamp);
 }
 
-#if 0
-static void R_FreeImage( image_t *imageToFree )
-{
-	if ( imageToFree )
-	{
-		// Images aren't deleted individually very often. Not a
+/*
+===============
+R_ImageCacheDecoded
+
+Returns key if R_LoadImageFile decoded the file that source was made from.
+Otherwise that file exists but didn't decode, and the image isn't cached,
+since the lookup would keep finding the file that failed.
+===============
+*/
+static imageCacheKey_t R_ImageCacheDecoded( imageCacheKey_t key, imageCacheKey_t source, const char *filename )
+{
+	int stamp = 0;
+
+	if ( !key || !filename[0] )
+		return 0;
+
+	const long length = ri.FS_FileStamp(filename, &stamp);
+	if ( length <= 0 || R_ImageCacheSourceKey(filename, length, stamp) != source )
+		return 0;
+
+	return key;
+}
+
+/*
+===============
+R_ImageCacheHasSource
+
+Returns qtrue if some entry was made from source, in which case it is
+probably not worth decoding ahead.
+===============
+*/
+static qboolean R_ImageCacheHasSource( imageCacheKey_t source )
+{
+	if ( !source )
+		return qfalse;
+
+	R_LoadImageCacheIndex();
+
+	return (qboolean)(imageCache.sources.count(source) != 0);
+}
+
+/*
+===============
+R_ImageCacheKey
+
+Returns 0 if the image should not be cached.
+===============
+*/
+static imageCacheKey_t R_ImageCacheKey( imageCacheKey_t source, imgType_t type, int flags, imageCacheVariant_t variant )
+{
+	if ( !source )
+		return 0;
+
+	// only mipmapped images get processed enough to be worth it
+	if ( !(flags & IMGFLAG_MIPMAP) || (flags & IMGFLAG_CUBEMAP) )
+		return 0;
+
+	struct {
+		int variant;
+		int type, flags;
+		int picmip, roundImagesDown;
+		int imageUpsample, imageUpsampleMaxSize;
+		int simpleMipMaps, colorMipLevels;
+		float greyscale;
+		int maxTextureSize;
+		int deviceSupportsGamma;
+		int textureCompression;
+		int textureBits;
+	} params;
+
+	Com_Memset(&params, 0, sizeof(params));
+	params.variant = variant;
+	params.type = type;
+	params.flags = flags;
+	params.picmip = r_picmip->integer;
+	params.roundImagesDown = r_roundImagesDown->integer;
+	params.imageUpsample = r_imageUpsample->integer;
+	params.imageUpsampleMaxSize = r_imageUpsampleMaxSize->integer;
+	params.simpleMipMaps = r_simpleMipMaps->integer;
+	params.colorMipLevels = r_colorMipLevels->integer;
+	params.greyscale = r_greyscale->value;
+	params.maxTextureSize = glConfig.maxTextureSize;
+	params.deviceSupportsGamma = glConfig.deviceSupportsGamma;
+	params.textureCompression = glConfig.textureCompression | (glRefConfig.textureCompression << 8);
+	params.textureBits = r_texturebits->integer;
+
+	imageCacheKey_t key = source;
+	key = R_ImageCacheHash(&params, sizeof(params), key);
+	key = R_ImageCacheHash(s_intensitytable, sizeof(s_intensitytable), key);
+	key = R_ImageCacheHash(s_gammatable, sizeof(s_gammatable), key);
+
+	return key ? key : 1;
+}
+
+// an image waiting for its levels to be read back into a pixel buffer
+typedef struct imageCacheSave_s
+{
+	imageCacheKey_t	key;
+	imageCacheKey_t	source;
+	image_t			*image;
+
+	// filled in when the readback is started
+	GLuint			pbo;
+	GLsync			sync;
+	GLint			internalFormat;
+	GLint			compressed;
+	int				numLevels;
+	int				levelSizes[IMAGE_CACHE_MAX_LEVELS];
+	int				dataSize;
+} imageCacheSave_t;
+
+// reading a texture back right after creating it would wait for the GPU
+#define IMAGE_CACHE_SAVES_PER_FRAME	4
+
+static std::deque<imageCacheSave_t>	imageCacheQueued;
+static std::deque<imageCacheSave_t>	imageCacheReading;
+
+/*
+===============
+R_SaveImageCache
+
+Queues image, which must have just been created, to be written out as the
+entry for key. R_UpdateImageCacheSaves reads it back a few frames later.
+===============
+*/
+static void R_SaveImageCache( imageCacheKey_t key, imageCacheKey_t source, image_t *image )
+{
+	if ( !key )
+		return;
+
+	imageCacheSave_t save = {};
+	save.key = key;
+	save.source = source;
+	save.image = image;
+	imageCacheQueued.push_back(save);
+}
+
+/*
+===============
+R_StartImageCacheSave
+
+Starts reading every level of the image back into a pixel buffer. Returns
+qfalse if it isn't worth caching.
+===============
+*/
+static qboolean R_StartImageCacheSave( imageCacheSave_t *save )
+{
+	image_t *image = save->image;
+
+	save->numLevels = CalcNumMipmapLevels(image->uploadWidth, image->uploadHeight);
+	if ( save->numLevels > IMAGE_CACHE_MAX_LEVELS )
+		return qfalse;
+
+	R_LoadImageCacheIndex();
+
+	GL_SelectTexture(image->TMU);
+	GL_Bind(image);
+
+	save->compressed = GL_FALSE;
+	save->internalFormat = image->internalFormat;
+	qglGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &save->compressed);
+	if ( save->compressed )
+	{
+		// the format the driver actually picked, which a generic
+		// compressed format doesn't say
+		qglGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &save->internalFormat);
+	}
+
+	int width = image->uploadWidth;
+	int height = image->uploadHeight;
+	save->dataSize = 0;
+	for ( int i = 0; i < save->numLevels; i++ )
+	{
+		if ( save->compressed )
+			qglGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &save->levelSizes[i]);
+		else
+			save->levelSizes[i] = width * height * 4;
+
+		save->dataSize += save->levelSizes[i];
+		width = Q_max(1, width >> 1);
+		height = Q_max(1, height >> 1);
+	}
+
+	// an entry that alone would take a good part of the cache isn't worth it
+	const size_t fileSize = sizeof(imageCacheHeader_t) + save->numLevels * sizeof(int) + save->dataSize;
+	if ( fileSize > (size_t)r_imageCacheSize->integer * 1024 * 1024 / 8 )
+	{
+		GL_SelectTexture(0);
+		return qfalse;
+	}
+
+	qglGenBuffers(1, &save->pbo);
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, save->pbo);
+	qglBufferData(GL_PIXEL_PACK_BUFFER, save->dataSize, NULL, GL_STREAM_READ);
+
+	int offset = 0;
+	for ( int i = 0; i < save->numLevels; i++ )
+	{
+		if ( save->compressed )
+			qglGetCompressedTexImage(GL_TEXTURE_2D, i, BUFFER_OFFSET(offset));
+		else
+			qglGetTexImage(GL_TEXTURE_2D, i, GL_RGBA, GL_UNSIGNED_BYTE, BUFFER_OFFSET(offset));
+
+		offset += save->levelSizes[i];
+	}
+
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	GL_SelectTexture(0);
+
+	save->sync = qglFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	return qtrue;
+}
+
+/*
+===============
+R_FinishImageCacheSave
+
+Writes out the levels that were read back, waiting for them if need be,
+and frees the pixel buffer.
+===============
+*/
+static void R_FinishImageCacheSave( imageCacheSave_t *save )
+{
+	const image_t *image = save->image;
+	char path[MAX_QPATH];
+
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, save->pbo);
+	const byte *levels = (const byte *)qglMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, save->dataSize, GL_MAP_READ_BIT);
+
+	if ( levels )
+	{
+		const int fileSize = sizeof(imageCacheHeader_t) + save->numLevels * sizeof(int) + save->dataSize;
+		byte *buffer = (byte *)ri.Hunk_AllocateTempMemory(fileSize);
+		imageCacheHeader_t *header = (imageCacheHeader_t *)buffer;
+
+		header->ident = LittleLong(IMAGE_CACHE_IDENT);
+		header->version = LittleLong(IMAGE_CACHE_VERSION);
+		header->key[0] = LittleLong((uint32_t)(save->key >> 32));
+		header->key[1] = LittleLong((uint32_t)save->key);
+		header->width = LittleLong(image->width);
+		header->height = LittleLong(image->height);
+		header->uploadWidth = LittleLong(image->uploadWidth);
+		header->uploadHeight = LittleLong(image->uploadHeight);
+		header->internalFormat = LittleLong(save->internalFormat);
+		header->compressed = LittleLong(save->compressed ? 1 : 0);
+		header->numLevels = LittleLong(save->numLevels);
+
+		byte *out = (byte *)(header + 1);
+		for ( int i = 0; i < save->numLevels; i++ )
+		{
+			*(int *)out = LittleLong(save->levelSizes[i]);
+			out += sizeof(int);
+
+			Com_Memcpy(out, levels, save->levelSizes[i]);
+			out += save->levelSizes[i];
+			levels += save->levelSizes[i];
+		}
+
+		qglUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+		R_ImageCachePath(path, sizeof(path), save->key);
+		ri.FS_WriteFile(path, buffer, fileSize);
+		ri.Hunk_FreeTempMemory(buffer);
+
+		R_AddImageCacheEntry(save->key, save->source, fileSize, ++imageCache.useCounter);
+		imageCache.dirty = qtrue;
+
+		R_EvictImageCache();
+	}
+
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	qglDeleteBuffers(1, &save->pbo);
+	qglDeleteSync(save->sync);
+}
+
+/*
+===============
+R_UpdateImageCacheSaves
+
+Writes out the images whose readback the GPU has finished, and starts
+reading back a few more. Called once a frame.
+===============
+*/
+void R_UpdateImageCacheSaves( void )
+{
+	while ( !imageCacheReading.empty() )
+	{
+		imageCacheSave_t *save = &imageCacheReading.front();
+		const GLenum result = qglClientWaitSync(save->sync, 0, 0);
+		if ( result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED )
+			break;
+
+		R_FinishImageCacheSave(save);
+		imageCacheReading.pop_front();
+	}
+
+	for ( int i = 0; i < IMAGE_CACHE_SAVES_PER_FRAME && !imageCacheQueued.empty(); i++ )
+	{
+		imageCacheSave_t save = imageCacheQueued.front();
+		imageCacheQueued.pop_front();
+
+		if ( R_StartImageCacheSave(&save) )
+			imageCacheReading.push_back(save);
+	}
+}
+
+/*
+===============
+R_FinishImageCacheSaves
+
+Writes out the images already being read back, and forgets the rest; they
+are cached the next time they are loaded. Called before the textures are
+deleted.
+===============
+*/
+static void R_FinishImageCacheSaves( void )
+{
+	for ( imageCacheSave_t& save : imageCacheReading )
+		R_FinishImageCacheSave(&save);
+
+	imageCacheReading.clear();
+	imageCacheQueued.clear();
+}
+
+/*
+===============
+R_LoadImageCache
+
+Returns the file buffer, header and level sizes already byte swapped, if a
+valid cache entry for key exists. Free it with ri.FS_FreeFile.
+===============
+*/
+static imageCacheHeader_t *R_LoadImageCache( imageCacheKey_t key )
+{
+	char path[MAX_QPATH];
+	union {
+		imageCacheHeader_t *h;
+		void *v;
+	} buffer;
+
+	if ( !key )
+		return NULL;
+
+	R_LoadImageCacheIndex();
+
+	auto entry = imageCache.entries.find(key);
+	if ( entry == imageCache.entries.end() )
+		return NULL;
+
+	R_ImageCachePath(path, sizeof(path), key);
+	const long fileSize = ri.FS_ReadFile(path, &buffer.v);
+	if ( !buffer.h )
+	{
+		R_RemoveImageCacheEntry(key, qfalse);
+		return NULL;
+	}
+
+	imageCacheHeader_t *header = buffer.h;
+	if ( fileSize >= (long)sizeof(*header) )
+	{
+		header->ident = LittleLong(header->ident);
+		header->version = LittleLong(header->version);
+		header->key[0] = LittleLong(header->key[0]);
+		header->key[1] = LittleLong(header->key[1]);
+		header->width = LittleLong(header->width);
+		header->height = LittleLong(header->height);
+		header->uploadWidth = LittleLong(header->uploadWidth);
+		header->uploadHeight = LittleLong(header->uploadHeight);
+		header->internalFormat = LittleLong(header->internalFormat);
+		header->compressed = LittleLong(header->compressed);
+		header->numLevels = LittleLong(header->numLevels);
+
+		if ( header->ident == IMAGE_CACHE_IDENT &&
+			header->version == IMAGE_CACHE_VERSION &&
+			header->key[0] == (uint32_t)(key >> 32) &&
+			header->key[1] == (uint32_t)key &&
+			header->width > 0 && header->height > 0 &&
+			header->uploadWidth > 0 && header->uploadHeight > 0 &&
+			header->numLevels == CalcNumMipmapLevels(header->uploadWidth, header->uploadHeight) &&
+			header->numLevels <= IMAGE_CACHE_MAX_LEVELS )
+		{
+			byte *level = (byte *)(header + 1);
+			const byte *end = (const byte *)header + fileSize;
+			int width = header->uploadWidth;
+			int height = header->uploadHeight;
+			int i;
+
+			for ( i = 0; i < header->numLevels; i++ )
+			{
+				if ( end - level < (long)sizeof(int) )
+					break;
+
+				const int size = LittleLong(*(int *)level);
+				if ( size <= 0 || end - level - (long)sizeof(int) < size )
+					break;
+				if ( !header->compressed && size != width * height * 4 )
+					break;
+
+				*(int *)level = size;
+				level += sizeof(int) + size;
+				width = Q_max(1, width >> 1);
+				height = Q_max(1, height >> 1);
+			}
+
+			if ( i == header->numLevels && level == end )
+			{
+				entry->second.lastUse = ++imageCache.useCounter;
+				imageCache.dirty = qtrue;
+				return header;
+			}
+		}
+	}
+
+	ri.FS_FreeFile(buffer.v);
+	R_RemoveImageCacheEntry(key, qtrue);
+	return NULL;
+}
+
+/*
+===============
+UploadCached
+
+Uploads the levels of a processed image cache entry as they are.
+===============
+*/
+static void UploadCached( const imageCacheHeader_t *header, int flags, int *pUploadWidth, int *pUploadHeight )
+{
+	const GLenum internalFormat = header->internalFormat;
+	const byte *data = (const byte *)(header + 1);
+	int width = header->uploadWidth;
+	int height = header->uploadHeight;
+	const qboolean immutable = ShouldUseImmutableTextures(flags, internalFormat);
+
+	if ( immutable )
+	{
+		qglTexStorage2D (GL_TEXTURE_2D, header->numLevels, internalFormat, width, height);
+	}
+
+	for ( int miplevel = 0; miplevel < header->numLevels; miplevel++ )
+	{
+		const int size = *(const int *)data;
+		data += sizeof(int);
+
+		if ( header->compressed )
+		{
+			if ( immutable )
+				qglCompressedTexSubImage2D (GL_TEXTURE_2D, miplevel, 0, 0, width, height, internalFormat, size, data );
+			else
+				qglCompressedTexImage2D (GL_TEXTURE_2D, miplevel, internalFormat, width, height, 0, size, data );
+		}
+		else
+		{
+			if ( immutable )
+				qglTexSubImage2D (GL_TEXTURE_2D, miplevel, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data );
+			else
+				qglTexImage2D (GL_TEXTURE_2D, miplevel, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data );
+		}
+
+		data += size;
+		width = Q_max(1, width >> 1);
+		height = Q_max(1, height >> 1);
+	}
+
+	*pUploadWidth = header->uploadWidth;
+	*pUploadHeight = header->uploadHeight;
+
+	RawImage_SetFilter(flags);
+
+	GL_CheckErrors();
+}
+
+/*
+===============
+Upload32
+
+===============
+*/
+extern qboolean charSet;
+static void Upload32( byte *data, int width, int height, imgType_t type, int flags,
+	qboolean lightMap, GLenum internalFormat, int *pUploadWidth, int *pUploadHeight)
+{
+	byte		*scaledBuffer = NULL;
+	byte		*resampledBuffer = NULL;
+	int			scaled_width = width;
+	int			scaled_height = height;
+	int			i, c;
+	byte		*scan;
+
+	if ( !IsPowerOfTwo (width) || !IsPowerOfTwo (height) )
+	{
+		RawImage_ScaleToPower2(&data, &width, &height, &scaled_width, &scaled_height, type, flags, &resampledBuffer);
+	}
+
+	scaledBuffer = (byte *)ri.Hunk_AllocateTempMemory( sizeof( unsigned ) * scaled_width * scaled_height );
+
+	//
+	// scan the texture for each channel's max values
+	// and verify if the alpha channel is being used or not
+	//
+	c = width*height;
+	scan = data;
+
+	if( r_greyscale->integer )
+	{
+		for ( i = 0; i < c; i++ )
+		{
+			byte luma = LUMA(scan[i*4], scan[i*4 + 1], scan[i*4 + 2]);
+			scan[i*4] = luma;
+			scan[i*4 + 1] = luma;
+			scan[i*4 + 2] = luma;
+		}
+	}
+	else if( r_greyscale->value )
+	{
+		for ( i = 0; i < c; i++ )
+		{
+			float luma = LUMA(scan[i*4], scan[i*4 + 1], scan[i*4 + 2]);
+			scan[i*4] = LERP(scan[i*4], luma, r_greyscale->value);
+			scan[i*4 + 1] = LERP(scan[i*4 + 1], luma, r_greyscale->value);
+			scan[i*4 + 2] = LERP(scan[i*4 + 2], luma, r_greyscale->value);
+		}
+	}
+
+	// normals are always swizzled
+	if (type == IMGTYPE_NORMAL || type == IMGTYPE_NORMALHEIGHT)
+	{
+		RawImage_SwizzleRA(data, width, height);
+	}
+
+	// LATC2 is only used for normals
+	if (internalFormat == GL_COMPRESSED_LUMINANCE_ALPHA_LATC2_EXT)
+	{
+		byte *in = data;
+		int c = width * height;
+		while (c--)
+		{
+			in[0] = in[1];
+			in[2] = in[1];
+			in += 4;
+		}
+	}
+
+	// copy or resample data as appropriate for first MIP level
+	if ( ( scaled_width == width ) &&
+		( scaled_height == height ) ) {
+		if (!(flags & IMGFLAG_MIPMAP))
+		{
+			RawImage_UploadTexture( data, 0, 0, scaled_width, scaled_height, internalFormat, type, flags, qfalse );
+			//qglTexImage2D (GL_TEXTURE_2D, 0, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+			*pUploadWidth = scaled_width;
+			*pUploadHeight = scaled_height;
+
+			goto done;
+		}
+		Com_Memcpy (scaledBuffer, data, width*height*4);
+	}
+	else if ( !r_simpleMipMaps->integer )
+	{
+		// use the normal mip-mapping function to go down from here
+		while ( width > scaled_width || height > scaled_height ) {
+
+			if (flags & IMGFLAG_SRGB)
+			{
+				R_MipMapsRGB( (byte *)data, width, height );
+			}
+			else
+			{
+				R_MipMap( (byte *)data, width, height );
+			}
+
+			width >>= 1;
+			height >>= 1;
+			if ( width < 1 ) {
+				width = 1;
+			}
+			if ( height < 1 ) {
+				height = 1;
+			}
+		}
+		Com_Memcpy( scaledBuffer, data, width * height * 4 );
+	}
+
+	if (!(flags & IMGFLAG_NOLIGHTSCALE))
+		R_LightScaleTexture (scaledBuffer, scaled_width, scaled_height, (qboolean)(!(flags & IMGFLAG_MIPMAP)) );
+
+	*pUploadWidth = scaled_width;
+	*pUploadHeight = scaled_height;
+
+	RawImage_UploadTexture(scaledBuffer, 0, 0, scaled_width, scaled_height, internalFormat, type, flags, qfalse);
+
+done:
+
+	RawImage_SetFilter(flags);
+
+	GL_CheckErrors();
+
+	if ( scaledBuffer != 0 )
+		ri.Hunk_FreeTempMemory( scaledBuffer );
+	if ( resampledBuffer != 0 )
+		ri.Hunk_FreeTempMemory( resampledBuffer );
+}
+
+
+static void EmptyTexture( int width, int height, imgType_t type, int flags,
+	qboolean lightMap, GLenum internalFormat, int *pUploadWidth, int *pUploadHeight )
+{
+	int			scaled_width, scaled_height;
+
+	RawImage_ScaleToPower2(NULL, &width, &height, &scaled_width, &scaled_height, type, flags, NULL);
+
+	*pUploadWidth = scaled_width;
+	*pUploadHeight = scaled_height;
+
+	RawImage_UploadTexture(NULL, 0, 0, scaled_width, scaled_height, internalFormat, type, flags, qfalse);
+
+	if (flags & IMGFLAG_MIPMAP)
+	{
+		if (r_ext_texture_filter_anisotropic->integer > 1 && glConfig.maxTextureFilterAnisotropy > 0.0f)
+		{
+			qglTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+					(GLint)Com_Clamp( 1, glConfig.maxTextureFilterAnisotropy, r_ext_texture_filter_anisotropic->integer ) );
+		}
+
+		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, gl_filter_min);
+		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, gl_filter_max);
+	}
+	else
+	{
+		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+		qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	}
+
+	// Fix for sampling depth buffer on old nVidia cards
+	// from http://www.idevgames.com/forums/thread-4141-post-34844.html#pid34844
+	switch(internalFormat)
+	{
+		case GL_DEPTH_COMPONENT:
+		case GL_DEPTH_COMPONENT16:
+		case GL_DEPTH_COMPONENT24:
+		case GL_DEPTH_COMPONENT32:
+			//qglTexParameterf(GL_TEXTURE_2D, GL_DEPTH_TEXTURE_MODE, GL_LUMINANCE );
+			qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+			qglTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+			break;
+		default:
+			break;
+	}
+
+	GL_CheckErrors();
+}
+
+static image_t *R_AllocImage()
+{
+	image_t *result;
+
+	if ( !tr.imagesFreeList )
+	{
+		R_ExtendImagesPool();
+	}
+
+	// Remove from free list
+	result = tr.imagesFreeList;
+	tr.imagesFreeList = tr.imagesFreeList->poolNext;
+
+	// Add to list of used images
+	result->poolNext = tr.images;
+	tr.images = result;
+
+	tr.numImages++;
+
+	return result;
+}
+
+#if 0
+static void R_FreeImage( image_t *imageToFree )
+{
+	if ( imageToFree )
+	{
+		// Images aren't deleted individually very often. Not a
 		// problem to do this really...
 		if ( imageToFree == tr.images )
 		{
@@ -2336,12 +3147,12 @@ static void R_FreeImage( image_t *imageToFree )
 
 /*
 ================
-R_CreateImage
+R_CreateImageInternal
 
-This is the only way any 2d image_t are created
+Uploads the texels of cached instead of pic if it is not NULL
 ================
 */
-image_t *R_CreateImage( const char *name, byte *pic, int width, int height, imgType_t type, int flags, int internalFormat ) {
+static image_t *R_CreateImageInternal( const char *name, byte *pic, int width, int height, imgType_t type, int flags, int internalFormat, const imageCacheHeader_t *cached ) {
 	image_t		*image;
 	qboolean	isLightmap = qfalse;
 	long		hash;
@@ -2369,7 +3180,11 @@ image_t *R_CreateImage( const char *name, byte *pic, int width, int height, imgT
 	else
 		glWrapClampMode = GL_REPEAT;
 
-	if (!internalFormat)
+	if (cached)
+	{
+		internalFormat = cached->internalFormat;
+	}
+	else if (!internalFormat)
 	{
 		if (image->flags & IMGFLAG_CUBEMAP)
 			internalFormat = r_hdr->integer ? GL_RGBA16F : GL_RGBA8;
@@ -2452,7 +3267,11 @@ image_t *R_CreateImage( const char *name, byte *pic, int width, int height, imgT
 	{
 		GL_Bind(image);
 
-		if (pic)
+		if (cached)
+		{
+			UploadCached( cached, image->flags, &image->uploadWidth, &image->uploadHeight );
+		}
+		else if (pic)
 		{
 			Upload32( pic, image->width, image->height, image->type, image->flags,
 				isLightmap, image->internalFormat, &image->uploadWidth,
@@ -2468,7 +3287,8 @@ image_t *R_CreateImage( const char *name, byte *pic, int width, int height, imgT
 		qglTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, glWrapClampMode );
 		qglTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, glWrapClampMode );
 
-		if (image->flags & IMGFLAG_MIPMAP && r_simpleMipMaps->integer)
+		// cache entries hold every level
+		if (image->flags & IMGFLAG_MIPMAP && r_simpleMipMaps->integer && !cached)
 			qglGenerateMipmap(GL_TEXTURE_2D);
 	}
 
@@ -2481,6 +3301,37 @@ image_t *R_CreateImage( const char *name, byte *pic, int width, int height, imgT
 	return image;
 }
 
+/*
+================
+R_CreateImageFromCache
+
+Creates the image from a processed image cache entry, or returns NULL if
+there is none for key.
+================
+*/
+static image_t *R_CreateImageFromCache( const char *name, imageCacheKey_t key, imgType_t type, int flags )
+{
+	imageCacheHeader_t *cached = R_LoadImageCache(key);
+	if ( !cached )
+		return NULL;
+
+	image_t *image = R_CreateImageInternal(name, NULL, cached->width, cached->height, type, flags, 0, cached);
+	ri.FS_FreeFile(cached);
+
+	return image;
+}
+
+/*
+================
+R_CreateImage
+
+This is the only way any 2d image_t are created
+================
+*/
+image_t *R_CreateImage( const char *name, byte *pic, int width, int height, imgType_t type, int flags, int internalFormat ) {
+	return R_CreateImageInternal(name, pic, width, height, type, flags, internalFormat, NULL);
+}
+
 /*
 ================
 R_Create2DImageArray
@@ -2739,9 +3590,21 @@ void R_LoadPackedMaterialImage(shaderStage_t *stage, const char *packedImageName
 		return;
 	}
 
-	R_LoadImage(packedImageName, &packedPic, &packedWidth, &packedHeight);
-	if (packedPic == NULL) {
-		return;
+	const int packedFlags = flags & ~IMGFLAG_SRGB;
+	const imageCacheKey_t cacheSource = R_ImageCacheSource(packedImageName);
+	imageCacheKey_t cacheKey = R_ImageCacheKey(cacheSource, IMGTYPE_COLORALPHA, packedFlags, IMAGECACHE_PACKED_MATERIAL);
+
+	image = R_CreateImageFromCache(packedName, cacheKey, IMGTYPE_COLORALPHA, packedFlags);
+	packedPic = NULL;
+	if (image == NULL)
+	{
+		char decodedName[MAX_QPATH];
+
+		R_LoadImageFile(packedImageName, &packedPic, &packedWidth, &packedHeight, decodedName, sizeof(decodedName));
+		if (packedPic == NULL) {
+			return;
+		}
+		cacheKey = R_ImageCacheDecoded(cacheKey, cacheSource, decodedName);
 	}
 
 	// Don't scale occlusion, roughness and metalness
@@ -2784,10 +3647,16 @@ void R_LoadPackedMaterialImage(shaderStage_t *stage, const char *packedImageName
 		break;
 	}
 
-	stage->bundle[TB_ORMSMAP].image[0] = R_CreateImage(packedName, packedPic, packedWidth, packedHeight, IMGTYPE_COLORALPHA, flags & ~IMGFLAG_SRGB, 0);
+	if (image == NULL)
+	{
+		image = R_CreateImage(packedName, packedPic, packedWidth, packedHeight, IMGTYPE_COLORALPHA, packedFlags, 0);
+		R_SaveImageCache(cacheKey, cacheSource, image);
+		Z_Free(packedPic);
+	}
+
+	stage->bundle[TB_ORMSMAP].image[0] = image;
 	glBindTexture(GL_TEXTURE_2D, stage->bundle[TB_ORMSMAP].image[0]->texnum);
 	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
-	Z_Free(packedPic);
 }
 
 image_t *R_BuildSDRSpecGlossImage(shaderStage_t *stage, const char *specImageName, int flags)
@@ -2810,9 +3679,19 @@ image_t *R_BuildSDRSpecGlossImage(shaderStage_t *stage, const char *specImageNam
 	if (image != NULL)
 		return image;
 
-	R_LoadImage(specImageName, &specPic, &specWidth, &specHeight);
+	const int sdrFlags = flags & ~IMGFLAG_SRGB;
+	const imageCacheKey_t cacheSource = R_ImageCacheSource(specImageName);
+	imageCacheKey_t cacheKey = R_ImageCacheKey(cacheSource, IMGTYPE_COLORALPHA, sdrFlags, IMAGECACHE_SDR_SPECULAR);
+
+	image = R_CreateImageFromCache(sdrName, cacheKey, IMGTYPE_COLORALPHA, sdrFlags);
+	if (image != NULL)
+		return image;
+
+	char decodedName[MAX_QPATH];
+	R_LoadImageFile(specImageName, &specPic, &specWidth, &specHeight, decodedName, sizeof(decodedName));
 	if (specPic == NULL)
 		return NULL;
+	cacheKey = R_ImageCacheDecoded(cacheKey, cacheSource, decodedName);
 
 	byte *sdrSpecPic = (byte *)ri.Hunk_AllocateTempMemory(sizeof(unsigned) * specWidth * specHeight);
 	vec3_t currentColor;
@@ -2833,7 +3712,10 @@ image_t *R_BuildSDRSpecGlossImage(shaderStage_t *stage, const char *specImageNam
 	}
 	ri.Hunk_FreeTempMemory(specPic);
 
-	return R_CreateImage(sdrName, sdrSpecPic, specWidth, specHeight, IMGTYPE_COLORALPHA, flags & ~IMGFLAG_SRGB, 0);
+	image = R_CreateImage(sdrName, sdrSpecPic, specWidth, specHeight, IMGTYPE_COLORALPHA, sdrFlags, 0);
+	R_SaveImageCache(cacheKey, cacheSource, image);
+
+	return image;
 }
 
 static void R_CreateNormalMap ( const char *name, byte *pic, int width, int height, int flags )
@@ -2939,6 +3821,279 @@ static void R_CreateNormalMap ( const char *name, byte *pic, int width, int heig
 	}
 }
 
+/*
+===============
+Image prefetching
+
+Decoding JPEG and PNG files is most of the time R_FindImageFile spends on
+an image. While a level loads, the images its shaders name are read on the
+main thread and decoded by worker threads, so decoding overlaps the file
+reads and the rest of the BSP load. R_FindImageFile then only has to pick
+up the decoded pixels, waiting for them if it has to. TGA files are cheap
+to unpack and are left to R_LoadImage.
+===============
+*/
+#define MAX_PREFETCH_IMAGES 2048
+
+typedef enum
+{
+	PREFETCH_QUEUED,
+	PREFETCH_DECODED,
+	PREFETCH_FAILED,		// or already taken
+} prefetchState_t;
+
+typedef struct prefetchImage_s
+{
+	char			name[MAX_QPATH];
+	byte			*file;				// malloced copy of the file
+	int				fileLength;
+	qboolean		png;
+	byte			*pic;				// malloced by R_DecodeJPG/R_DecodePNG
+	int				width;
+	int				height;
+	prefetchState_t	state;
+	struct prefetchImage_s *next;		// in the same hash bucket
+} prefetchImage_t;
+
+static struct
+{
+	prefetchImage_t			images[MAX_PREFETCH_IMAGES];
+	prefetchImage_t			*hashTable[FILE_HASH_SIZE];
+	int						numImages;
+	int						nextImage;		// next one for a worker to decode
+	size_t					decodedBytes;	// held in decoded, untaken images
+	size_t					maxDecodedBytes;
+	bool					finished;		// nothing more will be queued
+
+	std::vector<std::thread>	workers;
+	std::mutex					mutex;
+	std::condition_variable		queued;
+	std::condition_variable		decoded;
+} prefetch;
+
+static void R_PrefetchWorker( void )
+{
+	std::unique_lock<std::mutex> lock(prefetch.mutex);
+
+	for ( ;; )
+	{
+		prefetch.queued.wait(lock, [] {
+			return prefetch.nextImage < prefetch.numImages || prefetch.finished;
+		});
+
+		if ( prefetch.nextImage >= prefetch.numImages )
+		{
+			break;
+		}
+
+		prefetchImage_t *image = &prefetch.images[prefetch.nextImage++];
+		const bool overBudget = prefetch.decodedBytes >= prefetch.maxDecodedBytes;
+		lock.unlock();
+
+		// over budget, R_FindImageFile will load it itself when it gets to it
+		qboolean ok = qfalse;
+		if ( !overBudget )
+		{
+			if ( image->png )
+				ok = R_DecodePNG(image->file, image->fileLength, &image->pic, &image->width, &image->height);
+			else
+				ok = R_DecodeJPG(image->file, image->fileLength, &image->pic, &image->width, &image->height);
+		}
+
+		free(image->file);
+		image->file = NULL;
+
+		lock.lock();
+		if ( ok )
+		{
+			image->state = PREFETCH_DECODED;
+			prefetch.decodedBytes += (size_t)image->width * image->height * 4;
+		}
+		else
+		{
+			image->state = PREFETCH_FAILED;
+		}
+		prefetch.decoded.notify_all();
+	}
+}
+
+static prefetchImage_t *R_FindPrefetchedImage( const char *name )
+{
+	for ( prefetchImage_t *image = prefetch.hashTable[generateHashValue(name)]; image; image = image->next )
+	{
+		if ( !strcmp(name, image->name) )
+			return image;
+	}
+
+	return NULL;
+}
+
+/*
+===============
+R_BeginImagePrefetch
+
+Starts the decoding threads for a new batch of R_PrefetchImage calls.
+Does nothing if r_imagePrefetch is 0.
+===============
+*/
+void R_BeginImagePrefetch( void )
+{
+	R_FinishImagePrefetch();
+
+	if ( r_imagePrefetch->integer <= 0 )
+		return;
+
+	prefetch.maxDecodedBytes = (size_t)r_imagePrefetch->integer * 1024 * 1024;
+	prefetch.finished = false;
+
+	const int numWorkers = Q_max(1, R_NumJobThreads() - 1);
+	for ( int i = 0; i < numWorkers; i++ )
+	{
+		prefetch.workers.emplace_back(R_PrefetchWorker);
+	}
+}
+
+/*
+===============
+R_PrefetchImage
+
+Reads the file R_LoadImage would load for name and queues it for decoding.
+===============
+*/
+void R_PrefetchImage( const char *name )
+{
+	char filename[MAX_QPATH];
+	const char *extension;
+	image_t *loaded;
+	void *buffer;
+	int length, stamp = 0;
+
+	if ( prefetch.workers.empty() || prefetch.numImages >= MAX_PREFETCH_IMAGES )
+		return;
+
+	if ( !name[0] || name[0] == '*' || strlen(name) >= MAX_QPATH )
+		return;
+
+	if ( R_FindPrefetchedImage(name) )
+		return;
+
+	for ( loaded = hashTable[generateHashValue(name)]; loaded; loaded = loaded->next )
+	{
+		if ( !strcmp(name, loaded->imgName) )
+			return;
+	}
+
+	length = R_FindImageSource(name, filename, sizeof(filename), &stamp);
+	if ( length <= 0 )
+		return;
+
+	extension = COM_GetExtension(filename);
+	if ( !Q_stricmp(extension, "tga") )
+		return;
+
+	// most likely it will come out of the image cache without decoding
+	if ( r_imageCache->integer && R_ImageCacheHasSource(R_ImageCacheSourceKey(filename, length, stamp)) )
+		return;
+
+	length = ri.FS_ReadFile(filename, &buffer);
+	if ( length <= 0 || !buffer )
+		return;
+
+	prefetchImage_t *image = &prefetch.images[prefetch.numImages];
+	Com_Memset(image, 0, sizeof(*image));
+	Q_strncpyz(image->name, name, sizeof(image->name));
+	image->png = (qboolean)!Q_stricmp(extension, "png");
+	image->fileLength = length;
+	image->file = (byte *)malloc(length);
+	Com_Memcpy(image->file, buffer, length);
+	ri.FS_FreeFile(buffer);
+
+	const long hash = generateHashValue(name);
+	image->next = prefetch.hashTable[hash];
+	prefetch.hashTable[hash] = image;
+
+	std::lock_guard<std::mutex> lock(prefetch.mutex);
+	prefetch.numImages++;
+	prefetch.queued.notify_one();
+}
+
+/*
+===============
+R_EndImagePrefetch
+
+Lets the decoding threads exit once they have worked through everything
+that was queued. Images can be taken from this point on.
+===============
+*/
+void R_EndImagePrefetch( void )
+{
+	std::lock_guard<std::mutex> lock(prefetch.mutex);
+	prefetch.finished = true;
+	prefetch.queued.notify_all();
+}
+
+/*
+===============
+R_FinishImagePrefetch
+
+Waits for the decoding threads and frees every image that was not taken.
+===============
+*/
+void R_FinishImagePrefetch( void )
+{
+	R_EndImagePrefetch();
+
+	for ( auto& worker : prefetch.workers )
+	{
+		worker.join();
+	}
+	prefetch.workers.clear();
+
+	for ( int i = 0; i < prefetch.numImages; i++ )
+	{
+		free(prefetch.images[i].file);
+		free(prefetch.images[i].pic);
+	}
+
+	Com_Memset(prefetch.hashTable, 0, sizeof(prefetch.hashTable));
+	prefetch.numImages = 0;
+	prefetch.nextImage = 0;
+	prefetch.decodedBytes = 0;
+}
+
+/*
+===============
+R_TakePrefetchedImage
+
+Hands over the decoded pixels of name, which the caller must free(). Returns
+qfalse if name was not prefetched or could not be decoded.
+===============
+*/
+static qboolean R_TakePrefetchedImage( const char *name, byte **pic, int *width, int *height )
+{
+	prefetchImage_t *image = R_FindPrefetchedImage(name);
+	if ( !image )
+		return qfalse;
+
+	std::unique_lock<std::mutex> lock(prefetch.mutex);
+	prefetch.decoded.wait(lock, [image] {
+		return image->state != PREFETCH_QUEUED;
+	});
+
+	if ( image->state != PREFETCH_DECODED )
+		return qfalse;
+
+	*pic = image->pic;
+	*width = image->width;
+	*height = image->height;
+
+	image->pic = NULL;
+	image->state = PREFETCH_FAILED;
+	prefetch.decodedBytes -= (size_t)image->width * image->height * 4;
+
+	return qtrue;
+}
+
 /*
 ===============
 R_FindImageFile
@@ -2954,6 +4109,9 @@ image_t	*R_FindImageFile( const char *name, imgType_t type, int flags )
 	byte	*pic;
 	int internalFormat = 0;
 	int loadFlags = flags;
+	qboolean prefetched = qfalse;
+	imageCacheKey_t cacheSource = 0;
+	imageCacheKey_t cacheKey = 0;
 
 	if (!name) {
 		return NULL;
@@ -2962,6 +4120,9 @@ image_t	*R_FindImageFile( const char *name, imgType_t type, int flags )
 	if ((image = R_GetLoadedImage(name, flags)) != NULL)
 		return image;
 
+	const qboolean genNormalMap = (qboolean)(r_normalMapping->integer && !(type == IMGTYPE_NORMAL) &&
+		(flags & IMGFLAG_PICMIP) && (flags & IMGFLAG_MIPMAP) && (flags & IMGFLAG_GENNORMALMAP));
+
 	//
 	// load the pic from disk
 	//
@@ -3002,15 +4163,35 @@ image_t	*R_FindImageFile( const char *name, imgType_t type, int flags )
 	}
 	else
 	{
-		R_LoadImage(name, &pic, &width, &height);
+		// a cached image needs neither decoding nor processing, unless a
+		// normal map has to be generated from the texels as well
+		if (!genNormalMap)
+		{
+			cacheSource = R_ImageCacheSource(name);
+			cacheKey = R_ImageCacheKey(cacheSource, type, flags, IMAGECACHE_IMAGE);
+
+			image = R_CreateImageFromCache(name, cacheKey, type, flags);
+			if (image != NULL)
+				return image;
+		}
+
+		// prefetching only decodes the file the cache source was made from
+		prefetched = R_TakePrefetchedImage(name, &pic, &width, &height);
+		if (!prefetched)
+		{
+			char decodedName[MAX_QPATH];
+
+			R_LoadImageFile(name, &pic, &width, &height, decodedName, sizeof(decodedName));
+			if (pic != NULL)
+				cacheKey = R_ImageCacheDecoded(cacheKey, cacheSource, decodedName);
+		}
 	}
 
 	if ( pic == NULL ) {
 		return NULL;
 	}
 
-	if (r_normalMapping->integer && !(type == IMGTYPE_NORMAL) &&
-		(flags & IMGFLAG_PICMIP) && (flags & IMGFLAG_MIPMAP) && (flags & IMGFLAG_GENNORMALMAP))
+	if (genNormalMap)
 	{
 		R_CreateNormalMap( name, pic, width, height, flags );
 	}
@@ -3025,7 +4206,11 @@ image_t	*R_FindImageFile( const char *name, imgType_t type, int flags )
 	}
 
 	image = R_CreateImage( name, pic, width, height, type, loadFlags, internalFormat);
-	Z_Free( pic );
+	R_SaveImageCache( cacheKey, cacheSource, image );
+	if (prefetched)
+		free( pic );
+	else
+		Z_Free( pic );
 
 	return image;
 }
@@ -3636,6 +4821,10 @@ R_DeleteTextures
 */
 void R_DeleteTextures( void ) {
 	image_t *image = tr.images;
+
+	R_FinishImagePrefetch();
+	R_FinishImageCacheSaves();
+	R_SaveImageCacheIndex();
 	while ( image )
 	{
 		qglDeleteTextures(1, &image->texnum);
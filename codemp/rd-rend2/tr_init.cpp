@@ -274,6 +274,13 @@ cvar_t *r_debugWeather;
 cvar_t	*r_aspectCorrectFonts;
 
 cvar_t	*r_patchStitching;
+cvar_t	*r_tangentCache;
+cvar_t	*r_tangentCacheSize;
+cvar_t	*r_imageCache;
+cvar_t	*r_imageCacheSize;
+cvar_t	*r_imagePrefetch;
+cvar_t	*r_jobThreads;
+cvar_t	*r_simd;
 
 extern void	RB_SetGL2D (void);
 static void R_Splash()
@@ -670,105 +677,6 @@ static byte *RB_ReadPixels(
 	return buffer;
 }
 
-static void ConvertRGBtoBGR(
-	byte *dst, const byte *src, int stride, int width, int height)
-{
-	const byte *row = src;
-	for (int y = 0; y < height; ++y)
-	{
-		const byte *pixelRGB = row;
-		for (int x = 0; x < width; ++x)
-		{
-			// swap rgb to bgr
-			const byte temp = pixelRGB[0];
-			*dst++ = pixelRGB[2];
-			*dst++ = pixelRGB[1];
-			*dst++ = temp;
-
-			pixelRGB += 3;
-		}
-
-		row += stride;
-	}
-}
-
-static void R_SaveTGA(
-	const char *filename,
-	const byte *pixels,
-	int width,
-	int height,
-	int stride)
-{
-	const size_t headerSize = 18;
-	const size_t pixelBufferSize = stride * height;
-	const size_t bufferSize = headerSize + pixelBufferSize;
-
-	byte *buffer = (byte *)ri.Hunk_AllocateTempMemory(bufferSize);
-
-	// Write TGA header
-	Com_Memset(buffer, 0, headerSize);
-	buffer[2] = 2;		// uncompressed type
-	buffer[12] = width & 255;
-	buffer[13] = width >> 8;
-	buffer[14] = height & 255;
-	buffer[15] = height >> 8;
-	buffer[16] = 24; // pixel size
-
-	ConvertRGBtoBGR(buffer + headerSize, pixels, stride, width, height);
-
-	ri.FS_WriteFile(filename, buffer, bufferSize);
-	ri.Hunk_FreeTempMemory(buffer);
-}
-
-/*
-==================
-R_SaveScreenshotTGA
-==================
-*/
-static void R_SaveScreenshotTGA(
-	const screenshotReadback_t *screenshotReadback, byte *pixels)
-{
-	R_SaveTGA(
-		screenshotReadback->filename,
-		pixels,
-		screenshotReadback->width,
-		screenshotReadback->height,
-		screenshotReadback->strideInBytes);
-}
-
-/*
-==================
-R_SaveScreenshotPNG
-==================
-*/
-static void R_SaveScreenshotPNG(
-	const screenshotReadback_t *screenshotReadback, byte *pixels)
-{
-	RE_SavePNG(
-		screenshotReadback->filename,
-		pixels,
-		screenshotReadback->width,
-		screenshotReadback->height,
-		3);
-}
-
-/*
-==================
-R_SaveScreenshotJPG
-==================
-*/
-static void R_SaveScreenshotJPG(
-	const screenshotReadback_t *screenshotReadback, byte *pixels)
-{
-	RE_SaveJPG(
-		screenshotReadback->filename,
-		r_screenshotJpegQuality->integer,
-		screenshotReadback->width,
-		screenshotReadback->height,
-		pixels,
-		screenshotReadback->strideInBytes - screenshotReadback->rowInBytes);
-}
-
 void R_SaveScreenshot(screenshotReadback_t *screenshotReadback)
 {
 	qglBindBuffer(GL_PIXEL_PACK_BUFFER, screenshotReadback->pbo);
@@ -784,35 +692,46 @@ void R_SaveScreenshot(screenshotReadback_t *screenshotReadback)
 	}
 	else
 	{
+		const int width = screenshotReadback->width;
 		const int height = screenshotReadback->height;
+		const int linelen = screenshotReadback->rowInBytes;
 		const int stride = screenshotReadback->strideInBytes;
-		const size_t pixelBufferSize = stride * height;
 
-		byte *pixels = (byte *)ri.Hunk_AllocateTempMemory(pixelBufferSize);
-		Com_Memcpy(pixels, pixelBuffer, pixelBufferSize);
+		// The capture thread encodes the screenshot, and the front end
+		// writes it out on a later frame.
+		captureJob_t *job = R_GetCaptureJob(linelen * height);
+		for (int y = 0; y < height; ++y)
+			Com_Memcpy(job->pixels + y * linelen, pixelBuffer + y * stride, linelen);
 		qglUnmapBuffer(GL_PIXEL_PACK_BUFFER);
 
-		if (glConfig.deviceSupportsGamma)
-			R_GammaCorrect(pixels, pixelBufferSize);
+		job->encode = R_EncodeCapture;
+		job->write = R_WriteCapture;
+		job->width = width;
+		job->height = height;
+		job->stride = linelen;
+		job->quality = r_screenshotJpegQuality->integer;
+		job->gammaCorrect = glConfig.deviceSupportsGamma ? true : false;
+		Q_strncpyz(job->fileName, screenshotReadback->filename, sizeof(job->fileName));
 
 		switch (screenshotReadback->format)
 		{
 			case SSF_JPEG:
-				R_SaveScreenshotJPG(screenshotReadback, pixels);
+				job->format = CAPTURE_JPEG;
 				break;
 
 			case SSF_TGA:
-				R_SaveScreenshotTGA(screenshotReadback, pixels);
+				job->format = CAPTURE_TGA;
 				break;
 
 			case SSF_PNG:
-				R_SaveScreenshotPNG(screenshotReadback, pixels);
+				job->format = CAPTURE_PNG;
 				break;
 		}
 
-		ri.Hunk_FreeTempMemory(pixels);
+		R_QueueCaptureJob(job);
 	}
 
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 	qglDeleteBuffers(1, &screenshotReadback->pbo);
 	screenshotReadback->pbo = 0;
 }
@@ -850,6 +769,7 @@ const void *RB_TakeScreenshotCmd( const void *data ) {
 		GL_STATIC_COPY);
 	qglReadPixels(
 		cmd->x, cmd->y, cmd->width, cmd->height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
 	screenshot->strideInBytes = strideInBytes;
 	screenshot->rowInBytes = linelen;
@@ -1080,18 +1000,61 @@ void R_ScreenShotJPEG_f (void) {
 
 //============================================================================
 
+/*
+==================
+R_QueueVideoReadback
+
+Hands a video frame that has been read back into a pixel buffer to the
+capture thread to encode; the front end gives it to the client.
+==================
+*/
+void R_QueueVideoReadback(videoReadback_t *videoReadback)
+{
+	const int height = videoReadback->height;
+	const size_t pixelBufferSize = videoReadback->strideInBytes * height;
+
+	captureJob_t *job = R_GetCaptureJob(pixelBufferSize);
+
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, videoReadback->pbo);
+	byte *pixelBuffer = static_cast<byte *>(
+		qglMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+
+	if (pixelBuffer == nullptr)
+	{
+		// keep the video in step with the audio
+		Com_Memset(job->pixels, 0, pixelBufferSize);
+	}
+	else
+	{
+		Com_Memcpy(job->pixels, pixelBuffer, pixelBufferSize);
+		qglUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	job->encode = R_EncodeCapture;
+	job->write = R_WriteCaptureVideoFrame;
+	job->width = videoReadback->width;
+	job->height = height;
+	job->stride = videoReadback->strideInBytes;
+	job->format = videoReadback->motionJpeg ? CAPTURE_AVI_MJPEG : CAPTURE_AVI_RAW;
+	job->quality = r_aviMotionJpegQuality->integer;
+	job->gammaCorrect = glConfig.deviceSupportsGamma ? true : false;
+	R_QueueCaptureJob(job);
+
+	videoReadback->pending = qfalse;
+}
+
 /*
 ==================
 RB_TakeVideoFrameCmd
+
+Reads the frame back into a pixel buffer, which RE_BeginFrame hands to the
+capture thread once the GPU is done with this frame.
 ==================
 */
 const void *RB_TakeVideoFrameCmd( const void *data )
 {
-	const videoFrameCommand_t	*cmd;
-	byte				*cBuf;
-	size_t				memcount, linelen;
-	int				padwidth, avipadwidth, padlen, avipadlen;
-	GLint packAlign;
+	const videoFrameCommand_t *cmd;
 
 	// finish any 2D drawing if needed
 	if(tess.numIndexes)
@@ -1099,66 +1062,62 @@ const void *RB_TakeVideoFrameCmd( const void *data )
 
 	cmd = (const videoFrameCommand_t *)data;
 
+	const int frameNumber = backEndData->realFrameNumber;
+	gpuFrame_t *thisFrame = &backEndData->frames[frameNumber % MAX_FRAMES];
+	videoReadback_t *video = &thisFrame->videoReadback;
+
+	GLint packAlign;
 	qglGetIntegerv(GL_PACK_ALIGNMENT, &packAlign);
 
-	linelen = cmd->width * 3;
+	const int strideInBytes = PAD(cmd->width * 3, packAlign);
+	const int pboSize = strideInBytes * cmd->height;
 
-	// Alignment stuff for glReadPixels
-	padwidth = PAD(linelen, packAlign);
-	padlen = padwidth - linelen;
-	// AVI line padding
-	avipadwidth = PAD(linelen, AVI_LINE_PADDING);
-	avipadlen = avipadwidth - linelen;
+	if (video->pbo == 0)
+		qglGenBuffers(1, &video->pbo);
 
-	cBuf = (byte*)(PADP(cmd->captureBuffer, packAlign));
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, video->pbo);
+	if (video->pboSize < pboSize)
+	{
+		qglBufferData(GL_PIXEL_PACK_BUFFER, pboSize, nullptr, GL_STREAM_READ);
+		video->pboSize = pboSize;
+	}
+	qglReadPixels(
+		0, 0, cmd->width, cmd->height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+	qglBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
-	qglReadPixels(0, 0, cmd->width, cmd->height, GL_RGB,
-		GL_UNSIGNED_BYTE, cBuf);
+	video->strideInBytes = strideInBytes;
+	video->width = cmd->width;
+	video->height = cmd->height;
+	video->motionJpeg = cmd->motionJpeg;
+	video->pending = qtrue;
 
-	memcount = padwidth * cmd->height;
+	return (const void *)(cmd + 1);
+}
 
-	// gamma correct
-	if(glConfig.deviceSupportsGamma)
-		R_GammaCorrect(cBuf, memcount);
+/*
+==================
+RE_FinishVideoFrames
 
-	if(cmd->motionJpeg)
-	{
-		memcount = RE_SaveJPGToBuffer(cmd->encodeBuffer, linelen * cmd->height,
-			r_aviMotionJpegQuality->integer,
-			cmd->width, cmd->height, cBuf, padlen);
-		ri.CL_WriteAVIVideoFrame(cmd->encodeBuffer, memcount);
-	}
-	else
+Hands the frames still being read back to the capture thread and waits for
+all of them to be written to the video.
+==================
+*/
+void RE_FinishVideoFrames( void )
+{
+	if ( tr.registered )
 	{
-		byte *lineend, *memend;
-		byte *srcptr, *destptr;
-
-		srcptr = cBuf;
-		destptr = cmd->encodeBuffer;
-		memend = srcptr + memcount;
+		R_IssuePendingRenderCommands();
 
-		// swap R and B and remove line paddings
-		while(srcptr < memend)
+		// oldest first; mapping the buffers waits for the GPU
+		for ( int i = 0; i < MAX_FRAMES; i++ )
 		{
-			lineend = srcptr + linelen;
-			while(srcptr < lineend)
-			{
-				*destptr++ = srcptr[2];
-				*destptr++ = srcptr[1];
-				*destptr++ = srcptr[0];
-				srcptr += 3;
-			}
-
-			Com_Memset(destptr, '\0', avipadlen);
-			destptr += avipadlen;
-
-			srcptr += padlen;
+			gpuFrame_t *frame = &backEndData->frames[(backEndData->realFrameNumber + i) % MAX_FRAMES];
+			if ( frame->videoReadback.pending )
+				R_QueueVideoReadback(&frame->videoReadback);
 		}
-
-		ri.CL_WriteAVIVideoFrame(cmd->encodeBuffer, avipadwidth * cmd->height);
 	}
 
-	return (const void *)(cmd + 1);
+	R_FinishCaptureJobs();
 }
 
 //============================================================================
@@ -1646,6 +1605,13 @@ Ghoul2 Insert End
 */
 
 	r_patchStitching = ri.Cvar_Get("r_patchStitching", "1", CVAR_ARCHIVE, "Enable stitching of neighbouring patch surfaces" );
+	r_tangentCache = ri.Cvar_Get("r_tangentCache", "1", CVAR_ARCHIVE, "Cache generated tangent space of world and model vertex buffers on disk" );
+	r_tangentCacheSize = ri.Cvar_Get("r_tangentCacheSize", "64", CVAR_ARCHIVE, "Megabytes of disk the tangent cache may use before it is cleared" );
+	r_imageCache = ri.Cvar_Get("r_imageCache", "1", CVAR_ARCHIVE, "Cache finished mip chains of mipmapped images on disk" );
+	r_imageCacheSize = ri.Cvar_Get("r_imageCacheSize", "512", CVAR_ARCHIVE, "Megabytes of disk the image cache may use before the least recently used images are evicted" );
+	r_imagePrefetch = ri.Cvar_Get("r_imagePrefetch", "256", CVAR_ARCHIVE, "Megabytes of level images to decode ahead on worker threads, 0 to decode on demand" );
+	r_jobThreads = ri.Cvar_Get("r_jobThreads", "0", CVAR_ARCHIVE | CVAR_LATCH, "Number of threads used for parallel load work, 0 to use one per CPU core" );
+	r_simd = ri.Cvar_Get("r_simd", "1", CVAR_ARCHIVE, "Use SSE2/NEON code paths where available" );
 
 	se_language = ri.Cvar_Get ( "se_language", "english", CVAR_ARCHIVE | CVAR_NORESTART, "" );
 
@@ -1873,6 +1839,9 @@ static void R_ShutdownBackEndFrameData()
 	if ( !backEndData )
 		return;
 
+	// write out whatever is still being captured before the buffers go
+	RE_FinishVideoFrames();
+
 	for ( int i = 0; i < MAX_FRAMES; i++ )
 	{
 		gpuFrame_t *frame = backEndData->frames + i;
@@ -1885,6 +1854,13 @@ static void R_ShutdownBackEndFrameData()
 
 		qglDeleteBuffers(1, &frame->ubo);
 
+		if (frame->videoReadback.pbo)
+		{
+			qglDeleteBuffers(1, &frame->videoReadback.pbo);
+			frame->videoReadback.pbo = 0;
+			frame->videoReadback.pboSize = 0;
+		}
+
 		if ( glRefConfig.immutableBuffers )
 		{
 			R_BindVBO(frame->dynamicVbo);
@@ -2010,6 +1986,8 @@ void R_Init( void ) {
 
 	R_InitQueries();
 
+	R_InitJobThreads();
+
 	R_InitWeatherSystem();
 
 #if defined(_DEBUG)
@@ -2043,6 +2021,8 @@ void RE_Shutdown( qboolean destroyWindow, qboolean restarting ) {
 	R_IssuePendingRenderCommands();
 
 	R_ShutdownBackEndFrameData();
+	R_ShutdownCaptureThread();
+	R_ShutdownJobThreads();
 
 	R_ShutdownWeatherSystem();
 
@@ -2082,6 +2062,8 @@ Touch all images to make sure they are resident
 */
 void RE_EndRegistration( void ) {
 	R_IssuePendingRenderCommands();
+	R_FinishImagePrefetch();
+	R_SaveImageCacheIndex();
 	if (!ri.Sys_LowPhysicalMemory()) {
 		RB_ShowImages();
 	}
@@ -2263,6 +2245,7 @@ Q_EXPORT refexport_t* QDECL GetRefAPI ( int apiVersion, refimport_t *rimp ) {
 	re.RegisterModels_LevelLoadEnd = C_Models_LevelLoadEnd;
 
 	re.TakeVideoFrame = RE_TakeVideoFrame;
+	re.FinishVideoFrames = RE_FinishVideoFrames;
 
 	re.InitSkins							= R_InitSkins;
 	re.InitShaders							= R_InitShaders;
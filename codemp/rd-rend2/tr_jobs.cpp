@@ -0,0 +1,203 @@
+/*
+===========================================================================
+Copyright (C) 2026, OpenJK contributors
+
+This file is part of the OpenJK source code.
+
+OpenJK is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License version 2 as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, see <http://www.gnu.org/licenses/>.
+===========================================================================
+*/
+
+#include "tr_local.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#define MAX_JOB_THREADS 16
+
+namespace
+{
+	struct jobPool_t
+	{
+		std::vector<std::thread>	workers;
+		std::mutex					mutex;
+		std::condition_variable		wake;		// a new job or shutdown
+		std::condition_variable		done;		// the last worker left the job
+
+		// the current R_ParallelFor call, set under the mutex
+		jobFunc_t					job = nullptr;
+		void						*data = nullptr;
+		int							count = 0;
+		std::atomic<int>			nextIndex{ 0 };
+		int							generation = 0;
+		int							busy = 0;	// workers yet to finish it
+
+		bool						shutdown = false;
+	};
+
+	jobPool_t pool;
+}
+
+/*
+================
+R_NumJobThreads
+
+Number of threads (including the calling thread) R_ParallelFor spreads
+its work over.
+================
+*/
+int R_NumJobThreads( void )
+{
+	int numThreads = r_jobThreads->integer;
+	if ( numThreads <= 0 )
+	{
+		numThreads = (int)std::thread::hardware_concurrency();
+	}
+
+	return Com_Clampi(1, MAX_JOB_THREADS, numThreads);
+}
+
+static void R_RunJobs( std::atomic<int> *nextIndex, int count, jobFunc_t job, void *data )
+{
+	for ( int i = (*nextIndex)++; i < count; i = (*nextIndex)++ )
+	{
+		job(data, i);
+	}
+}
+
+static void R_JobWorkerMain( void )
+{
+	int generation = 0;
+
+	for ( ;; )
+	{
+		std::unique_lock<std::mutex> lock(pool.mutex);
+		pool.wake.wait(lock, [&] {
+			return pool.shutdown || pool.generation != generation;
+		});
+
+		if ( pool.shutdown )
+		{
+			break;
+		}
+
+		generation = pool.generation;
+		const jobFunc_t job = pool.job;
+		void *data = pool.data;
+		const int count = pool.count;
+		lock.unlock();
+
+		R_RunJobs(&pool.nextIndex, count, job, data);
+
+		lock.lock();
+		if ( --pool.busy == 0 )
+		{
+			pool.done.notify_one();
+		}
+	}
+}
+
+/*
+================
+R_InitJobThreads
+
+Starts the worker threads R_ParallelFor hands work to. They sleep between
+calls, so there's no cost in keeping them for the renderer's lifetime.
+================
+*/
+void R_InitJobThreads( void )
+{
+	R_ShutdownJobThreads();
+
+	// workers start out at generation 0, so the pool has to as well or a
+	// restarted worker would pick up the previous call's job
+	pool.shutdown = false;
+	pool.generation = 0;
+	pool.busy = 0;
+
+	const int numWorkers = R_NumJobThreads() - 1;
+	for ( int i = 0; i < numWorkers; i++ )
+	{
+		try
+		{
+			pool.workers.emplace_back(R_JobWorkerMain);
+		}
+		catch ( const std::system_error& )
+		{
+			// make do with the ones we have
+			break;
+		}
+	}
+}
+
+void R_ShutdownJobThreads( void )
+{
+	if ( pool.workers.empty() )
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(pool.mutex);
+		pool.shutdown = true;
+	}
+	pool.wake.notify_all();
+
+	for ( auto& worker : pool.workers )
+	{
+		worker.join();
+	}
+	pool.workers.clear();
+}
+
+/*
+================
+R_ParallelFor
+
+Calls job(data, i) for every i in [0, count) and returns once all of them
+are done. Indices are handed out to the worker threads one at a time, so
+jobs of very different sizes still balance out. Jobs must not call back
+into the engine through ri, and must not call R_ParallelFor themselves.
+================
+*/
+void R_ParallelFor( int count, jobFunc_t job, void *data )
+{
+	if ( count <= 1 || pool.workers.empty() )
+	{
+		for ( int i = 0; i < count; i++ )
+		{
+			job(data, i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(pool.mutex);
+		pool.job = job;
+		pool.data = data;
+		pool.count = count;
+		pool.nextIndex = 0;
+		pool.busy = (int)pool.workers.size();
+		pool.generation++;
+	}
+	pool.wake.notify_all();
+
+	R_RunJobs(&pool.nextIndex, count, job, data);
+
+	std::unique_lock<std::mutex> lock(pool.mutex);
+	pool.done.wait(lock, [] { return pool.busy == 0; });
+}
@@ -287,6 +287,13 @@ Ghoul2 Insert End
 */
 
 extern cvar_t	*r_patchStitching;
+extern cvar_t	*r_tangentCache;
+extern cvar_t	*r_tangentCacheSize;
+extern cvar_t	*r_imageCache;
+extern cvar_t	*r_imageCacheSize;
+extern cvar_t	*r_imagePrefetch;
+extern cvar_t	*r_jobThreads;
+extern cvar_t	*r_simd;
 
 /*
 End Cvars
@@ -1541,6 +1548,18 @@ enum viewParmType_t {
 	VPT_ALL
 };
 
+// the view frustum laid out for culling with one plane per SIMD lane, so
+// a bounding volume is tested against four of them at once. Unused lanes
+// hold a plane that everything is in front of.
+#define MAX_CULL_PLANES 8
+
+typedef struct cullPlanes_s {
+	float	normal[3][MAX_CULL_PLANES];
+	float	absNormal[3][MAX_CULL_PLANES];
+	float	dist[MAX_CULL_PLANES];
+	int		numGroups;			// of four planes
+} cullPlanes_t;
+
 typedef struct {
 	orientationr_t	ori;
 	orientationr_t	world;
@@ -1559,6 +1578,7 @@ typedef struct {
 	float			fovX, fovY;
 	float			projectionMatrix[16];
 	cplane_t		frustum[5];
+	cullPlanes_t	cullPlanes;			// built from frustum by R_SetupCullPlanes
 	vec3_t			visBounds[2];
 	float			zFar;
 	float			zNear;
@@ -1952,6 +1972,7 @@ typedef struct {
 	char		baseName[MAX_QPATH];	// ie: tim_dm2
 
 	int			dataSize;
+	uint32_t	checksum;		// of the .bsp file, seeds the tangent cache
 
 	int			numShaders;
 	dshader_t	*shaders;
@@ -2855,6 +2876,9 @@ bool R_IsPostRenderEntity ( const trRefEntity_t *refEntity );
 void R_CalcMikkTSpaceBSPSurface(int numSurfaces, packedVertex_t *vertices, glIndex_t *indices);
 void R_CalcMikkTSpaceMD3Surface(int numSurfaces, mdvVertex_t *verts, uint32_t *tangents, mdvSt_t *texcoords, glIndex_t *indices);
 void R_CalcMikkTSpaceGlmSurface(int numSurfaces, mdxmVertex_t *vertices, mdxmVertexTexCoord_t *textureCoordinates, uint32_t *tangents, glIndex_t *indices);
+uint32_t R_TangentCacheChecksum( const void *data, size_t size, uint32_t checksum );
+qboolean R_LoadCachedTangents( const char *name, int index, uint32_t checksum, uint32_t *tangents, int numTangents );
+void R_SaveCachedTangents( const char *name, int index, uint32_t checksum, const uint32_t *tangents, int numTangents );
 
 void R_CalcTexDirs(vec3_t sdir, vec3_t tdir, const vec3_t v1, const vec3_t v2,
 					const vec3_t v3, const vec2_t w1, const vec2_t w2, const vec2_t w3);
@@ -2868,6 +2892,11 @@ void R_LocalNormalToWorld (const vec3_t local, vec3_t world);
 void R_LocalPointToWorld (const vec3_t local, vec3_t world);
 int R_CullBox (vec3_t bounds[2]);
 int R_CullLocalBox (vec3_t bounds[2]);
+void R_LocalBoundsToWorld (vec3_t localBounds[2], vec3_t worldBounds[2]);
+void R_SetupCullPlanes( viewParms_t *dest );
+int R_CullBoxFrustumPlanes( const vec3_t mins, const vec3_t maxs, const cullPlanes_t *planes, int planeBits );
+void R_CullBoxes( int count, const vec3_t *mins, const vec3_t *maxs, const cullPlanes_t *planes, int planeBits, int *results );
+void R_CullSpheres( int count, const vec3_t *origins, const float *radii, const cullPlanes_t *planes, int planeBits, int *results );
 int R_CullPointAndRadiusEx( const vec3_t origin, float radius, const cplane_t* frustum, int numPlanes );
 int R_CullPointAndRadius( const vec3_t origin, float radius );
 int R_CullLocalPointAndRadius( const vec3_t origin, float radius );
@@ -2939,6 +2968,7 @@ void	R_FontList_f( void );
 const void *RB_TakeScreenshotCmd( const void *data );
 
 void R_SaveScreenshot(struct screenshotReadback_t *screenshotReadback);
+void R_QueueVideoReadback(struct videoReadback_t *videoReadback);
 
 void	R_ScreenShotTGA_f( void );
 void	R_ScreenShotPNG_f( void );
@@ -2972,6 +3002,7 @@ shader_t	*R_FindShader( const char *name, const int *lightmapIndexes, const byte
 shader_t	*R_GetShaderByHandle( qhandle_t hShader );
 shader_t *R_FindShaderByName( const char *name );
 void		R_InitShaders( qboolean server );
+void		R_PrefetchShaderImages( const dshader_t *shaders, int numShaders );
 void		R_ShaderList_f( void );
 void    R_RemapShader(const char *oldShader, const char *newShader, const char *timeOffset);
 shader_t *R_CreateShaderFromTextureBundle(
@@ -3444,6 +3475,21 @@ float	RB_CalcWaveColorSingle( const waveForm_t *wf );
 /*
 =============================================================
 
+JOBS
+
+=============================================================
+*/
+
+typedef void (*jobFunc_t)( void *data, int index );
+
+int R_NumJobThreads( void );
+void R_InitJobThreads( void );
+void R_ShutdownJobThreads( void );
+void R_ParallelFor( int count, jobFunc_t job, void *data );
+
+/*
+=============================================================
+
 RENDERER BACK END FUNCTIONS
 
 =============================================================
@@ -3540,8 +3586,6 @@ typedef struct videoFrameCommand_s {
 	int						commandId;
 	int						width;
 	int						height;
-	byte					*captureBuffer;
-	byte					*encodeBuffer;
 	qboolean			motionJpeg;
 } videoFrameCommand_t;
 
@@ -3621,6 +3665,17 @@ struct screenshotReadback_t
 	char filename[MAX_QPATH];
 };
 
+struct videoReadback_t
+{
+	GLuint pbo;
+	int pboSize;
+	int strideInBytes;
+	int width;
+	int height;
+	qboolean motionJpeg;
+	qboolean pending;
+};
+
 #define MAX_GPU_TIMERS (512)
 struct gpuFrame_t
 {
@@ -3632,6 +3687,7 @@ struct gpuFrame_t
 	void *uboMemory;
 
 	screenshotReadback_t screenshotReadback;
+	videoReadback_t videoReadback;
 
 	VBO_t *dynamicVbo;
 	void *dynamicVboMemory;
@@ -3697,8 +3753,8 @@ void RE_RotatePic2 ( float x, float y, float w, float h, float s1, float t1, flo
 void RE_BeginFrame( stereoFrame_t stereoFrame );
 void R_NewFrameSync();
 void RE_EndFrame( int *frontEndMsec, int *backEndMsec );
-void RE_TakeVideoFrame( int width, int height,
-		byte *captureBuffer, byte *encodeBuffer, qboolean motionJpeg );
+void RE_TakeVideoFrame( int width, int height, qboolean motionJpeg );
+void RE_FinishVideoFrames( void );
 
 // tr_ghoul2.cpp
 void Mat3x4_Multiply(mdxaBone_t *out, const mdxaBone_t *in2, const mdxaBone_t *in);
@@ -3725,6 +3781,12 @@ void RE_AddDecalToScene ( qhandle_t shader, const vec3_t origin, const vec3_t di
 void R_AddDecals( void );
 
 image_t	*R_FindImageFile( const char *name, imgType_t type, int flags );
+void R_BeginImagePrefetch( void );
+void R_PrefetchImage( const char *name );
+void R_EndImagePrefetch( void );
+void R_FinishImagePrefetch( void );
+void R_SaveImageCacheIndex( void );
+void R_UpdateImageCacheSaves( void );
 void R_LoadPackedMaterialImage(shaderStage_t *stage, const char *packedImageName, int flags);
 image_t *R_BuildSDRSpecGlossImage(shaderStage_t *stage, const char *specImageName, int flags);
 qhandle_t RE_RegisterShader( const char *name );
@@ -26,6 +26,11 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <string.h> // memcpy
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define R_CULL_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "ghoul2/g2_local.h"
 
 trGlobals_t		tr;
@@ -460,9 +465,6 @@ int R_CullLocalBox(vec3_t localBounds[2]) {
 
 	return CULL_CLIP;		// partially clipped
 #else
-	int             j;
-	vec3_t          transformed;
-	vec3_t          v;
 	vec3_t          worldBounds[2];
 
 	if(r_nocull->integer)
@@ -470,7 +472,24 @@ int R_CullLocalBox(vec3_t localBounds[2]) {
 		return CULL_CLIP;
 	}
 
-	// transform into world space
+	R_LocalBoundsToWorld(localBounds, worldBounds);
+
+	return R_CullBox(worldBounds);
+#endif
+}
+
+/*
+=================
+R_LocalBoundsToWorld
+
+Bounds around localBounds once they are moved into world space by tr.ori
+=================
+*/
+void R_LocalBoundsToWorld(vec3_t localBounds[2], vec3_t worldBounds[2]) {
+	int             j;
+	vec3_t          transformed;
+	vec3_t          v;
+
 	ClearBounds(worldBounds[0], worldBounds[1]);
 
 	for(j = 0; j < 8; j++)
@@ -483,9 +502,6 @@ int R_CullLocalBox(vec3_t localBounds[2]) {
 
 		AddPointToBounds(transformed, worldBounds[0], worldBounds[1]);
 	}
-
-	return R_CullBox(worldBounds);
-#endif
 }
 
 /*
@@ -496,90 +512,261 @@ Returns CULL_IN, CULL_CLIP, or CULL_OUT
 =================
 */
 int R_CullBox(vec3_t worldBounds[2]) {
-	int             i;
-	cplane_t       *frust;
-	qboolean        anyClip;
-	int             r, numPlanes;
+	int result;
 
-	numPlanes = (tr.viewParms.flags & VPF_FARPLANEFRUSTUM) ? 5 : 4;
+	R_CullBoxes(1, &worldBounds[0], &worldBounds[1], &tr.viewParms.cullPlanes,
+		(tr.viewParms.flags & VPF_FARPLANEFRUSTUM) ? 31 : 15, &result);
 
-	// check against frustum planes
-	anyClip = qfalse;
-	for(i = 0; i < numPlanes; i++)
+	return result;
+}
+
+/*
+=================
+Frustum culling
+
+Volumes are tested against the per-view cullPlanes_t, which
+R_SetupCullPlanes builds whenever the frustum of a view changes.
+=================
+*/
+static void R_BuildCullPlanes( const cplane_t *frustum, int numPlanes, cullPlanes_t *planes )
+{
+	assert(numPlanes <= MAX_CULL_PLANES);
+
+	planes->numGroups = (numPlanes + 3) / 4;
+	for ( int i = 0; i < planes->numGroups * 4; i++ )
 	{
-		frust = &tr.viewParms.frustum[i];
+		for ( int j = 0; j < 3; j++ )
+		{
+			planes->normal[j][i] = (i < numPlanes) ? frustum[i].normal[j] : 0.0f;
+			planes->absNormal[j][i] = fabsf(planes->normal[j][i]);
+		}
+		planes->dist[i] = (i < numPlanes) ? frustum[i].dist : -1e30f;
+	}
+}
+
+void R_SetupCullPlanes( viewParms_t *dest )
+{
+	R_BuildCullPlanes(dest->frustum, (dest->flags & VPF_FARPLANEFRUSTUM) ? 5 : 4, &dest->cullPlanes);
+}
+
+/*
+=================
+R_CullPlaneBits
 
-		r = BoxOnPlaneSide(worldBounds[0], worldBounds[1], frust);
+Returns a bit for each plane in planeBits that the volume with the given
+center and extent along the planes is completely behind in *back, and one
+for each it is completely in front of in *front. Planes outside planeBits
+are skipped, four at a time where SIMD is used.
+=================
+*/
+static void R_CullPlaneBits( const cullPlanes_t *planes, int planeBits, const float *center, float radius,
+	const float *extents, int *front, int *back )
+{
+	*front = *back = 0;
 
-		if(r == 2)
+#ifdef R_CULL_SSE2
+	if ( r_simd->integer )
+	{
+		const __m128 cx = _mm_set1_ps(center[0]);
+		const __m128 cy = _mm_set1_ps(center[1]);
+		const __m128 cz = _mm_set1_ps(center[2]);
+		__m128 ex = _mm_setzero_ps(), ey = _mm_setzero_ps(), ez = _mm_setzero_ps();
+		if ( extents )
 		{
-			// completely outside frustum
-			return CULL_OUT;
+			ex = _mm_set1_ps(extents[0]);
+			ey = _mm_set1_ps(extents[1]);
+			ez = _mm_set1_ps(extents[2]);
+		}
+		const __m128 r = _mm_set1_ps(radius);
+
+		for ( int g = 0; g < planes->numGroups; g++ )
+		{
+			const int o = g * 4;
+			if ( !((planeBits >> o) & 15) )
+			{
+				continue;
+			}
+
+			__m128 dist = _mm_mul_ps(cx, _mm_loadu_ps(&planes->normal[0][o]));
+			dist = _mm_add_ps(dist, _mm_mul_ps(cy, _mm_loadu_ps(&planes->normal[1][o])));
+			dist = _mm_add_ps(dist, _mm_mul_ps(cz, _mm_loadu_ps(&planes->normal[2][o])));
+			dist = _mm_sub_ps(dist, _mm_loadu_ps(&planes->dist[o]));
+
+			__m128 reach = r;
+			reach = _mm_add_ps(reach, _mm_mul_ps(ex, _mm_loadu_ps(&planes->absNormal[0][o])));
+			reach = _mm_add_ps(reach, _mm_mul_ps(ey, _mm_loadu_ps(&planes->absNormal[1][o])));
+			reach = _mm_add_ps(reach, _mm_mul_ps(ez, _mm_loadu_ps(&planes->absNormal[2][o])));
+
+			*back |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, reach), _mm_setzero_ps())) << o;
+			*front |= _mm_movemask_ps(_mm_cmpge_ps(_mm_sub_ps(dist, reach), _mm_setzero_ps())) << o;
+		}
+		*back &= planeBits;
+		*front &= planeBits;
+		return;
+	}
+#endif
+
+	for ( int i = 0; i < planes->numGroups * 4; i++ )
+	{
+		if ( !(planeBits & (1 << i)) )
+		{
+			continue;
+		}
+
+		const float dist = center[0] * planes->normal[0][i] + center[1] * planes->normal[1][i]
+			+ center[2] * planes->normal[2][i] - planes->dist[i];
+		float reach = radius;
+		if ( extents )
+		{
+			reach += extents[0] * planes->absNormal[0][i] + extents[1] * planes->absNormal[1][i]
+				+ extents[2] * planes->absNormal[2][i];
 		}
-		if(r == 3)
+
+		if ( dist + reach < 0.0f )
+		{
+			*back |= 1 << i;
+		}
+		if ( dist - reach >= 0.0f )
 		{
-			anyClip = qtrue;
+			*front |= 1 << i;
 		}
 	}
+}
+
+static int R_CullResult( int planeBits, int front, int back )
+{
+	if ( back )
+	{
+		return CULL_OUT;
+	}
 
-	if(!anyClip)
+	if ( front != planeBits )
 	{
-		// completely inside frustum
-		return CULL_IN;
+		return CULL_CLIP;
 	}
 
-	// partially clipped
-	return CULL_CLIP;
+	return CULL_IN;
 }
 
 /*
-** R_CullLocalPointAndRadius
+=================
+R_CullBoxFrustumPlanes
+
+Tests a box against the planes in planeBits at once. Returns -1 if the box
+is completely behind one of them, otherwise planeBits without the planes
+the box is completely in front of.
+=================
 */
-int R_CullLocalPointAndRadius( const vec3_t pt, float radius )
+int R_CullBoxFrustumPlanes( const vec3_t mins, const vec3_t maxs, const cullPlanes_t *planes, int planeBits )
 {
-	vec3_t transformed;
+	vec3_t center, extents;
+	int front, back;
 
-	R_LocalPointToWorld( pt, transformed );
+	if ( !planeBits )
+	{
+		return 0;
+	}
 
-	return R_CullPointAndRadius( transformed, radius );
+	VectorAdd(mins, maxs, center);
+	VectorScale(center, 0.5f, center);
+	VectorSubtract(maxs, center, extents);
+
+	R_CullPlaneBits(planes, planeBits, center, 0.0f, extents, &front, &back);
+	if ( back )
+	{
+		return -1;
+	}
+
+	return planeBits & ~front;
 }
 
 /*
-** R_CullPointAndRadius
+=================
+R_CullBoxes
+
+Culls a batch of boxes against the planes in planeBits, writing CULL_IN,
+CULL_CLIP or CULL_OUT for each of them to results.
+=================
 */
-int R_CullPointAndRadiusEx( const vec3_t pt, float radius, const cplane_t* frustum, int numPlanes )
+void R_CullBoxes( int count, const vec3_t *mins, const vec3_t *maxs,
+	const cullPlanes_t *planes, int planeBits, int *results )
 {
-	int		i;
-	float	dist;
-	const cplane_t	*frust;
-	qboolean mightBeClipped = qfalse;
+	vec3_t center, extents;
+	int front, back;
 
-	if ( r_nocull->integer ) {
-		return CULL_CLIP;
+	if ( r_nocull->integer )
+	{
+		for ( int i = 0; i < count; i++ )
+		{
+			results[i] = CULL_CLIP;
+		}
+		return;
 	}
 
-	// check against frustum planes
-	for (i = 0 ; i < numPlanes ; i++)
+	for ( int i = 0; i < count; i++ )
 	{
-		frust = &frustum[i];
+		VectorAdd(mins[i], maxs[i], center);
+		VectorScale(center, 0.5f, center);
+		VectorSubtract(maxs[i], center, extents);
 
-		dist = DotProduct( pt, frust->normal) - frust->dist;
-		if ( dist < -radius )
-		{
-			return CULL_OUT;
-		}
-		else if ( dist <= radius )
+		R_CullPlaneBits(planes, planeBits, center, 0.0f, extents, &front, &back);
+		results[i] = R_CullResult(planeBits, front, back);
+	}
+}
+
+/*
+=================
+R_CullSpheres
+
+Culls a batch of spheres against the planes in planeBits, writing CULL_IN,
+CULL_CLIP or CULL_OUT for each of them to results.
+=================
+*/
+void R_CullSpheres( int count, const vec3_t *origins, const float *radii,
+	const cullPlanes_t *planes, int planeBits, int *results )
+{
+	int front, back;
+
+	if ( r_nocull->integer )
+	{
+		for ( int i = 0; i < count; i++ )
 		{
-			mightBeClipped = qtrue;
+			results[i] = CULL_CLIP;
 		}
+		return;
 	}
 
-	if ( mightBeClipped )
+	for ( int i = 0; i < count; i++ )
 	{
-		return CULL_CLIP;
+		R_CullPlaneBits(planes, planeBits, origins[i], radii[i], NULL, &front, &back);
+		results[i] = R_CullResult(planeBits, front, back);
 	}
+}
+
+/*
+** R_CullLocalPointAndRadius
+*/
+int R_CullLocalPointAndRadius( const vec3_t pt, float radius )
+{
+	vec3_t transformed;
+
+	R_LocalPointToWorld( pt, transformed );
 
-	return CULL_IN;		// completely inside frustum
+	return R_CullPointAndRadius( transformed, radius );
+}
+
+/*
+** R_CullPointAndRadius
+*/
+int R_CullPointAndRadiusEx( const vec3_t pt, float radius, const cplane_t* frustum, int numPlanes )
+{
+	cullPlanes_t planes;
+	int result;
+
+	R_BuildCullPlanes(frustum, numPlanes, &planes);
+	R_CullSpheres(1, (const vec3_t *)pt, &radius, &planes, (1 << numPlanes) - 1, &result);
+
+	return result;
 }
 
 /*
@@ -587,7 +774,12 @@ int R_CullPointAndRadiusEx( const vec3_t pt, float radius, const cplane_t* frust
 */
 int R_CullPointAndRadius( const vec3_t pt, float radius )
 {
-	return R_CullPointAndRadiusEx(pt, radius, tr.viewParms.frustum, (tr.viewParms.flags & VPF_FARPLANEFRUSTUM) ? 5 : 4);
+	int result;
+
+	R_CullSpheres(1, (const vec3_t *)pt, &radius, &tr.viewParms.cullPlanes,
+		(tr.viewParms.flags & VPF_FARPLANEFRUSTUM) ? 31 : 15, &result);
+
+	return result;
 }
 
 /*
@@ -952,6 +1144,8 @@ void R_SetupFrustum (viewParms_t *dest, float xmin, float xmax, float ymax, floa
 		SetPlaneSignbits( &dest->frustum[4] );
 		dest->flags |= VPF_FARPLANEFRUSTUM;
 	}
+
+	R_SetupCullPlanes(dest);
 }
 
 /*
@@ -1135,6 +1329,7 @@ void R_SetupProjectionOrtho(viewParms_t *dest, const vec3_t viewBounds[2])
 	}
 
 	dest->flags |= VPF_FARPLANEFRUSTUM;
+	R_SetupCullPlanes(dest);
 }
 
 /*
@@ -1996,9 +2191,39 @@ static void R_AddEntitySurfaces(const trRefdef_t *refdef)
 		}
 	}
 
+	// sprites are culled by their bounding spheres, all at once
+	static vec3_t spriteOrigins[MAX_REFENTITIES];
+	static float spriteRadii[MAX_REFENTITIES];
+	static int spriteCull[MAX_REFENTITIES];
+	int numSprites = 0;
+
+	for (int i = entityStart; i < numEntities; i++)
+	{
+		const refEntity_t *e = &refdef->entities[i].e;
+		if (e->reType == RT_SPRITE || e->reType == RT_ORIENTED_QUAD)
+		{
+			// the corners of the quad are up to sqrt(2) * radius away
+			VectorCopy(e->origin, spriteOrigins[numSprites]);
+			spriteRadii[numSprites] = e->radius * 1.5f;
+			numSprites++;
+		}
+	}
+
+	R_CullSpheres(numSprites, spriteOrigins, spriteRadii, &tr.viewParms.cullPlanes,
+		(tr.viewParms.flags & VPF_FARPLANEFRUSTUM) ? 31 : 15, spriteCull);
+
+	numSprites = 0;
 	for (int i = entityStart; i < numEntities; i++)
 	{
 		trRefEntity_t *ent = refdef->entities + i;
+		if (ent->e.reType == RT_SPRITE || ent->e.reType == RT_ORIENTED_QUAD)
+		{
+			if (spriteCull[numSprites++] == CULL_OUT)
+			{
+				ent->needDlights = qfalse;
+				continue;
+			}
+		}
 		R_AddEntitySurface(refdef, ent, i);
 	}
 }
@@ -2850,6 +3075,7 @@ void R_GatherFrameViews(trRefdef_t *refdef)
 						}
 
 						dest->flags |= VPF_FARPLANEFRUSTUM;
+						R_SetupCullPlanes(dest);
 					}
 
 					tr.viewParms.currentViewParm = tr.numCachedViewParms;
@@ -816,6 +816,26 @@ qhandle_t RE_RegisterServerModel( const char *name ) {
 	return hModel;
 }
 
+struct md3TangentJob_t
+{
+	mdvModel_t *mdvModel;
+	uint32_t *tangents;
+	const int *baseVertexes;
+};
+
+static void R_CalcMD3SurfaceTangents( void *data, int index )
+{
+	md3TangentJob_t *job = (md3TangentJob_t *)data;
+	mdvSurface_t *surf = job->mdvModel->surfaces + index;
+
+	R_CalcMikkTSpaceMD3Surface(
+		surf->numIndexes / 3,
+		surf->verts,
+		job->tangents + job->baseVertexes[index],
+		surf->st,
+		surf->indexes);
+}
+
 /*
 =================
 R_LoadMD3
@@ -1120,21 +1140,36 @@ static qboolean R_LoadMD3(model_t * mod, int lod, void *buffer, const char *modN
 		tangents = (uint32_t *)(data + ofsTangents);
 		stride += sizeof(*tangents);
 
-		// Fill in the index buffer and compute tangents
+		// Compute tangents, or reuse them from an earlier load
+		uint32_t *tangentsf = (uint32_t *)ri.Hunk_AllocateTempMemory(sizeof(uint32_t) * numVerts);
+		uint32_t checksum = 0;
+
+		surf = mdvModel->surfaces;
+		for (i = 0; i < mdvModel->numSurfaces; i++, surf++)
+		{
+			checksum = R_TangentCacheChecksum(surf->verts, sizeof(*surf->verts) * surf->numVerts, checksum);
+			checksum = R_TangentCacheChecksum(surf->st, sizeof(*surf->st) * surf->numVerts, checksum);
+			checksum = R_TangentCacheChecksum(surf->indexes, sizeof(*surf->indexes) * surf->numIndexes, checksum);
+		}
+
+		if (!R_LoadCachedTangents(modName, lod, checksum, tangentsf, numVerts))
+		{
+			md3TangentJob_t tangentJob;
+			tangentJob.mdvModel = mdvModel;
+			tangentJob.tangents = tangentsf;
+			tangentJob.baseVertexes = baseVertexes;
+			R_ParallelFor(mdvModel->numSurfaces, R_CalcMD3SurfaceTangents, &tangentJob);
+
+			R_SaveCachedTangents(modName, lod, checksum, tangentsf, numVerts);
+		}
+
+		// Fill in the index buffer
 		glIndex_t *indices = (glIndex_t *)ri.Hunk_AllocateTempMemory(sizeof(glIndex_t) * numIndexes);
 		glIndex_t *index = indices;
 
 		surf = mdvModel->surfaces;
 		for (i = 0; i < mdvModel->numSurfaces; i++, surf++)
 		{
-			uint32_t *tangentsf = (uint32_t *)ri.Hunk_AllocateTempMemory(sizeof(uint32_t) * surf->numVerts);
-			R_CalcMikkTSpaceMD3Surface(
-				surf->numIndexes / 3,
-				surf->verts,
-				tangentsf,
-				surf->st,
-				surf->indexes);
-
 			for (int k = 0; k < surf->numIndexes; k++)
 			{
 				*index = surf->indexes[k] + baseVertexes[i];
@@ -1147,13 +1182,12 @@ static qboolean R_LoadMD3(model_t * mod, int lod, void *buffer, const char *modN
 			{
 				VectorCopy(v->xyz, *verts);
 				*normals = R_VboPackNormal(v->normal);
-				*tangents = tangentsf[j];
+				*tangents = tangentsf[baseVertexes[i] + j];
 
 				verts = (vec3_t *)((byte *)verts + stride);
 				normals = (uint32_t *)((byte *)normals + stride);
 				tangents = (uint32_t *)((byte *)tangents + stride);
 			}
-			ri.Hunk_FreeTempMemory(tangentsf);
 
 			st = surf->st;
 			for (j = 0; j < surf->numVerts; j++, st++) {
@@ -1169,8 +1203,9 @@ static qboolean R_LoadMD3(model_t * mod, int lod, void *buffer, const char *modN
 		VBO_t *vbo = R_CreateVBO(data, dataSize, VBO_USAGE_STATIC);
 		IBO_t *ibo = R_CreateIBO((byte *)indices, sizeof(glIndex_t) * numIndexes, VBO_USAGE_STATIC);
 
-		ri.Hunk_FreeTempMemory(data);
 		ri.Hunk_FreeTempMemory(indices);
+		ri.Hunk_FreeTempMemory(tangentsf);
+		ri.Hunk_FreeTempMemory(data);
 
 		vbo->offsets[ATTR_INDEX_POSITION] = ofsPosition;
 		vbo->offsets[ATTR_INDEX_NORMAL] = ofsNormals;
@@ -39,7 +39,18 @@ static	texModInfo_t	texMods[MAX_SHADER_STAGES][TR_MAX_TEXMODS];
 static	shader_t*		hashTable[FILE_HASH_SIZE];
 
 #define MAX_SHADERTEXT_HASH		2048
-static char **shaderTextHashTable[MAX_SHADERTEXT_HASH] = { 0 };
+
+// Every shader definition in s_shaderText is indexed by name when the shader
+// files are scanned, so looking one up never has to re-parse any text. Each
+// bucket is terminated by an entry with a NULL name.
+// The index points into s_shaderText, which is read from the shader files on
+// every load anyway, so it is rebuilt along with it rather than kept on disk.
+typedef struct shaderTextEntry_s {
+	const char	*name;
+	const char	*text;	// points just past the name, at the opening brace
+} shaderTextEntry_t;
+
+static shaderTextEntry_t *shaderTextHashTable[MAX_SHADERTEXT_HASH] = { 0 };
 
 const int lightmapsNone[MAXLIGHTMAPS] =
 {
@@ -4209,24 +4220,21 @@ If found, it will return a valid shader
 =====================
 */
 static const char *FindShaderInShaderText( const char *shadername ) {
-
 	char *token;
 	const char *p;
+	const shaderTextEntry_t *entry;
 
-	int i, hash;
+	int hash;
 
 	hash = generateHashValue(shadername, MAX_SHADERTEXT_HASH);
 
-	if(shaderTextHashTable[hash])
-	{
-		for (i = 0; shaderTextHashTable[hash][i]; i++)
-		{
-			p = shaderTextHashTable[hash][i];
-			token = COM_ParseExt(&p, qtrue);
-
-			if(!Q_stricmp(token, shadername))
-				return p;
+	if ( shaderTextHashTable[hash] ) {
+		// the index covers every definition, so a miss here is final
+		for ( entry = shaderTextHashTable[hash]; entry->name; entry++ ) {
+			if ( !Q_stricmp( entry->name, shadername ) )
+				return entry->text;
 		}
+		return NULL;
 	}
 
 	p = s_shaderText;
@@ -4255,6 +4263,59 @@ static const char *FindShaderInShaderText( const char *shadername ) {
 }
 
 
+/*
+====================
+R_PrefetchShaderImages
+
+Queues the images named by the given shaders for decoding on worker
+threads, so they are ready by the time the shaders are parsed.
+====================
+*/
+void R_PrefetchShaderImages( const dshader_t *shaders, int numShaders ) {
+	char strippedName[MAX_QPATH];
+	const char *p;
+	char *token;
+	int i, depth;
+
+	R_BeginImagePrefetch();
+
+	for ( i = 0; i < numShaders; i++ ) {
+		COM_StripExtension( shaders[i].shader, strippedName, sizeof( strippedName ) );
+
+		p = FindShaderInShaderText( strippedName );
+		if ( !p ) {
+			// an implicit shader is just its image
+			R_PrefetchImage( shaders[i].shader );
+			continue;
+		}
+
+		depth = 0;
+		while ( 1 ) {
+			token = COM_ParseExt( &p, qtrue );
+			if ( !token[0] ) {
+				break;
+			}
+
+			if ( token[0] == '{' ) {
+				depth++;
+			} else if ( token[0] == '}' ) {
+				if ( --depth <= 0 ) {
+					break;
+				}
+			} else if ( !Q_stricmp( token, "map" ) || !Q_stricmp( token, "clampmap" ) ||
+				!Q_stricmp( token, "normalMap" ) || !Q_stricmp( token, "normalHeightMap" ) ) {
+				token = COM_ParseExt( &p, qfalse );
+				if ( token[0] && token[0] != '$' ) {
+					R_PrefetchImage( token );
+				}
+			}
+		}
+	}
+
+	R_EndImagePrefetch();
+}
+
+
 /*
 ==================
 R_FindShaderByName
@@ -4860,8 +4921,9 @@ static void ScanAndLoadShaderFiles( void )
 	const char *p;
 	int numShaderFiles;
 	int i;
-	char *oldp, *token, *hashMem, *textEnd;
-	int shaderTextHashTableSizes[MAX_SHADERTEXT_HASH], hash, size;
+	char *token, *hashMem, *nameMem, *textEnd;
+	int shaderTextHashTableSizes[MAX_SHADERTEXT_HASH], hash, size, nameSize, nameLength;
+	shaderTextEntry_t *entry;
 	char shaderName[MAX_QPATH];
 	int shaderLine;
 
@@ -4980,6 +5042,7 @@ static void ScanAndLoadShaderFiles( void )
 
 	Com_Memset(shaderTextHashTableSizes, 0, sizeof(shaderTextHashTableSizes));
 	size = 0;
+	nameSize = 0;
 
 	p = s_shaderText;
 	// look for shader names
@@ -4992,16 +5055,19 @@ static void ScanAndLoadShaderFiles( void )
 		hash = generateHashValue(token, MAX_SHADERTEXT_HASH);
 		shaderTextHashTableSizes[hash]++;
 		size++;
+		nameSize += strlen(token) + 1;
 		SkipBracedSection(&p, 0);
 	}
 
 	size += MAX_SHADERTEXT_HASH;
 
-	hashMem = (char *)ri.Hunk_Alloc( size * sizeof(char *), h_low );
+	// the entries and a copy of every name share one allocation
+	hashMem = (char *)ri.Hunk_Alloc( size * sizeof(shaderTextEntry_t) + nameSize, h_low );
+	nameMem = hashMem + size * sizeof(shaderTextEntry_t);
 
 	for (i = 0; i < MAX_SHADERTEXT_HASH; i++) {
-		shaderTextHashTable[i] = (char **) hashMem;
-		hashMem = ((char *) hashMem) + ((shaderTextHashTableSizes[i] + 1) * sizeof(char *));
+		shaderTextHashTable[i] = (shaderTextEntry_t *) hashMem;
+		hashMem = ((char *) hashMem) + ((shaderTextHashTableSizes[i] + 1) * sizeof(shaderTextEntry_t));
 	}
 
 	Com_Memset(shaderTextHashTableSizes, 0, sizeof(shaderTextHashTableSizes));
@@ -5009,14 +5075,19 @@ static void ScanAndLoadShaderFiles( void )
 	p = s_shaderText;
 	// look for shader names
 	while ( 1 ) {
-		oldp = (char *)p;
 		token = COM_ParseExt( &p, qtrue );
 		if ( token[0] == 0 ) {
 			break;
 		}
 
 		hash = generateHashValue(token, MAX_SHADERTEXT_HASH);
-		shaderTextHashTable[hash][shaderTextHashTableSizes[hash]++] = oldp;
+		entry = &shaderTextHashTable[hash][shaderTextHashTableSizes[hash]++];
+
+		nameLength = strlen(token) + 1;
+		Com_Memcpy(nameMem, token, nameLength);
+		entry->name = nameMem;
+		entry->text = p;
+		nameMem += nameLength;
 
 		SkipBracedSection(&p, 0);
 	}
@@ -288,4 +288,179 @@ void R_CalcMikkTSpaceGlmSurface(int numSurfaces, mdxmVertex_t *vertices, mdxmVer
 	modelContext.m_pInterface = &tangentSpaceInterface;
 
 	genTangSpaceDefault(&modelContext);
-}
\ No newline at end of file
+}
+
+/*
+================
+Tangent cache
+
+MikkTSpace is by far the slowest part of building the static vertex
+buffers, so the packed tangents are written to disk once and read back on
+later loads. A cache file is only used if its checksum, which callers
+build from the mesh data fed to MikkTSpace, matches.
+
+Files are named after a hash of the model or map name so they all sit in
+one directory. r_tangentCacheSize bounds the directory: a save that would
+go over it removes every cache file first, and what is loaded afterwards
+fills the cache again.
+================
+*/
+#define TANGENT_CACHE_IDENT		(('N'<<24)+('A'<<16)+('T'<<8)+'R')
+#define TANGENT_CACHE_VERSION	1
+
+typedef struct tangentCacheHeader_s
+{
+	int			ident;
+	int			version;
+	uint32_t	checksum;
+	int			numTangents;
+} tangentCacheHeader_t;
+
+/*
+================
+R_TangentCacheChecksum
+
+FNV-1a over a block of memory. Pass the result of a previous call as
+checksum to extend it over several blocks, or 0 to start a new one.
+================
+*/
+uint32_t R_TangentCacheChecksum( const void *data, size_t size, uint32_t checksum )
+{
+	const byte *bytes = (const byte *)data;
+
+	if ( checksum == 0 )
+		checksum = 2166136261u;
+
+	for ( size_t i = 0; i < size; i++ )
+	{
+		checksum ^= bytes[i];
+		checksum *= 16777619u;
+	}
+
+	return checksum;
+}
+
+static struct {
+	qboolean	scanned;
+	long		size;		// bytes of cache files on disk
+} tangentCache;
+
+static void R_TangentCachePath( char *path, int pathSize, const char *name, int index )
+{
+	char lowerName[MAX_QPATH];
+
+	Q_strncpyz(lowerName, name, sizeof(lowerName));
+	Q_strlwr(lowerName);
+	Com_sprintf(path, pathSize, "tangentcache/%08x_%d.tan",
+		R_TangentCacheChecksum(lowerName, strlen(lowerName), 0), index);
+}
+
+static long R_TangentCacheFileSize( const char *path )
+{
+	const long size = ri.FS_ReadFile(path, NULL);
+	return size > 0 ? size : 0;
+}
+
+/*
+================
+R_ScanTangentCache
+
+Adds up the size of the cache files already on disk, or removes them all
+when clear is set.
+================
+*/
+static void R_ScanTangentCache( qboolean clear )
+{
+	int numFiles = 0;
+	char **files = ri.FS_ListFiles("tangentcache", ".tan", &numFiles);
+
+	tangentCache.scanned = qtrue;
+	tangentCache.size = 0;
+
+	for ( int i = 0; i < numFiles; i++ )
+	{
+		const char *path = va("tangentcache/%s", files[i]);
+
+		if ( clear )
+			ri.FS_HomeRemove(path);
+		else
+			tangentCache.size += R_TangentCacheFileSize(path);
+	}
+	ri.FS_FreeFileList(files);
+}
+
+qboolean R_LoadCachedTangents( const char *name, int index, uint32_t checksum, uint32_t *tangents, int numTangents )
+{
+	char path[MAX_QPATH];
+	union {
+		byte *b;
+		void *v;
+	} buffer;
+
+	if ( !r_tangentCache->integer )
+		return qfalse;
+
+	R_TangentCachePath(path, sizeof(path), name, index);
+	const long fileSize = ri.FS_ReadFile(path, &buffer.v);
+	if ( !buffer.b )
+		return qfalse;
+
+	const tangentCacheHeader_t *header = (const tangentCacheHeader_t *)buffer.b;
+	const size_t dataSize = sizeof(uint32_t) * numTangents;
+	qboolean valid =
+		(fileSize == (long)(sizeof(*header) + dataSize) &&
+			LittleLong(header->ident) == TANGENT_CACHE_IDENT &&
+			LittleLong(header->version) == TANGENT_CACHE_VERSION &&
+			(uint32_t)LittleLong(header->checksum) == checksum &&
+			LittleLong(header->numTangents) == numTangents) ? qtrue : qfalse;
+
+	if ( valid )
+	{
+		const uint32_t *cached = (const uint32_t *)(header + 1);
+		for ( int i = 0; i < numTangents; i++ )
+			tangents[i] = LittleLong(cached[i]);
+	}
+
+	ri.FS_FreeFile(buffer.v);
+	return valid;
+}
+
+void R_SaveCachedTangents( const char *name, int index, uint32_t checksum, const uint32_t *tangents, int numTangents )
+{
+	char path[MAX_QPATH];
+
+	if ( !r_tangentCache->integer )
+		return;
+
+	const int fileSize = sizeof(tangentCacheHeader_t) + sizeof(uint32_t) * numTangents;
+	byte *buffer = (byte *)ri.Hunk_AllocateTempMemory(fileSize);
+	tangentCacheHeader_t *header = (tangentCacheHeader_t *)buffer;
+	uint32_t *cached = (uint32_t *)(header + 1);
+
+	header->ident = LittleLong(TANGENT_CACHE_IDENT);
+	header->version = LittleLong(TANGENT_CACHE_VERSION);
+	header->checksum = LittleLong(checksum);
+	header->numTangents = LittleLong(numTangents);
+	for ( int i = 0; i < numTangents; i++ )
+		cached[i] = LittleLong(tangents[i]);
+
+	R_TangentCachePath(path, sizeof(path), name, index);
+
+	if ( !tangentCache.scanned )
+		R_ScanTangentCache(qfalse);
+
+	// a file being replaced no longer counts
+	tangentCache.size -= R_TangentCacheFileSize(path);
+
+	const long limit = (long)Q_max(r_tangentCacheSize->integer, 0) * 1024 * 1024;
+	if ( tangentCache.size + fileSize > limit )
+		R_ScanTangentCache(qtrue);
+
+	if ( fileSize <= limit )
+	{
+		ri.FS_WriteFile(path, buffer, fileSize);
+		tangentCache.size += fileSize;
+	}
+
+	ri.Hunk_FreeTempMemory(buffer);
+}
@@ -39,10 +39,11 @@ world_t *R_GetWorld(int worldIndex)
 R_CullSurface
 
 Tries to cull surfaces before they are lighted or
-added to the sorting list.
+added to the sorting list. boxCull is the result of
+R_FlushSurfaceBatch, or -1 if the box hasn't been tested yet.
 ================
 */
-static qboolean	R_CullSurface( msurface_t *surf, int entityNum ) {
+static qboolean	R_CullSurface( msurface_t *surf, int entityNum, int boxCull ) {
 	if ( r_nocull->integer || surf->cullinfo.type == CULLINFO_NONE) {
 		return qfalse;
 	}
@@ -129,9 +130,9 @@ static qboolean	R_CullSurface( msurface_t *surf, int entityNum ) {
 
 	if (surf->cullinfo.type & CULLINFO_BOX)
 	{
-		int boxCull;
-
-		if ( entityNum != REFENTITYNUM_WORLD ) {
+		if ( boxCull >= 0 ) {
+			// already tested with the rest of its batch
+		} else if ( entityNum != REFENTITYNUM_WORLD ) {
 			boxCull = R_CullLocalBox( surf->cullinfo.bounds );
 		} else {
 			boxCull = R_CullBox( surf->cullinfo.bounds );
@@ -328,12 +329,13 @@ static void R_AddWorldSurface(
 	const trRefEntity_t *entity,
 	int entityNum,
 	int dlightBits,
-	int pshadowBits)
+	int pshadowBits,
+	int boxCull)
 {
 	// FIXME: bmodel fog?
 
 	// try to cull before dlighting or adding
-	if ( R_CullSurface( surf, entityNum ) ) {
+	if ( R_CullSurface( surf, entityNum, boxCull ) ) {
 		return;
 	}
 
@@ -370,6 +372,89 @@ static void R_AddWorldSurface(
 	}
 }
 
+/*
+======================
+Surface batches
+
+Surfaces that pass the PVS and node culling are collected in batches so
+their bounding boxes can be frustum culled together by R_CullBoxes before
+they're added.
+======================
+*/
+#define SURFACE_BATCH_SIZE 256
+
+typedef struct surfaceBatch_s {
+	msurface_t	*surfs[SURFACE_BATCH_SIZE];
+	int			dlightBits[SURFACE_BATCH_SIZE];
+	int			pshadowBits[SURFACE_BATCH_SIZE];
+	int			numSurfs;
+} surfaceBatch_t;
+
+static void R_FlushSurfaceBatch( surfaceBatch_t *batch, const trRefEntity_t *entity, int entityNum )
+{
+	vec3_t mins[SURFACE_BATCH_SIZE], maxs[SURFACE_BATCH_SIZE];
+	int boxIndex[SURFACE_BATCH_SIZE];
+	int boxCull[SURFACE_BATCH_SIZE];
+	int surfCull[SURFACE_BATCH_SIZE];
+	int numBoxes = 0;
+
+	for ( int i = 0; i < batch->numSurfs; i++ )
+	{
+		msurface_t *surf = batch->surfs[i];
+
+		// R_CullSurface only box culls surfaces without a plane to cull by
+		surfCull[i] = -1;
+		if ( r_nocull->integer ||
+			(surf->cullinfo.type & (CULLINFO_PLANE | CULLINFO_BOX)) != CULLINFO_BOX ) {
+			continue;
+		}
+
+		if ( entityNum != REFENTITYNUM_WORLD ) {
+			vec3_t bounds[2];
+
+			R_LocalBoundsToWorld(surf->cullinfo.bounds, bounds);
+			VectorCopy(bounds[0], mins[numBoxes]);
+			VectorCopy(bounds[1], maxs[numBoxes]);
+		} else {
+			VectorCopy(surf->cullinfo.bounds[0], mins[numBoxes]);
+			VectorCopy(surf->cullinfo.bounds[1], maxs[numBoxes]);
+		}
+		boxIndex[numBoxes++] = i;
+	}
+
+	R_CullBoxes(numBoxes, mins, maxs, &tr.viewParms.cullPlanes,
+		(tr.viewParms.flags & VPF_FARPLANEFRUSTUM) ? 31 : 15, boxCull);
+
+	for ( int i = 0; i < numBoxes; i++ )
+	{
+		surfCull[boxIndex[i]] = boxCull[i];
+	}
+
+	for ( int i = 0; i < batch->numSurfs; i++ )
+	{
+		R_AddWorldSurface(batch->surfs[i], entity, entityNum,
+			batch->dlightBits[i], batch->pshadowBits[i], surfCull[i]);
+	}
+
+	batch->numSurfs = 0;
+}
+
+static void R_BatchWorldSurface(
+	surfaceBatch_t *batch,
+	msurface_t *surf,
+	const trRefEntity_t *entity,
+	int entityNum,
+	int dlightBits,
+	int pshadowBits)
+{
+	batch->surfs[batch->numSurfs] = surf;
+	batch->dlightBits[batch->numSurfs] = dlightBits;
+	batch->pshadowBits[batch->numSurfs] = pshadowBits;
+	if ( ++batch->numSurfs == SURFACE_BATCH_SIZE ) {
+		R_FlushSurfaceBatch(batch, entity, entityNum);
+	}
+}
+
 /*
 =============================================================
 
@@ -395,15 +480,18 @@ void R_AddBrushModelSurfaces ( trRefEntity_t *ent, int entityNum ) {
 		R_DlightBmodel( bmodel, ent );
 
 	world_t *world = R_GetWorld(bmodel->worldIndex);
+	surfaceBatch_t batch;
+	batch.numSurfs = 0;
 	for ( int i = 0 ; i < bmodel->numSurfaces ; i++ ) {
 		int surf = bmodel->firstSurface + i;
 
 		if (world->surfacesViewCount[surf] != tr.viewCount)
 		{
 			world->surfacesViewCount[surf] = tr.viewCount;
-			R_AddWorldSurface(world->surfaces + surf, ent, entityNum, ent->needDlights, 0);
+			R_BatchWorldSurface(&batch, world->surfaces + surf, ent, entityNum, ent->needDlights, 0);
 		}
 	}
+	R_FlushSurfaceBatch(&batch, ent, entityNum);
 }
 
 float GetQuadArea(vec3_t v1, vec3_t v2, vec3_t v3, vec3_t v4)
@@ -537,56 +625,9 @@ void R_RecursiveWorldNode( mnode_t *node, int planeBits, int dlightBits, int psh
 		// inside can be visible OPTIMIZE: don't do this all the way to leafs?
 
 		if ( !r_nocull->integer ) {
-			int		r;
-
-			if ( planeBits & 1 ) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[0]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if ( r == 1 ) {
-					planeBits &= ~1;			// all descendants will also be in front
-				}
-			}
-
-			if ( planeBits & 2 ) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[1]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if ( r == 1 ) {
-					planeBits &= ~2;			// all descendants will also be in front
-				}
-			}
-
-			if ( planeBits & 4 ) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[2]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if ( r == 1 ) {
-					planeBits &= ~4;			// all descendants will also be in front
-				}
-			}
-
-			if ( planeBits & 8 ) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[3]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if ( r == 1 ) {
-					planeBits &= ~8;			// all descendants will also be in front
-				}
-			}
-
-			if ( planeBits & 16 ) {
-				r = BoxOnPlaneSide(node->mins, node->maxs, &tr.viewParms.frustum[4]);
-				if (r == 2) {
-					return;						// culled
-				}
-				if ( r == 1 ) {
-					planeBits &= ~16;			// all descendants will also be in front
-				}
+			planeBits = R_CullBoxFrustumPlanes(node->mins, node->maxs, &tr.viewParms.cullPlanes, planeBits);
+			if ( planeBits < 0 ) {
+				return;						// culled
 			}
 		}
 
@@ -865,6 +906,30 @@ void R_MarkLeaves( void )
 }
 
 
+/*
+=============
+R_VisibleLightBits
+
+Returns a bit for each of the given light volumes that reaches into the
+view frustum.
+=============
+*/
+static int R_VisibleLightBits( const viewParms_t *viewParms, int numLights, const vec3_t *origins, const float *radii ) {
+	int cull[32];
+	int bits = 0;
+
+	R_CullSpheres(numLights, origins, radii, &viewParms->cullPlanes,
+		(viewParms->flags & VPF_FARPLANEFRUSTUM) ? 31 : 15, cull);
+
+	for ( int i = 0; i < numLights; i++ ) {
+		if ( cull[i] != CULL_OUT ) {
+			bits |= 1 << i;
+		}
+	}
+
+	return bits;
+}
+
 /*
 =============
 R_AddWorldSurfaces
@@ -872,6 +937,8 @@ R_AddWorldSurfaces
 */
 void R_AddWorldSurfaces( viewParms_t *viewParms, trRefdef_t *refdef ) {
 	int planeBits, dlightBits, pshadowBits;
+	vec3_t lightOrigins[32];
+	float lightRadii[32];
 
 	if ( !r_drawworld->integer ) {
 		return;
@@ -909,17 +976,38 @@ void R_AddWorldSurfaces( viewParms_t *viewParms, trRefdef_t *refdef ) {
 			pshadowBits = 0;
 	}
 
+	// lights that don't reach into the view can't light anything in it
+	if ( dlightBits ) {
+		for ( int i = 0; i < refdef->num_dlights; i++ ) {
+			VectorCopy(refdef->dlights[i].origin, lightOrigins[i]);
+			lightRadii[i] = refdef->dlights[i].radius;
+		}
+		dlightBits &= R_VisibleLightBits(viewParms, refdef->num_dlights, lightOrigins, lightRadii);
+	}
+
+	if ( pshadowBits ) {
+		for ( int i = 0; i < refdef->num_pshadows; i++ ) {
+			VectorCopy(refdef->pshadows[i].lightOrigin, lightOrigins[i]);
+			lightRadii[i] = refdef->pshadows[i].lightRadius;
+		}
+		pshadowBits &= R_VisibleLightBits(viewParms, refdef->num_pshadows, lightOrigins, lightRadii);
+	}
+
 	R_RecursiveWorldNode(tr.world->nodes, planeBits, dlightBits, pshadowBits);
 
 	// now add all the potentially visible surfaces
 	R_RotateForEntity(&tr.worldEntity, &tr.viewParms, &tr.ori);
 
+	surfaceBatch_t batch;
+	batch.numSurfs = 0;
+
 	for (int i = 0; i < tr.world->numWorldSurfaces; i++)
 	{
 		if (tr.world->surfacesViewCount[i] != tr.viewCount)
 			continue;
 
-		R_AddWorldSurface(
+		R_BatchWorldSurface(
+			&batch,
 			tr.world->surfaces + i,
 			nullptr,
 			REFENTITYNUM_WORLD,
@@ -932,11 +1020,14 @@ void R_AddWorldSurfaces( viewParms_t *viewParms, trRefdef_t *refdef ) {
 		if (tr.world->mergedSurfacesViewCount[i] != tr.viewCount)
 			continue;
 
-		R_AddWorldSurface(
+		R_BatchWorldSurface(
+			&batch,
 			tr.world->mergedSurfaces + i,
 			nullptr,
 			REFENTITYNUM_WORLD,
 			tr.world->mergedSurfacesDlightBits[i],
 			tr.world->mergedSurfacesPshadowBits[i]);
 	}
+
+	R_FlushSurfaceBatch(&batch, nullptr, REFENTITYNUM_WORLD);
 }
@@ -715,7 +715,7 @@ void G2API_CleanGhoul2Models(CGhoul2Info_v **ghoul2Ptr)
 
 		while (i < r)
 		{
-			if ((CGhoul2Info_v *)backEndData->entities[i].e.ghoul2 == *ghoul2Ptr)
+			if ((CGhoul2Info_v *)backEndData[tr.smpFrame]->entities[i].e.ghoul2 == *ghoul2Ptr)
 			{
 				char fName[MAX_QPATH];
 				char mName[MAX_QPATH];
@@ -939,12 +939,14 @@ qboolean G2API_SetRootSurface(CGhoul2Info_v &ghoul2, const int modelIndex, const
 	return qfalse;
 }
 
+void G2_ClearBoltCache(CGhoul2Info &ghoul2);
 int G2API_AddSurface(CGhoul2Info *ghlInfo, int surfaceNumber, int polyNumber, float BarycentricI, float BarycentricJ, int lod )
 {
 	if (G2_SetupModelPointers(ghlInfo))
 	{
 		// ensure we flush the cache
 		ghlInfo->mMeshFrameNum = 0;
+		G2_ClearBoltCache(*ghlInfo);
 		return G2_AddSurface(ghlInfo, surfaceNumber, polyNumber, BarycentricI, BarycentricJ, lod);
 	}
 	return -1;
@@ -956,6 +958,7 @@ qboolean G2API_RemoveSurface(CGhoul2Info *ghlInfo, const int index)
 	{
 		// ensure we flush the cache
 		ghlInfo->mMeshFrameNum = 0;
+		G2_ClearBoltCache(*ghlInfo);
 		return G2_RemoveSurface(ghlInfo->mSlist, index);
 	}
 	return qfalse;
@@ -1993,6 +1996,8 @@ qboolean G2API_GetBoltMatrix_SPMethod(CGhoul2Info_v &ghoul2, const int modelInde
 #define G2ANIM(ghlInfo,m) ((void)0)
 bool G2_NeedsRecalc(CGhoul2Info *ghlInfo,int frameNum);
 void G2_GetBoltMatrixLow(CGhoul2Info &ghoul2,int boltNum,const vec3_t scale,mdxaBone_t &retMatrix);
+bool G2_GetCachedBoltMatrix(CGhoul2Info &ghoul2,int boltNum,const vec3_t angles,const vec3_t position,const vec3_t scale,bool spMethod,mdxaBone_t &retMatrix);
+void G2_CacheBoltMatrix(CGhoul2Info &ghoul2,int boltNum,const vec3_t angles,const vec3_t position,const vec3_t scale,bool spMethod,const mdxaBone_t &matrix);
 void G2_GetBoneMatrixLow(CGhoul2Info &ghoul2,int boneNum,const vec3_t scale,mdxaBone_t &retMatrix,mdxaBone_t *&retBasepose,mdxaBone_t *&retBaseposeInv);
 
 //qboolean G2API_GetBoltMatrix(CGhoul2Info_v &ghoul2, const int modelIndex, const int boltIndex, mdxaBone_t *matrix, const vec3_t angles,
@@ -2011,7 +2016,6 @@ qboolean G2API_GetBoltMatrix(CGhoul2Info_v &ghoul2, const int modelIndex, const
 			{ 0.0f, 0.0f, 1.0f, 0.0f }
 		}
 	};
-	G2_GenerateWorldMatrix(angles, position);
 	if (G2_SetupModelPointers(ghoul2))
 	{
 		if (matrix&&modelIndex>=0&&modelIndex<ghoul2.size())
@@ -2023,6 +2027,7 @@ qboolean G2API_GetBoltMatrix(CGhoul2Info_v &ghoul2, const int modelIndex, const
 			if (boltIndex >= 0 && ghlInfo && (boltIndex < (int)ghlInfo->mBltlist.size()) )
 			{
 				mdxaBone_t bolt;
+				const bool spMethod = !!gG2_GBMUseSPMethod;
 
 #if 0 //yeah, screw it
 				if (!gG2_GBMNoReconstruct)
@@ -2043,6 +2048,14 @@ qboolean G2API_GetBoltMatrix(CGhoul2Info_v &ghoul2, const int modelIndex, const
 				}
 #endif
 
+				// asked already since the bones were last transformed
+				if (G2_GetCachedBoltMatrix(*ghlInfo,boltIndex,angles,position,scale,spMethod,*matrix))
+				{
+					gG2_GBMUseSPMethod = qfalse;
+					return qtrue;
+				}
+
+				G2_GenerateWorldMatrix(angles, position);
 				G2_GetBoltMatrixLow(*ghlInfo,boltIndex,scale,bolt);
 				// scale the bolt position by the scale factor for this model since at this point its still in model space
 				if (scale[0])
@@ -2093,6 +2106,7 @@ qboolean G2API_GetBoltMatrix(CGhoul2Info_v &ghoul2, const int modelIndex, const
 					gG2_GBMUseSPMethod = qfalse;
 				}
 
+				G2_CacheBoltMatrix(*ghlInfo,boltIndex,angles,position,scale,spMethod,*matrix);
 				return qtrue;
 			}
 		}
@@ -2101,6 +2115,7 @@ qboolean G2API_GetBoltMatrix(CGhoul2Info_v &ghoul2, const int modelIndex, const
 	{
 		G2WARNING(0,"G2API_GetBoltMatrix Failed on empty or bad model");
 	}
+	G2_GenerateWorldMatrix(angles, position);
 	Multiply_3x4Matrix(matrix, &worldMatrix, (mdxaBone_t *)&identityMatrix);
 	return qfalse;
 }
@@ -61,6 +61,11 @@ static inline void DestroyGoreTexCoordinates(int tag)
 
 int AllocGoreRecord()
 {
+	if (GoreRecords.size()>MAX_GORE_RECORDS)
+	{
+		// the oldest records may still be queued for the render thread
+		R_WaitRenderThread();
+	}
 	while (GoreRecords.size()>MAX_GORE_RECORDS)
 	{
 		int tagHigh=(*GoreRecords.begin()).first&GORE_TAG_MASK;
@@ -148,6 +153,9 @@ CGoreSet *NewGoreSet()
 
 void DeleteGoreSet(int goreSetTag)
 {
+	// gore surfaces may still be queued for the render thread
+	R_WaitRenderThread();
+
 	std::map<int,CGoreSet *>::iterator f=GoreSets.find(goreSetTag);
 	if (f!=GoreSets.end())
 	{
@@ -402,6 +402,13 @@ extern PFNGLSTENCILOPSEPARATEPROC qglStencilOpSeparate;
 extern PFNGLACTIVETEXTUREARBPROC qglActiveTextureARB;
 extern PFNGLCLIENTACTIVETEXTUREARBPROC qglClientActiveTextureARB;
 extern PFNGLMULTITEXCOORD2FARBPROC qglMultiTexCoord2fARB;
+
+extern PFNGLGENBUFFERSARBPROC qglGenBuffersARB;
+extern PFNGLDELETEBUFFERSARBPROC qglDeleteBuffersARB;
+extern PFNGLBINDBUFFERARBPROC qglBindBufferARB;
+extern PFNGLBUFFERDATAARBPROC qglBufferDataARB;
+extern PFNGLMAPBUFFERARBPROC qglMapBufferARB;
+extern PFNGLUNMAPBUFFERARBPROC qglUnmapBufferARB;
 #if !defined(__APPLE__)
 extern PFNGLTEXIMAGE3DPROC qglTexImage3D;
 extern PFNGLTEXSUBIMAGE3DPROC qglTexSubImage3D;
@@ -37,7 +37,6 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #include "Ravl/CVec.h"
 #include "Ratl/vector_vs.h"
-#include "Ratl/bits_vs.h"
 
 #include "glext.h"
 
@@ -246,28 +245,63 @@ struct	SIntRange
 
 
 ////////////////////////////////////////////////////////////////////////////////////////
-// The Particle Class
+// The Particles
+//
+// A cloud keeps each particle component in its own array, so that the physics update
+// is a straight run over contiguous floats.
 ////////////////////////////////////////////////////////////////////////////////////////
-class	CWeatherParticle
+class	CWeatherParticles
 {
 public:
 	enum
 	{
-		FLAG_RENDER = 0,
+		FLAG_RENDER		= (1 << 0),
+		FLAG_FADEIN		= (1 << 1),
+		FLAG_FADEOUT	= (1 << 2),
+	};
 
-		FLAG_FADEIN,
-		FLAG_FADEOUT,
-		FLAG_RESPAWN,
+	float*	mPosition[3];
+	float*	mVelocity[3];
+	float*	mMassInverse;	// A smaller number will more greatly resist force and result in greater gravity
+	float*	mAlpha;
+	byte*	mFlags;
 
-		FLAG_MAX
-	};
-	typedef		ratl::bits_vs<FLAG_MAX>		TFlags;
+	void	Allocate(int count)
+	{
+		float*	data = new float[count * 8];
+		for (int dim=0; dim<3; dim++)
+		{
+			mPosition[dim] = data + (count * dim);
+			mVelocity[dim] = data + (count * (dim + 3));
+		}
+		mMassInverse	= data + (count * 6);
+		mAlpha			= data + (count * 7);
+		mFlags			= new byte[count];
+	}
+
+	void	Free()
+	{
+		delete [] mPosition[0];
+		delete [] mFlags;
+		Clear();
+	}
 
-	float	mAlpha;
-	TFlags	mFlags;
-	CVec3	mPosition;
-	CVec3	mVelocity;
-	float	mMass;			// A higher number will more greatly resist force and result in greater gravity
+	void	Clear()
+	{
+		memset(this, 0, sizeof(*this));
+	}
+
+	inline CVec3	Position(int i) const
+	{
+		return CVec3(mPosition[0][i], mPosition[1][i], mPosition[2][i]);
+	}
+
+	inline void		SetPosition(int i, const CVec3& pos)
+	{
+		mPosition[0][i] = pos[0];
+		mPosition[1][i] = pos[1];
+		mPosition[2][i] = pos[2];
+	}
 };
 
 
@@ -646,7 +680,7 @@ public:
 		}
 		for (int zone=0; zone<mWeatherZones.size(); zone++)
 		{
-			SWeatherZone	wz = mWeatherZones[zone];
+			SWeatherZone&	wz = mWeatherZones[zone];
 			if (wz.mExtents.In(pos))
 			{
 				int		bit, x, y, z;
@@ -666,7 +700,7 @@ public:
 	{
 		for (int zone=0; zone<mWeatherZones.size(); zone++)
 		{
-			SWeatherZone	wz = mWeatherZones[zone];
+			SWeatherZone&	wz = mWeatherZones[zone];
 			if (wz.mExtents.In(pos))
 			{
 				int		bit, x, y, z;
@@ -737,7 +771,7 @@ private:
 	// DYNAMIC MEMORY
 	////////////////////////////////////////////////////////////////////////////////////
 	image_t*	mImage;
-	CWeatherParticle*	mParticles;
+	CWeatherParticles	mParticles;
 
 private:
 	////////////////////////////////////////////////////////////////////////////////////
@@ -808,7 +842,7 @@ public:
 	void	Initialize(int count, const char* texturePath, int VertexCount=4)
 	{
 		Reset();
-		assert(mParticleCount==0 && mParticles==0);
+		assert(mParticleCount==0 && mParticles.mFlags==0);
 		assert(mImage==0);
 
 		// Create The Image
@@ -826,18 +860,22 @@ public:
 		// Create The Particles
 		//----------------------
 		mParticleCount	= count;
-		mParticles		= new CWeatherParticle[mParticleCount];
+		mParticles.Allocate(mParticleCount);
 
 
 
-		CWeatherParticle*	part=0;
+		float	mass;
 		for (int particleNum=0; particleNum<mParticleCount; particleNum++)
 		{
-			part = &(mParticles[particleNum]);
-			part->mPosition.Clear();
-			part->mVelocity.Clear();
-			part->mAlpha	= 0.0f;
-			mMass.Pick(part->mMass);
+			for (int dim=0; dim<3; dim++)
+			{
+				mParticles.mPosition[dim][particleNum] = 0.0f;
+				mParticles.mVelocity[dim][particleNum] = 0.0f;
+			}
+			mParticles.mAlpha[particleNum]	= 0.0f;
+			mParticles.mFlags[particleNum]	= 0;
+			mMass.Pick(mass);
+			mParticles.mMassInverse[particleNum] = 1.0f / mass;
 		}
 
 		mVertexCount = VertexCount;
@@ -858,10 +896,9 @@ public:
 		mImage				= 0;
 		if (mParticleCount)
 		{
-			delete [] mParticles;
+			mParticles.Free();
 		}
 		mParticleCount		= 0;
-		mParticles			= 0;
 
 		mPopulated			= 0;
 
@@ -913,6 +950,7 @@ public:
 	{
 		mImage = 0;
 		mParticleCount = 0;
+		mParticles.Clear();
 		Reset();
 	}
 
@@ -939,10 +977,8 @@ public:
 	////////////////////////////////////////////////////////////////////////////////////
 	void		Update()
 	{
-		CWeatherParticle*	part=0;
-		CVec3		partForce;
-		CVec3		partMoved;
-		CVec3		partToCamera;
+		CVec3		partPosition;
+		byte		partFlags;
 		bool		partRendering;
 		bool		partOutside;
 		bool		partInRange;
@@ -1071,79 +1107,102 @@ public:
 
 
 
-		// Now Update All Particles
-		//--------------------------
-		mParticleCountRender = 0;
-		for (particleNum=0; particleNum<mParticleCount; particleNum++)
+		// First Time Spawn Locations
+		//-----------------------------
+		if (!mPopulated)
 		{
-			part			= &mParticles[particleNum];
-
-			if (!mPopulated)
+			for (particleNum=0; particleNum<mParticleCount; particleNum++)
 			{
-				mRange.Pick(part->mPosition);		// First Time Spawn Location
+				mRange.Pick(partPosition);
+				mParticles.SetPosition(particleNum, partPosition);
 			}
+		}
 
-			// Grab The Force And Apply Non Global Wind
-			//------------------------------------------
-			partForce = force;
-			partForce /= part->mMass;
 
+		// Apply The Force To All Particles
+		//----------------------------------
+		for (int dim=0; dim<3; dim++)
+		{
+			float*			position		= mParticles.mPosition[dim];
+			float*			velocity		= mParticles.mVelocity[dim];
+			const float*	massInverse		= mParticles.mMassInverse;
+			const float		dimForce		= force[dim];
 
-			// Apply The Force
-			//-----------------
-			part->mVelocity		+= partForce;
-			part->mVelocity		*= mFrictionInverse;
+			for (particleNum=0; particleNum<mParticleCount; particleNum++)
+			{
+				velocity[particleNum]	= (velocity[particleNum] + (dimForce * massInverse[particleNum])) * mFrictionInverse;
+				position[particleNum]	+= velocity[particleNum] * mSecondsElapsed;
+			}
+		}
 
-			part->mPosition.ScaleAdd(part->mVelocity, mSecondsElapsed);
 
-			partToCamera	= (part->mPosition - mCameraPosition);
-			partRendering	= part->mFlags.get_bit(CWeatherParticle::FLAG_RENDER);
-			partOutside		= mOutside.PointOutside(part->mPosition, mWidth, mHeight);
-			partInRange		= mRange.In(part->mPosition);
-			partInView		= (partOutside && partInRange && (partToCamera.Dot(mCameraForward)>0.0f));
+		// Now Update The State Of All Particles
+		//---------------------------------------
+		mParticleCountRender = 0;
+		for (particleNum=0; particleNum<mParticleCount; particleNum++)
+		{
+			partPosition	= mParticles.Position(particleNum);
+			partFlags		= mParticles.mFlags[particleNum];
+			partRendering	= !!(partFlags & CWeatherParticles::FLAG_RENDER);
+			partInRange		= mRange.In(partPosition);
+
+			// Only Particles In Range And In Front Of The Camera Can Be Seen, So Only They Need The Outside Test
+			//-----------------------------------------------------------------------------------------------------
+			partInView		= false;
+			if (partInRange && (partPosition - mCameraPosition).Dot(mCameraForward)>0.0f)
+			{
+				partOutside	= mOutside.PointOutside(partPosition, mWidth, mHeight);
+				partInView	= partOutside;
+			}
 
 			// Process Respawn
 			//-----------------
 			if (!partInRange && !partRendering)
 			{
-				part->mVelocity.Clear();
+				for (int dim=0; dim<3; dim++)
+				{
+					mParticles.mVelocity[dim][particleNum] = 0.0f;
+				}
 
 				// Reselect A Position On The Spawn Plane
 				//----------------------------------------
 				if (UseSpawnPlane())
 				{
-					part->mPosition		= mCameraPosition;
-					part->mPosition		-= (mSpawnPlaneNorm* mSpawnPlaneDistance);
-					part->mPosition		+= (mSpawnPlaneRight*WE_flrand(-mSpawnPlaneSize, mSpawnPlaneSize));
-					part->mPosition		+= (mSpawnPlaneUp*   WE_flrand(-mSpawnPlaneSize, mSpawnPlaneSize));
+					partPosition	= mCameraPosition;
+					partPosition	-= (mSpawnPlaneNorm* mSpawnPlaneDistance);
+					partPosition	+= (mSpawnPlaneRight*WE_flrand(-mSpawnPlaneSize, mSpawnPlaneSize));
+					partPosition	+= (mSpawnPlaneUp*   WE_flrand(-mSpawnPlaneSize, mSpawnPlaneSize));
 				}
 
 				// Otherwise, Just Wrap Around To The Other End Of The Range
 				//-----------------------------------------------------------
 				else
 				{
-					mRange.Wrap(part->mPosition, mSpawnRange);
+					mRange.Wrap(partPosition, mSpawnRange);
 				}
+				mParticles.SetPosition(particleNum, partPosition);
 				partInRange = true;
 			}
 
 			// Process Fade
 			//--------------
 			{
+				float&	partAlpha = mParticles.mAlpha[particleNum];
+
 				// Start A Fade Out
 				//------------------
 				if		(partRendering && !partInView)
 				{
-					part->mFlags.clear_bit(CWeatherParticle::FLAG_FADEIN);
-					part->mFlags.set_bit(CWeatherParticle::FLAG_FADEOUT);
+					partFlags &= ~CWeatherParticles::FLAG_FADEIN;
+					partFlags |=  CWeatherParticles::FLAG_FADEOUT;
 				}
 
 				// Switch From Fade Out To Fade In
 				//---------------------------------
-				else if (partRendering && partInView && part->mFlags.get_bit(CWeatherParticle::FLAG_FADEOUT))
+				else if (partRendering && partInView && (partFlags & CWeatherParticles::FLAG_FADEOUT))
 				{
-					part->mFlags.set_bit(CWeatherParticle::FLAG_FADEIN);
-					part->mFlags.clear_bit(CWeatherParticle::FLAG_FADEOUT);
+					partFlags |=  CWeatherParticles::FLAG_FADEIN;
+					partFlags &= ~CWeatherParticles::FLAG_FADEOUT;
 				}
 
 				// Start A Fade In
@@ -1151,10 +1210,9 @@ public:
 				else if (!partRendering && partInView)
 				{
 					partRendering = true;
-					part->mAlpha = 0.0f;
-					part->mFlags.set_bit(CWeatherParticle::FLAG_RENDER);
-					part->mFlags.set_bit(CWeatherParticle::FLAG_FADEIN);
-					part->mFlags.clear_bit(CWeatherParticle::FLAG_FADEOUT);
+					partAlpha = 0.0f;
+					partFlags |=  (CWeatherParticles::FLAG_RENDER | CWeatherParticles::FLAG_FADEIN);
+					partFlags &= ~CWeatherParticles::FLAG_FADEOUT;
 				}
 
 				// Update Fade
@@ -1164,44 +1222,38 @@ public:
 
 					// Update Fade Out
 					//-----------------
-					if (part->mFlags.get_bit(CWeatherParticle::FLAG_FADEOUT))
+					if (partFlags & CWeatherParticles::FLAG_FADEOUT)
 					{
-						part->mAlpha -= particleFade;
-						if (part->mAlpha<=0.0f)
+						partAlpha -= particleFade;
+						if (partAlpha<=0.0f)
 						{
-							part->mAlpha = 0.0f;
-							part->mFlags.clear_bit(CWeatherParticle::FLAG_FADEOUT);
-							part->mFlags.clear_bit(CWeatherParticle::FLAG_FADEIN);
-							part->mFlags.clear_bit(CWeatherParticle::FLAG_RENDER);
+							partAlpha = 0.0f;
+							partFlags = 0;
 							partRendering = false;
 						}
 					}
 
 					// Update Fade In
 					//----------------
-					else if (part->mFlags.get_bit(CWeatherParticle::FLAG_FADEIN))
+					else if (partFlags & CWeatherParticles::FLAG_FADEIN)
 					{
-						part->mAlpha += particleFade;
-						if (part->mAlpha>=mColor[3])
+						partAlpha += particleFade;
+						if (partAlpha>=mColor[3])
 						{
-							part->mFlags.clear_bit(CWeatherParticle::FLAG_FADEIN);
-							part->mAlpha = mColor[3];
+							partFlags &= ~CWeatherParticles::FLAG_FADEIN;
+							partAlpha = mColor[3];
 						}
 					}
 				}
 			}
+			mParticles.mFlags[particleNum] = partFlags;
 
 			// Keep Track Of The Number Of Particles To Render
 			//-------------------------------------------------
-			if (part->mFlags.get_bit(CWeatherParticle::FLAG_RENDER))
+			if (partFlags & CWeatherParticles::FLAG_RENDER)
 			{
 				mParticleCountRender ++;
 			}
-
-
-
-
-
 		}
 		mPopulated = true;
 	}
@@ -1211,7 +1263,8 @@ public:
 	////////////////////////////////////////////////////////////////////////////////////
 	void		Render()
 	{
-		CWeatherParticle*	part=0;
+		CVec3		partPosition;
+		float		partAlpha;
 		int			particleNum;
 
 
@@ -1243,24 +1296,25 @@ public:
 		qglBegin(mGLModeEnum);
 		for (particleNum=0; particleNum<mParticleCount; particleNum++)
 		{
-			part = &(mParticles[particleNum]);
-			if (!part->mFlags.get_bit(CWeatherParticle::FLAG_RENDER))
+			if (!(mParticles.mFlags[particleNum] & CWeatherParticles::FLAG_RENDER))
 			{
 				continue;
 			}
+			partPosition	= mParticles.Position(particleNum);
+			partAlpha		= mParticles.mAlpha[particleNum];
 
 			// Blend Mode Zero -> Apply Alpha Just To Alpha Channel
 			//------------------------------------------------------
 			if (mBlendMode==0)
 			{
-				qglColor4f(mColor[0], mColor[1], mColor[2], part->mAlpha);
+				qglColor4f(mColor[0], mColor[1], mColor[2], partAlpha);
 			}
 
 			// Otherwise Apply Alpha To All Channels
 			//---------------------------------------
 			else
 			{
-				qglColor4f(mColor[0]*part->mAlpha, mColor[1]*part->mAlpha, mColor[2]*part->mAlpha, mColor[3]*part->mAlpha);
+				qglColor4f(mColor[0]*partAlpha, mColor[1]*partAlpha, mColor[2]*partAlpha, mColor[3]*partAlpha);
 			}
 
 			// Render A Triangle
@@ -1268,19 +1322,19 @@ public:
 			if (mVertexCount==3)
 			{
  				qglTexCoord2f(1.0, 0.0);
-				qglVertex3f(part->mPosition[0],
-							part->mPosition[1],
-							part->mPosition[2]);
+				qglVertex3f(partPosition[0],
+							partPosition[1],
+							partPosition[2]);
 
 				qglTexCoord2f(0.0, 1.0);
-				qglVertex3f(part->mPosition[0] + mCameraLeft[0],
-							part->mPosition[1] + mCameraLeft[1],
-							part->mPosition[2] + mCameraLeft[2]);
+				qglVertex3f(partPosition[0] + mCameraLeft[0],
+							partPosition[1] + mCameraLeft[1],
+							partPosition[2] + mCameraLeft[2]);
 
 				qglTexCoord2f(0.0, 0.0);
-				qglVertex3f(part->mPosition[0] + mCameraLeftPlusUp[0],
-							part->mPosition[1] + mCameraLeftPlusUp[1],
-							part->mPosition[2] + mCameraLeftPlusUp[2]);
+				qglVertex3f(partPosition[0] + mCameraLeftPlusUp[0],
+							partPosition[1] + mCameraLeftPlusUp[1],
+							partPosition[2] + mCameraLeftPlusUp[2]);
 			}
 
 			// Render A Quad
@@ -1289,27 +1343,27 @@ public:
 			{
 				// Left bottom.
 				qglTexCoord2f( 0.0, 0.0 );
-				qglVertex3f(part->mPosition[0] - mCameraLeftMinusUp[0],
-							part->mPosition[1] - mCameraLeftMinusUp[1],
-							part->mPosition[2] - mCameraLeftMinusUp[2] );
+				qglVertex3f(partPosition[0] - mCameraLeftMinusUp[0],
+							partPosition[1] - mCameraLeftMinusUp[1],
+							partPosition[2] - mCameraLeftMinusUp[2] );
 
 				// Right bottom.
 				qglTexCoord2f( 1.0, 0.0 );
-				qglVertex3f(part->mPosition[0] - mCameraLeftPlusUp[0],
-							part->mPosition[1] - mCameraLeftPlusUp[1],
-							part->mPosition[2] - mCameraLeftPlusUp[2] );
+				qglVertex3f(partPosition[0] - mCameraLeftPlusUp[0],
+							partPosition[1] - mCameraLeftPlusUp[1],
+							partPosition[2] - mCameraLeftPlusUp[2] );
 
 				// Right top.
 				qglTexCoord2f( 1.0, 1.0 );
-				qglVertex3f(part->mPosition[0] + mCameraLeftMinusUp[0],
-							part->mPosition[1] + mCameraLeftMinusUp[1],
-							part->mPosition[2] + mCameraLeftMinusUp[2] );
+				qglVertex3f(partPosition[0] + mCameraLeftMinusUp[0],
+							partPosition[1] + mCameraLeftMinusUp[1],
+							partPosition[2] + mCameraLeftMinusUp[2] );
 
 				// Left top.
 				qglTexCoord2f( 0.0, 1.0 );
-				qglVertex3f(part->mPosition[0] + mCameraLeftPlusUp[0],
-							part->mPosition[1] + mCameraLeftPlusUp[1],
-							part->mPosition[2] + mCameraLeftPlusUp[2] );
+				qglVertex3f(partPosition[0] + mCameraLeftPlusUp[0],
+							partPosition[1] + mCameraLeftPlusUp[1],
+							partPosition[2] + mCameraLeftPlusUp[2] );
 			}
 		}
 		qglEnd();
@@ -1355,7 +1409,7 @@ void R_ShutdownWorldEffects(void)
 void RB_RenderWorldEffects(void)
 {
 	if (!tr.world ||
-		(tr.refdef.rdflags & RDF_NOWORLDMODEL) ||
+		(backEnd.refdef.rdflags & RDF_NOWORLDMODEL) ||
 		(backEnd.refdef.rdflags & RDF_SKYBOXPORTAL) ||
 		!mParticleClouds.size())
 	{	//  no world rendering or no world or no particle clouds
@@ -1470,6 +1524,9 @@ void RE_WorldEffectCommand(const char *command)
 		return;
 	}
 
+	// the render thread may be drawing the particle clouds this changes
+	R_WaitRenderThread();
+
 	COM_BeginParseSession ("RE_WorldEffectCommand");
 
 	const char	*token;//, *origCommand;
@@ -25,7 +25,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "glext.h"
 #include "tr_WorldEffects.h"
 
-backEndData_t	*backEndData;
+backEndData_t	*backEndData[SMP_FRAMES];
 backEndState_t	backEnd;
 
 bool tr_stencilled = false;
@@ -498,7 +498,7 @@ void RB_BeginDrawingView (void) {
 		}
 	}
 
-	if ( tr.refdef.rdflags & RDF_AUTOMAP || (!( backEnd.refdef.rdflags & RDF_NOWORLDMODEL ) && r_DynamicGlow->integer && !g_bRenderGlowingObjects ) )
+	if ( backEnd.refdef.rdflags & RDF_AUTOMAP || (!( backEnd.refdef.rdflags & RDF_NOWORLDMODEL ) && r_DynamicGlow->integer && !g_bRenderGlowingObjects ) )
 	{
 		if (tr.world && tr.world->globalFog != -1)
 		{ //this is because of a bug in multiple scenes I think, it needs to clear for the second scene but it doesn't normally.
@@ -575,12 +575,12 @@ static inline bool R_WorldCoordToScreenCoordFloat(vec3_t worldCoord, float *x, f
 	xcenter = glConfig.vidWidth / 2;
 	ycenter = glConfig.vidHeight / 2;
 
-	//AngleVectors (tr.refdef.viewangles, vfwd, vright, vup);
-	VectorCopy(tr.refdef.viewaxis[0], vfwd);
-	VectorCopy(tr.refdef.viewaxis[1], vright);
-	VectorCopy(tr.refdef.viewaxis[2], vup);
+	//AngleVectors (backEnd.refdef.viewangles, vfwd, vright, vup);
+	VectorCopy(backEnd.refdef.viewaxis[0], vfwd);
+	VectorCopy(backEnd.refdef.viewaxis[1], vright);
+	VectorCopy(backEnd.refdef.viewaxis[2], vup);
 
-	VectorSubtract (worldCoord, tr.refdef.vieworg, local);
+	VectorSubtract (worldCoord, backEnd.refdef.vieworg, local);
 
 	transformed[0] = DotProduct(local,vright);
 	transformed[1] = DotProduct(local,vup);
@@ -592,8 +592,8 @@ static inline bool R_WorldCoordToScreenCoordFloat(vec3_t worldCoord, float *x, f
 		return false;
 	}
 
-	xzi = xcenter / transformed[2] * (90.0/tr.refdef.fov_x);
-	yzi = ycenter / transformed[2] * (90.0/tr.refdef.fov_y);
+	xzi = xcenter / transformed[2] * (90.0/backEnd.refdef.fov_x);
+	yzi = ycenter / transformed[2] * (90.0/backEnd.refdef.fov_y);
 
 	*x = xcenter + xzi * transformed[0];
 	*y = ycenter - yzi * transformed[1];
@@ -2003,6 +2003,17 @@ void RB_ExecuteRenderCommands( const void *data ) {
 
 }
 
+/*
+====================
+RB_MakeCurrent
+
+Moves the GL context between the front end and the render thread
+====================
+*/
+void RB_MakeCurrent( bool current ) {
+	ri.GL_MakeCurrent( current ? qtrue : qfalse );
+}
+
 // What Pixel Shader type is currently active (regcoms or fragment programs).
 GLuint g_uiCurrentPixelShaderType = 0x0;
 
@@ -2032,6 +2032,9 @@ void RE_LoadWorldMap_Actual( const char *name, world_t &worldData, int index )
 		// clear tr.world so if the level fails to load, the next
 		// try will not look at the partially loaded version
 		tr.world = NULL;
+
+		// sprites placed on the previous map's surfaces are no use anymore
+		R_ClearSurfaceSpriteCache();
 	}
 
 	// check for cached disk file from the server first...
@@ -2085,6 +2088,7 @@ void RE_LoadWorldMap_Actual( const char *name, world_t &worldData, int index )
 	R_LoadNodesAndLeafs (&header->lumps[LUMP_NODES], &header->lumps[LUMP_LEAFS], worldData);
 	R_LoadSubmodels (&header->lumps[LUMP_MODELS], worldData, index);
 	R_LoadVisibility( &header->lumps[LUMP_VISIBILITY], worldData );
+	R_BuildMarkTriangles( worldData );
 
 	worldData.dataSize = (byte *)Hunk_Alloc(0, h_low) - startMarker;
 
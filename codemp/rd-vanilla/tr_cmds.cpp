@@ -89,7 +89,7 @@ R_IssueRenderCommands
 void R_IssueRenderCommands( qboolean runPerformanceCounters ) {
 	renderCommandList_t	*cmdList;
 
-	cmdList = &backEndData->commands;
+	cmdList = &backEndData[tr.smpFrame]->commands;
 
 	// add an end-of-list command
 	byteAlias_t *ba = (byteAlias_t *)&cmdList->cmds[cmdList->used];
@@ -98,6 +98,9 @@ void R_IssueRenderCommands( qboolean runPerformanceCounters ) {
 	// clear it out, in case this is a sync and not a buffer flip
 	cmdList->used = 0;
 
+	// wait for the render thread to finish the previous frame
+	R_WaitRenderThread();
+
 	// at this point, the back end thread is idle, so it is ok
 	// to look at it's performance counters
 	if ( runPerformanceCounters ) {
@@ -107,7 +110,11 @@ void R_IssueRenderCommands( qboolean runPerformanceCounters ) {
 	// actually start the commands going
 	if ( !r_skipBackEnd->integer ) {
 		// let it start on the new batch
-		RB_ExecuteRenderCommands( cmdList->cmds );
+		if ( R_RenderThreadActive() ) {
+			R_WakeRenderThread( cmdList->cmds );
+		} else {
+			RB_ExecuteRenderCommands( cmdList->cmds );
+		}
 	}
 }
 
@@ -117,6 +124,7 @@ void R_IssueRenderCommands( qboolean runPerformanceCounters ) {
 R_IssuePendingRenderCommands
 
 Issue any pending commands and wait for them to complete.
+Afterwards the front end can use GL until the next frame is issued.
 ====================
 */
 void R_IssuePendingRenderCommands( void ) {
@@ -124,6 +132,7 @@ void R_IssuePendingRenderCommands( void ) {
 		return;
 	}
 	R_IssueRenderCommands( qfalse );
+	R_SyncRenderThread();
 }
 
 /*
@@ -136,7 +145,7 @@ make sure there is enough command space
 static void *R_GetCommandBufferReserved( int bytes, int reservedBytes ) {
 	renderCommandList_t	*cmdList;
 
-	cmdList = &backEndData->commands;
+	cmdList = &backEndData[tr.smpFrame]->commands;
 	bytes = PAD(bytes, sizeof(void *));
 
 	// always leave room for the end of list command
@@ -349,6 +358,9 @@ void RE_BeginFrame( stereoFrame_t stereoFrame ) {
 	}
 	glState.finishCalled = qfalse;
 
+	// write out screenshots the capture thread is done with
+	R_PollCaptureJobs();
+
 	tr.frameCount++;
 	tr.frameSceneNum = 0;
 
@@ -411,8 +423,8 @@ void RE_BeginFrame( stereoFrame_t stereoFrame ) {
 		R_SetGammaCorrectionLUT();
 	}
 
-	// check for errors
-	if ( !r_ignoreGLErrors->integer ) {
+	// check for errors, unless that would stall the render thread every frame
+	if ( !r_ignoreGLErrors->integer && !R_RenderThreadActive() ) {
 		R_IssuePendingRenderCommands();
 
 		GLenum err = qglGetError();
@@ -492,7 +504,7 @@ void RE_EndFrame( int *frontEndMsec, int *backEndMsec ) {
 RE_TakeVideoFrame
 =============
 */
-void RE_TakeVideoFrame( int width, int height, byte *captureBuffer, byte *encodeBuffer, qboolean motionJpeg )
+void RE_TakeVideoFrame( int width, int height, qboolean motionJpeg )
 {
 	videoFrameCommand_t *cmd;
 
@@ -507,7 +519,5 @@ void RE_TakeVideoFrame( int width, int height, byte *captureBuffer, byte *encode
 
 	cmd->width = width;
 	cmd->height = height;
-	cmd->captureBuffer = captureBuffer;
-	cmd->encodeBuffer = encodeBuffer;
 	cmd->motionJpeg = motionJpeg;
 }
@@ -198,6 +198,25 @@ struct SBoneCalc
 	float			blendLerp;
 };
 
+// G2API_GetBoltMatrix results, kept per bone cache until its bones are
+// transformed again
+#define G2_BOLT_CACHE_SIZE 16
+
+struct boltCache_t
+{
+	int			touch;			// mCurrentTouch when this was made, 0 for never
+	int			boltIndex;
+	int			boneNumber;		// what the bolt was on, in case it was removed
+	int			surfaceNumber;	// and its index reused since
+	bool		spMethod;
+	vec3_t		angles;
+	vec3_t		position;
+	vec3_t		scale;
+	mdxaBone_t	matrix;
+	mdxaBone_t	world;			// worldMatrix and worldMatrixInv as the call
+	mdxaBone_t	worldInv;		// left them
+};
+
 class CBoneCache;
 void G2_TransformBone(int index,CBoneCache &CB);
 
@@ -340,6 +359,8 @@ public:
 	bool			mUnsquash;
 	float			mSmoothFactor;
 
+	boltCache_t		mBoltCache[G2_BOLT_CACHE_SIZE];
+
 	CBoneCache(const model_t *amod,const mdxaHeader_t *aheader) :
 		header(aheader),
 		mod(amod)
@@ -373,6 +394,10 @@ public:
 		mLastTouch=2;
 		mLastLastTouch=1;
 //rww - RAGDOLL_END
+		for (i=0;i<G2_BOLT_CACHE_SIZE;i++)
+		{
+			mBoltCache[i].touch=0;
+		}
 	}
 
 	SBoneCalc &Root()
@@ -737,6 +762,7 @@ public:
 	int				fogNum;
 	qboolean		personalModel;
 	CBoneCache		*boneCache;
+	mdxaBone_t		*renderBones;	// in backEndData, one for each bone
 	int				renderfx;
 	skin_t			*skin;
 	model_t			*currentModel;
@@ -772,6 +798,7 @@ public:
 	fogNum(initfogNum),
 	personalModel(initpersonalModel),
 	boneCache(initboneCache),
+	renderBones(0),
 	renderfx(initrenderfx),
 	skin(initskin),
 	currentModel(initcurrentModel),
@@ -2395,6 +2422,20 @@ void G2_ProcessGeneratedSurfaceBolts(CGhoul2Info &ghoul2, mdxaBone_v &bonePtr, m
 #endif
 }
 
+// Copies the matrices a surface is skinned with out of the bone cache before
+// it's handed to the back end. With r_smp the game is already transforming
+// the bones for the next frame while the render thread skins this one, so
+// RB_SurfaceGhoul only reads the copies.
+static void G2_CopySurfaceBones(CRenderSurface &RS, const mdxmSurface_t *surface)
+{
+	const int *piBoneReferences = (const int *)((const byte *)surface + surface->ofsBoneReferences);
+	for (int i = 0; i < surface->numBoneReferences; i++)
+	{
+		const int boneNum = piBoneReferences[i];
+		RS.renderBones[boneNum] = RS.boneCache->EvalRender(boneNum);
+	}
+}
+
 void RenderSurfaces(CRenderSurface &RS) //also ended up just ripping right from SP.
 {
 #ifdef G2_PERFORMANCE_ANALYSIS
@@ -2477,7 +2518,8 @@ void RenderSurfaces(CRenderSurface &RS) //also ended up just ripping right from
 			{
 				newSurf->surfaceData = surface;
 			}
-			newSurf->boneCache = RS.boneCache;
+			newSurf->bones = RS.renderBones;
+			G2_CopySurfaceBones(RS, newSurf->surfaceData);
 			R_AddDrawSurf( (surfaceType_t *)newSurf, tr.shadowShader, 0, qfalse );
 		}
 
@@ -2489,7 +2531,8 @@ void RenderSurfaces(CRenderSurface &RS) //also ended up just ripping right from
 		{		// set the surface info to point at the where the transformed bone list is going to be for when the surface gets rendered out
 			CRenderableSurface *newSurf = new CRenderableSurface;
 			newSurf->surfaceData = surface;
-			newSurf->boneCache = RS.boneCache;
+			newSurf->bones = RS.renderBones;
+			G2_CopySurfaceBones(RS, surface);
 			R_AddDrawSurf( (surfaceType_t *)newSurf, tr.projectionShadowShader, 0, qfalse );
 		}
 
@@ -2498,7 +2541,8 @@ void RenderSurfaces(CRenderSurface &RS) //also ended up just ripping right from
 		{		// set the surface info to point at the where the transformed bone list is going to be for when the surface gets rendered out
 			CRenderableSurface *newSurf = new CRenderableSurface;
 			newSurf->surfaceData = surface;
-			newSurf->boneCache = RS.boneCache;
+			newSurf->bones = RS.renderBones;
+			G2_CopySurfaceBones(RS, surface);
 			R_AddDrawSurf( (surfaceType_t *)newSurf, (shader_t *)shader, RS.fogNum, qfalse );
 
 #ifdef _G2_GORE
@@ -2519,6 +2563,8 @@ void RenderSurfaces(CRenderSurface &RS) //also ended up just ripping right from
 					{
 						if (tex)
 						{
+							// the render thread may be drawing the last frame's gore with it
+							R_WaitRenderThread();
 							(*tex).~GoreTextureCoordinates();
 							//I don't know what's going on here, it should call the destructor for
 							//this when it erases the record but sometimes it doesn't. -rww
@@ -3162,6 +3208,83 @@ void G2_GetBoltMatrixLow(CGhoul2Info &ghoul2,int boltNum,const vec3_t scale,mdxa
 	}
 }
 
+/*
+==============
+G2_GetCachedBoltMatrix
+
+Finds the result of an earlier G2API_GetBoltMatrix with the same arguments,
+made since the bones were last transformed. Puts worldMatrix back how that
+call left it too.
+==============
+*/
+bool G2_GetCachedBoltMatrix(CGhoul2Info &ghoul2,int boltNum,const vec3_t angles,const vec3_t position,const vec3_t scale,bool spMethod,mdxaBone_t &retMatrix)
+{
+	if (!ghoul2.mBoneCache)
+	{
+		return false;
+	}
+
+	const CBoneCache &boneCache=*ghoul2.mBoneCache;
+	const boltCache_t &cached=boneCache.mBoltCache[boltNum&(G2_BOLT_CACHE_SIZE-1)];
+	const boltInfo_t &bolt=ghoul2.mBltlist[boltNum];
+
+	// compare bits, not values, so -0 doesn't stand in for 0
+	if (cached.touch!=boneCache.mCurrentTouch||
+		cached.boltIndex!=boltNum||
+		cached.boneNumber!=bolt.boneNumber||
+		cached.surfaceNumber!=bolt.surfaceNumber||
+		cached.spMethod!=spMethod||
+		memcmp(cached.angles,angles,sizeof(vec3_t))||
+		memcmp(cached.position,position,sizeof(vec3_t))||
+		memcmp(cached.scale,scale,sizeof(vec3_t)))
+	{
+		return false;
+	}
+
+	retMatrix=cached.matrix;
+	worldMatrix=cached.world;
+	worldMatrixInv=cached.worldInv;
+	return true;
+}
+
+void G2_CacheBoltMatrix(CGhoul2Info &ghoul2,int boltNum,const vec3_t angles,const vec3_t position,const vec3_t scale,bool spMethod,const mdxaBone_t &matrix)
+{
+	if (!ghoul2.mBoneCache)
+	{
+		return;
+	}
+
+	CBoneCache &boneCache=*ghoul2.mBoneCache;
+	boltCache_t &cached=boneCache.mBoltCache[boltNum&(G2_BOLT_CACHE_SIZE-1)];
+	const boltInfo_t &bolt=ghoul2.mBltlist[boltNum];
+
+	cached.touch=boneCache.mCurrentTouch;
+	cached.boltIndex=boltNum;
+	cached.boneNumber=bolt.boneNumber;
+	cached.surfaceNumber=bolt.surfaceNumber;
+	cached.spMethod=spMethod;
+	VectorCopy(angles,cached.angles);
+	VectorCopy(position,cached.position);
+	VectorCopy(scale,cached.scale);
+	cached.matrix=matrix;
+	cached.world=worldMatrix;
+	cached.worldInv=worldMatrixInv;
+}
+
+// for changes that move bolts without the bones being transformed again
+void G2_ClearBoltCache(CGhoul2Info &ghoul2)
+{
+	if (!ghoul2.mBoneCache)
+	{
+		return;
+	}
+
+	for (int i=0;i<G2_BOLT_CACHE_SIZE;i++)
+	{
+		ghoul2.mBoneCache->mBoltCache[i].touch=0;
+	}
+}
+
 static void RootMatrix(CGhoul2Info_v &ghoul2,int time,const vec3_t scale,mdxaBone_t &retMatrix)
 {
 	int i;
@@ -3352,6 +3475,17 @@ void R_AddGhoulSurfaces( trRefEntity_t *ent ) {
 			{
 				RS.renderfx |= RF_NOSHADOW;
 			}
+
+			backEndData_t *data = backEndData[tr.smpFrame];
+			const int numBones = (int)RS.boneCache->mBones.size();
+			if (data->numGhoul2Bones + numBones > MAX_GHOUL2_RENDER_BONES)
+			{
+				ri.Printf( PRINT_DEVELOPER, S_COLOR_YELLOW "WARNING: R_AddGhoulSurfaces: MAX_GHOUL2_RENDER_BONES reached\n" );
+				continue;
+			}
+			RS.renderBones = &data->ghoul2Bones[data->numGhoul2Bones];
+			data->numGhoul2Bones += numBones;
+
 			RenderSurfaces(RS);
 		}
 	}
@@ -3594,7 +3728,7 @@ void RB_SurfaceGhoul( CRenderableSurface *surf )
 	// grab the pointer to the surface info within the loaded mesh file
 	mdxmSurface_t	*surface = surf->surfaceData;
 
-	CBoneCache *bones = surf->boneCache;
+	const mdxaBone_t *bones = surf->bones;
 
 #ifndef _G2_GORE //we use this later, for gore
 	delete surf;
@@ -3648,7 +3782,7 @@ void RB_SurfaceGhoul( CRenderableSurface *surf )
 			k=0;
 			int		iBoneIndex = G2_GetVertBoneIndex( v, k );
 			float	fBoneWeight = G2_GetVertBoneWeight( v, k, fTotalWeight, iNumWeights );
-			const mdxaBone_t *bone = &bones->EvalRender(piBoneReferences[iBoneIndex]);
+			const mdxaBone_t *bone = &bones[piBoneReferences[iBoneIndex]];
 
 			tess.xyz[baseVertex][0] = fBoneWeight * ( DotProduct( bone->matrix[0], v->vertCoords ) + bone->matrix[0][3] );
 			tess.xyz[baseVertex][1] = fBoneWeight * ( DotProduct( bone->matrix[1], v->vertCoords ) + bone->matrix[1][3] );
@@ -3663,7 +3797,7 @@ void RB_SurfaceGhoul( CRenderableSurface *surf )
 				iBoneIndex	= G2_GetVertBoneIndex( v, k );
 				fBoneWeight	= G2_GetVertBoneWeight( v, k, fTotalWeight, iNumWeights );
 
-				bone = &bones->EvalRender(piBoneReferences[iBoneIndex]);
+				bone = &bones[piBoneReferences[iBoneIndex]];
 
 				tess.xyz[baseVertex][0] += fBoneWeight * ( DotProduct( bone->matrix[0], v->vertCoords ) + bone->matrix[0][3] );
 				tess.xyz[baseVertex][1] += fBoneWeight * ( DotProduct( bone->matrix[1], v->vertCoords ) + bone->matrix[1][3] );
@@ -3690,7 +3824,7 @@ void RB_SurfaceGhoul( CRenderableSurface *surf )
 		for ( j = 0; j < numVerts; j++, baseVertex++,v++ )
 		{
 
-			bone = &bones->EvalRender(piBoneReferences[G2_GetVertBoneIndex( v, 0 )]);
+			bone = &bones[piBoneReferences[G2_GetVertBoneIndex( v, 0 )]];
 			int iNumWeights = G2_GetVertWeights( v );
 			tess.normal[baseVertex][0] = DotProduct( bone->matrix[0], v->normal );
 			tess.normal[baseVertex][1] = DotProduct( bone->matrix[1], v->normal );
@@ -3707,7 +3841,7 @@ void RB_SurfaceGhoul( CRenderableSurface *surf )
 				fBoneWeight = G2_GetVertBoneWeightNotSlow( v, 0);
 				if (iNumWeights==2)
 				{
-					bone2 = &bones->EvalRender(piBoneReferences[G2_GetVertBoneIndex( v, 1 )]);
+					bone2 = &bones[piBoneReferences[G2_GetVertBoneIndex( v, 1 )]];
 					/*
 					useless transposition
 					tess.xyz[baseVertex][0] =
@@ -3736,7 +3870,7 @@ void RB_SurfaceGhoul( CRenderableSurface *surf )
 					fTotalWeight=fBoneWeight;
 					for (k=1; k < iNumWeights-1 ; k++)
 					{
-						bone = &bones->EvalRender(piBoneReferences[G2_GetVertBoneIndex( v, k )]);
+						bone = &bones[piBoneReferences[G2_GetVertBoneIndex( v, k )]];
 						fBoneWeight = G2_GetVertBoneWeightNotSlow( v, k);
 						fTotalWeight += fBoneWeight;
 
@@ -3744,7 +3878,7 @@ void RB_SurfaceGhoul( CRenderableSurface *surf )
 						tess.xyz[baseVertex][1] += fBoneWeight * ( DotProduct( bone->matrix[1], v->vertCoords ) + bone->matrix[1][3] );
 						tess.xyz[baseVertex][2] += fBoneWeight * ( DotProduct( bone->matrix[2], v->vertCoords ) + bone->matrix[2][3] );
 					}
-					bone = &bones->EvalRender(piBoneReferences[G2_GetVertBoneIndex( v, k )]);
+					bone = &bones[piBoneReferences[G2_GetVertBoneIndex( v, k )]];
 					fBoneWeight	= 1.0f-fTotalWeight;
 
 					tess.xyz[baseVertex][0] += fBoneWeight * ( DotProduct( bone->matrix[0], v->vertCoords ) + bone->matrix[0][3] );
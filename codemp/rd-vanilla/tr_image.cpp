@@ -555,6 +555,7 @@ static void R_Images_DeleteImageContents( image_t *pImage )
 	assert(pImage);	// should never be called with NULL
 	if (pImage)
 	{
+		R_SyncRenderThread();
 		qglDeleteTextures( 1, &pImage->texnum );
 		Z_Free(pImage);
 	}
@@ -986,6 +987,9 @@ image_t *R_CreateImage( const char *name, const byte *pic, int width, int height
 		Com_Error (ERR_DROP, "R_CreateImage: \"%s\" is too long\n", name);
 	}
 
+	// uploading needs the GL context
+	R_SyncRenderThread();
+
 	if(glConfig.clampToEdgeAvailable && glWrapClampMode == GL_CLAMP) {
 		glWrapClampMode = GL_CLAMP_TO_EDGE;
 	}
@@ -45,6 +45,10 @@ cvar_t	*r_detailTextures;
 
 cvar_t	*r_znear;
 
+cvar_t	*r_simd;
+
+cvar_t	*r_smp;
+
 cvar_t	*r_skipBackEnd;
 
 cvar_t	*r_measureOverdraw;
@@ -225,6 +229,13 @@ PFNGLSTENCILOPSEPARATEPROC qglStencilOpSeparate;
 PFNGLACTIVETEXTUREARBPROC qglActiveTextureARB;
 PFNGLCLIENTACTIVETEXTUREARBPROC qglClientActiveTextureARB;
 PFNGLMULTITEXCOORD2FARBPROC qglMultiTexCoord2fARB;
+
+PFNGLGENBUFFERSARBPROC qglGenBuffersARB;
+PFNGLDELETEBUFFERSARBPROC qglDeleteBuffersARB;
+PFNGLBINDBUFFERARBPROC qglBindBufferARB;
+PFNGLBUFFERDATAARBPROC qglBufferDataARB;
+PFNGLMAPBUFFERARBPROC qglMapBufferARB;
+PFNGLUNMAPBUFFERARBPROC qglUnmapBufferARB;
 #if !defined(__APPLE__)
 PFNGLTEXIMAGE3DPROC qglTexImage3D;
 PFNGLTEXSUBIMAGE3DPROC qglTexSubImage3D;
@@ -566,6 +577,38 @@ static void GLimp_InitExtensions( void )
 		Com_Printf ("...GL_EXT_compiled_vertex_array not found\n" );
 	}
 
+	// GL_ARB_pixel_buffer_object, for reading video frames back a frame late
+	// instead of waiting for the GPU
+	qglGenBuffersARB = NULL;
+	qglDeleteBuffersARB = NULL;
+	qglBindBufferARB = NULL;
+	qglBufferDataARB = NULL;
+	qglMapBufferARB = NULL;
+	qglUnmapBufferARB = NULL;
+	if ( ri.GL_ExtensionSupported( "GL_ARB_pixel_buffer_object" ) && ri.GL_ExtensionSupported( "GL_ARB_vertex_buffer_object" ) )
+	{
+		qglGenBuffersARB = ( PFNGLGENBUFFERSARBPROC ) ri.GL_GetProcAddress( "glGenBuffersARB" );
+		qglDeleteBuffersARB = ( PFNGLDELETEBUFFERSARBPROC ) ri.GL_GetProcAddress( "glDeleteBuffersARB" );
+		qglBindBufferARB = ( PFNGLBINDBUFFERARBPROC ) ri.GL_GetProcAddress( "glBindBufferARB" );
+		qglBufferDataARB = ( PFNGLBUFFERDATAARBPROC ) ri.GL_GetProcAddress( "glBufferDataARB" );
+		qglMapBufferARB = ( PFNGLMAPBUFFERARBPROC ) ri.GL_GetProcAddress( "glMapBufferARB" );
+		qglUnmapBufferARB = ( PFNGLUNMAPBUFFERARBPROC ) ri.GL_GetProcAddress( "glUnmapBufferARB" );
+
+		if ( qglGenBuffersARB && qglDeleteBuffersARB && qglBindBufferARB && qglBufferDataARB && qglMapBufferARB && qglUnmapBufferARB )
+		{
+			Com_Printf ("...using GL_ARB_pixel_buffer_object\n" );
+		}
+		else
+		{
+			qglMapBufferARB = NULL;
+			Com_Printf ("...GL_ARB_pixel_buffer_object not found\n" );
+		}
+	}
+	else
+	{
+		Com_Printf ("...GL_ARB_pixel_buffer_object not found\n" );
+	}
+
 	bool bNVRegisterCombiners = false;
 	// Register Combiners.
 	if ( ri.GL_ExtensionSupported( "GL_NV_register_combiners" ) )
@@ -927,62 +970,48 @@ byte *RB_ReadPixels(int x, int y, int width, int height, size_t *offset, int *pa
 
 /*
 ==================
-R_TakeScreenshot
+R_QueueScreenshot
+
+Reads the screen back and hands it to the capture thread to encode. The file
+is written by the front end on a later frame.
 ==================
 */
-void R_TakeScreenshot( int x, int y, int width, int height, char *fileName ) {
-	byte *allbuf, *buffer;
-	byte *srcptr, *destptr;
-	byte *endline, *endmem;
-	byte temp;
-
-	int linelen, padlen;
-	size_t offset = 18, memcount;
-
-	allbuf = RB_ReadPixels(x, y, width, height, &offset, &padlen);
-	buffer = allbuf + offset - 18;
-
-	Com_Memset (buffer, 0, 18);
-	buffer[2] = 2;		// uncompressed type
-	buffer[12] = width & 255;
-	buffer[13] = width >> 8;
-	buffer[14] = height & 255;
-	buffer[15] = height >> 8;
-	buffer[16] = 24;	// pixel size
-
-	// swap rgb to bgr and remove padding from line endings
-	linelen = width * 3;
-
-	srcptr = destptr = allbuf + offset;
-	endmem = srcptr + (linelen + padlen) * height;
-
-	while(srcptr < endmem)
-	{
-		endline = srcptr + linelen;
-
-		while(srcptr < endline)
-		{
-			temp = srcptr[0];
-			*destptr++ = srcptr[2];
-			*destptr++ = srcptr[1];
-			*destptr++ = temp;
-
-			srcptr += 3;
-		}
-
-		// Skip the pad
-		srcptr += padlen;
-	}
-
-	memcount = linelen * height;
+static void R_QueueScreenshot( int x, int y, int width, int height, const char *fileName, captureFormat_t format, qboolean gammaCorrect ) {
+	captureJob_t *job;
+	GLint packAlign;
+	int stride;
 
-	// gamma correct
-	if(glConfig.deviceSupportsGamma && !glConfigExt.doGammaCorrectionWithShaders)
-		R_GammaCorrect(allbuf + offset, memcount);
+	// this comes from the console, which may have left the GL context with
+	// the render thread
+	R_SyncRenderThread();
 
-	ri.FS_WriteFile(fileName, buffer, memcount + 18);
+	qglGetIntegerv(GL_PACK_ALIGNMENT, &packAlign);
+	stride = PAD(width * 3, packAlign);
+
+	job = R_GetCaptureJob(stride * height);
+	qglReadPixels(x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, job->pixels);
+
+	job->encode = R_EncodeCapture;
+	job->write = R_WriteCapture;
+	job->width = width;
+	job->height = height;
+	job->stride = stride;
+	job->format = format;
+	job->quality = r_screenshotJpegQuality->integer;
+	job->gammaCorrect = gammaCorrect ? true : false;
+	Q_strncpyz(job->fileName, fileName, sizeof(job->fileName));
+
+	R_QueueCaptureJob(job);
+}
 
-	ri.Hunk_FreeTempMemory(allbuf);
+/*
+==================
+R_TakeScreenshot
+==================
+*/
+void R_TakeScreenshot( int x, int y, int width, int height, char *fileName ) {
+	R_QueueScreenshot( x, y, width, height, fileName, CAPTURE_TGA,
+		(qboolean)(glConfig.deviceSupportsGamma && !glConfigExt.doGammaCorrectionWithShaders) );
 }
 
 /*
@@ -991,13 +1020,7 @@ R_TakeScreenshotPNG
 ==================
 */
 void R_TakeScreenshotPNG( int x, int y, int width, int height, char *fileName ) {
-	byte *buffer=NULL;
-	size_t offset=0;
-	int padlen=0;
-
-	buffer = RB_ReadPixels( x, y, width, height, &offset, &padlen );
-	RE_SavePNG( fileName, buffer, width, height, 3 );
-	ri.Hunk_FreeTempMemory( buffer );
+	R_QueueScreenshot( x, y, width, height, fileName, CAPTURE_PNG, qfalse );
 }
 
 /*
@@ -1006,19 +1029,8 @@ R_TakeScreenshotJPEG
 ==================
 */
 void R_TakeScreenshotJPEG( int x, int y, int width, int height, char *fileName ) {
-	byte *buffer;
-	size_t offset = 0, memcount;
-	int padlen;
-
-	buffer = RB_ReadPixels(x, y, width, height, &offset, &padlen);
-	memcount = (width * 3 + padlen) * height;
-
-	// gamma correct
-	if(glConfig.deviceSupportsGamma && !glConfigExt.doGammaCorrectionWithShaders)
-		R_GammaCorrect(buffer + offset, memcount);
-
-	RE_SaveJPG(fileName, r_screenshotJpegQuality->integer, width, height, buffer + offset, padlen);
-	ri.Hunk_FreeTempMemory(buffer);
+	R_QueueScreenshot( x, y, width, height, fileName, CAPTURE_JPEG,
+		(qboolean)(glConfig.deviceSupportsGamma && !glConfigExt.doGammaCorrectionWithShaders) );
 }
 
 /*
@@ -1059,6 +1071,7 @@ static void R_LevelShot( void ) {
 
 	Com_sprintf( checkname, sizeof(checkname), "levelshots/%s.tga", tr.world->baseName );
 
+	R_SyncRenderThread();
 	allsource = RB_ReadPixels(0, 0, glConfig.vidWidth, glConfig.vidHeight, &offset, &padlen);
 	source = allsource + offset;
 
@@ -1227,78 +1240,152 @@ void R_ScreenShot_f (void) {
 /*
 ==================
 RB_TakeVideoFrameCmd
+
+With pixel buffer objects each frame is read back into one of two buffers,
+and handed to the capture thread when the next frame is taken, so that
+glReadPixels doesn't wait for the GPU. Without them the frame is read back
+right away, but is still encoded and written off this thread.
 ==================
 */
+typedef struct videoReadback_s {
+	GLuint		pbo;
+	int			pboSize;
+	int			width;
+	int			height;
+	int			stride;
+	qboolean	motionJpeg;
+	qboolean	pending;
+} videoReadback_t;
+
+static videoReadback_t	videoReadbacks[2];
+static int				videoReadbackCount;
+
+static captureJob_t *R_GetVideoFrameJob( int width, int height, int stride, qboolean motionJpeg )
+{
+	captureJob_t *job = R_GetCaptureJob( stride * height );
+
+	job->encode = R_EncodeCapture;
+	job->write = R_WriteCaptureVideoFrame;
+	job->width = width;
+	job->height = height;
+	job->stride = stride;
+	job->format = motionJpeg ? CAPTURE_AVI_MJPEG : CAPTURE_AVI_RAW;
+	job->quality = r_aviMotionJpegQuality->integer;
+	job->gammaCorrect = glConfig.deviceSupportsGamma && !glConfigExt.doGammaCorrectionWithShaders;
+
+	return job;
+}
+
+static void R_QueueVideoReadback( videoReadback_t *video )
+{
+	const size_t size = video->stride * video->height;
+	captureJob_t *job = R_GetVideoFrameJob( video->width, video->height, video->stride, video->motionJpeg );
+	byte *pixels;
+
+	qglBindBufferARB( GL_PIXEL_PACK_BUFFER_ARB, video->pbo );
+	pixels = (byte *)qglMapBufferARB( GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB );
+	if ( pixels )
+	{
+		Com_Memcpy( job->pixels, pixels, size );
+		qglUnmapBufferARB( GL_PIXEL_PACK_BUFFER_ARB );
+	}
+	else
+	{
+		// keep the video in step with the audio
+		Com_Memset( job->pixels, 0, size );
+	}
+	qglBindBufferARB( GL_PIXEL_PACK_BUFFER_ARB, 0 );
+
+	R_QueueCaptureJob( job );
+	video->pending = qfalse;
+}
+
 const void *RB_TakeVideoFrameCmd( const void *data )
 {
 	const videoFrameCommand_t	*cmd;
-	byte				*cBuf;
-	size_t				memcount, linelen;
-	int				padwidth, avipadwidth, padlen, avipadlen;
+	videoReadback_t		*video, *previous;
+	int					stride, size;
 	GLint packAlign;
 
 	cmd = (const videoFrameCommand_t *)data;
 
 	qglGetIntegerv(GL_PACK_ALIGNMENT, &packAlign);
+	stride = PAD(cmd->width * 3, packAlign);
+	size = stride * cmd->height;
 
-	linelen = cmd->width * 3;
+	if ( !qglMapBufferARB )
+	{
+		captureJob_t *job = R_GetVideoFrameJob( cmd->width, cmd->height, stride, cmd->motionJpeg );
 
-	// Alignment stuff for glReadPixels
-	padwidth = PAD(linelen, packAlign);
-	padlen = padwidth - linelen;
-	// AVI line padding
-	avipadwidth = PAD(linelen, AVI_LINE_PADDING);
-	avipadlen = avipadwidth - linelen;
+		qglReadPixels(0, 0, cmd->width, cmd->height, GL_RGB, GL_UNSIGNED_BYTE, job->pixels);
+		R_QueueCaptureJob( job );
 
-	cBuf = (byte *)PADP(cmd->captureBuffer, packAlign);
+		return (const void *)(cmd + 1);
+	}
 
-	qglReadPixels(0, 0, cmd->width, cmd->height, GL_RGB,
-		GL_UNSIGNED_BYTE, cBuf);
+	// the previous frame has had a whole frame to arrive
+	video = &videoReadbacks[videoReadbackCount & 1];
+	previous = &videoReadbacks[(videoReadbackCount + 1) & 1];
+	if ( previous->pending )
+		R_QueueVideoReadback( previous );
 
-	memcount = padwidth * cmd->height;
+	if ( !video->pbo )
+		qglGenBuffersARB( 1, &video->pbo );
 
-	// gamma correct
-	if(glConfig.deviceSupportsGamma && !glConfigExt.doGammaCorrectionWithShaders)
-		R_GammaCorrect(cBuf, memcount);
-
-	if(cmd->motionJpeg)
+	qglBindBufferARB( GL_PIXEL_PACK_BUFFER_ARB, video->pbo );
+	if ( video->pboSize < size )
 	{
-		memcount = RE_SaveJPGToBuffer(cmd->encodeBuffer, linelen * cmd->height,
-			r_aviMotionJpegQuality->integer,
-			cmd->width, cmd->height, cBuf, padlen);
-		ri.CL_WriteAVIVideoFrame(cmd->encodeBuffer, memcount);
+		qglBufferDataARB( GL_PIXEL_PACK_BUFFER_ARB, size, NULL, GL_STREAM_READ_ARB );
+		video->pboSize = size;
 	}
-	else
-	{
-		byte *lineend, *memend;
-		byte *srcptr, *destptr;
+	qglReadPixels(0, 0, cmd->width, cmd->height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+	qglBindBufferARB( GL_PIXEL_PACK_BUFFER_ARB, 0 );
 
-		srcptr = cBuf;
-		destptr = cmd->encodeBuffer;
-		memend = srcptr + memcount;
+	video->width = cmd->width;
+	video->height = cmd->height;
+	video->stride = stride;
+	video->motionJpeg = cmd->motionJpeg;
+	video->pending = qtrue;
+	videoReadbackCount++;
 
-		// swap R and B and remove line paddings
-		while(srcptr < memend)
-		{
-			lineend = srcptr + linelen;
-			while(srcptr < lineend)
-			{
-				*destptr++ = srcptr[2];
-				*destptr++ = srcptr[1];
-				*destptr++ = srcptr[0];
-				srcptr += 3;
-			}
+	return (const void *)(cmd + 1);
+}
+
+/*
+==================
+RE_FinishVideoFrames
 
-			Com_Memset(destptr, '\0', avipadlen);
-			destptr += avipadlen;
+Hands the frames still being read back to the capture thread and waits for
+all of them to be written to the video.
+==================
+*/
+void RE_FinishVideoFrames( void )
+{
+	if ( tr.registered )
+	{
+		// the pixel buffers need the GL context
+		R_IssuePendingRenderCommands();
 
-			srcptr += padlen;
+		for ( int i = 0; i < 2; i++ )
+		{
+			videoReadback_t *video = &videoReadbacks[(videoReadbackCount + i) & 1];
+			if ( video->pending )
+				R_QueueVideoReadback( video );
 		}
-
-		ri.CL_WriteAVIVideoFrame(cmd->encodeBuffer, avipadwidth * cmd->height);
 	}
 
-	return (const void *)(cmd + 1);
+	R_FinishCaptureJobs();
+}
+
+static void R_ShutdownVideoReadbacks( void )
+{
+	for ( int i = 0; i < 2; i++ )
+	{
+		if ( videoReadbacks[i].pbo )
+			qglDeleteBuffersARB( 1, &videoReadbacks[i].pbo );
+	}
+	Com_Memset( videoReadbacks, 0, sizeof( videoReadbacks ) );
+	videoReadbackCount = 0;
 }
 
 //============================================================================
@@ -1500,6 +1587,7 @@ void GfxInfo_f( void )
 			ri.Printf( PRINT_ALL, "%f)\n", glConfig.maxTextureFilterAnisotropy);
 	}
 	ri.Printf( PRINT_ALL, "Dynamic Glow: %s\n", enablestrings[r_DynamicGlow->integer ? 1 : 0] );
+	ri.Printf( PRINT_ALL, "render thread: %s\n", enablestrings[R_RenderThreadActive() ? 1 : 0] );
 	if (g_bTextureRectangleHack) ri.Printf( PRINT_ALL, "Dynamic Glow ATI BAD DRIVER HACK %s\n", enablestrings[g_bTextureRectangleHack] );
 
 	if ( r_finish->integer ) {
@@ -1605,6 +1693,8 @@ void R_Register( void )
 
 	r_znear								= ri.Cvar_Get( "r_znear",							"4",						CVAR_ARCHIVE_ND, "" );
 	ri.Cvar_CheckRange( r_znear, 0.001f, 10, qfalse );
+	r_simd								= ri.Cvar_Get( "r_simd",							"1",						CVAR_ARCHIVE_ND, "Use SSE2/NEON code paths where available" );
+	r_smp								= ri.Cvar_Get( "r_smp",							"0",						CVAR_ARCHIVE_ND|CVAR_LATCH, "Run the renderer back end on its own thread" );
 	r_ignoreGLErrors					= ri.Cvar_Get( "r_ignoreGLErrors",					"1",						CVAR_ARCHIVE_ND, "" );
 	r_fastsky							= ri.Cvar_Get( "r_fastsky",						"0",						CVAR_ARCHIVE_ND, "" );
 	r_inGameVideo						= ri.Cvar_Get( "r_inGameVideo",					"1",						CVAR_ARCHIVE_ND, "" );
@@ -1772,10 +1862,19 @@ void R_Init( void ) {
 	max_polys = Q_min( r_maxpolys->integer, DEFAULT_MAX_POLYS );
 	max_polyverts = Q_min( r_maxpolyverts->integer, DEFAULT_MAX_POLYVERTS );
 
-	ptr = (byte *)Hunk_Alloc( sizeof( *backEndData ) + sizeof(srfPoly_t) * max_polys + sizeof(polyVert_t) * max_polyverts, h_low);
-	backEndData = (backEndData_t *) ptr;
-	backEndData->polys = (srfPoly_t *) ((char *) ptr + sizeof( *backEndData ));
-	backEndData->polyVerts = (polyVert_t *) ((char *) ptr + sizeof( *backEndData ) + sizeof(srfPoly_t) * max_polys);
+	for ( i = 0; i < SMP_FRAMES; i++ )
+	{
+		if ( i > 0 && !r_smp->integer )
+		{
+			backEndData[i] = NULL;
+			continue;
+		}
+
+		ptr = (byte *)Hunk_Alloc( sizeof( *backEndData[i] ) + sizeof(srfPoly_t) * max_polys + sizeof(polyVert_t) * max_polyverts, h_low);
+		backEndData[i] = (backEndData_t *) ptr;
+		backEndData[i]->polys = (srfPoly_t *) ((char *) ptr + sizeof( *backEndData[i] ));
+		backEndData[i]->polyVerts = (polyVert_t *) ((char *) ptr + sizeof( *backEndData[i] ) + sizeof(srfPoly_t) * max_polys);
+	}
 
 	R_InitNextFrame();
 
@@ -1804,6 +1903,12 @@ void R_Init( void ) {
 #endif
 
 	RestoreGhoul2InfoArray();
+
+	if ( r_smp->integer && !R_SpawnRenderThread( RB_ExecuteRenderCommands, RB_MakeCurrent ) )
+	{
+		ri.Printf( PRINT_WARNING, "Couldn't start the render thread, rendering on the main thread\n" );
+	}
+
 	// print info
 	GfxInfo_f();
 
@@ -1822,6 +1927,14 @@ void RE_Shutdown( qboolean destroyWindow, qboolean restarting ) {
 	for ( size_t i = 0; i < numCommands; i++ )
 		ri.Cmd_RemoveCommand( commands[i].cmd );
 
+	// everything below needs the GL context back on this thread
+	R_ShutdownRenderThread();
+
+	// write out whatever is still being captured before the buffers go
+	RE_FinishVideoFrames();
+	R_ShutdownVideoReadbacks();
+	R_ShutdownCaptureThread();
+
 	if ( r_DynamicGlow && r_DynamicGlow->integer )
 	{
 		// Release the Glow Vertex Shader.
@@ -1868,6 +1981,7 @@ void RE_Shutdown( qboolean destroyWindow, qboolean restarting ) {
 	}
 
 	R_ShutdownWorldEffects();
+	R_ClearSurfaceSpriteCache();
 	R_ShutdownFonts();
 	if ( tr.registered ) {
 		R_IssuePendingRenderCommands();
@@ -2051,6 +2165,7 @@ Q_EXPORT refexport_t* QDECL GetRefAPI( int apiVersion, refimport_t *rimp ) {
 
 	// AVI recording
 	re.TakeVideoFrame						= RE_TakeVideoFrame;
+	re.FinishVideoFrames					= RE_FinishVideoFrames;
 
 	// G2 stuff
 	re.InitSkins							= R_InitSkins;
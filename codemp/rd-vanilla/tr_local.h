@@ -26,6 +26,7 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "qcommon/qfiles.h"
 #include "rd-common/tr_public.h"
 #include "rd-common/tr_common.h"
+#include "rd-common/tr_renderthread.h"
 #include "ghoul2/ghoul2_shared.h" //rwwRMG - added
 #include "qgl.h"
 
@@ -787,8 +788,21 @@ typedef struct mnode_s {
 
 	msurface_t	**firstmarksurface;
 	int			nummarksurfaces;
+
+	int			*firstmarktriangle;		// indexes into world_t::markTriangles
+	int			nummarktriangles;
 } mnode_t;
 
+// A world triangle that marks can be projected onto, built at load by R_BuildMarkTriangles.
+typedef struct markTriangle_s {
+	vec3_t		points[3];
+	vec3_t		mins, maxs;
+	vec3_t		normal;
+	float		maxFacing;		// only marked if DotProduct( normal, projection ) is below this
+	int			markCount;		// last R_MarkFragments call that looked at this triangle
+	qboolean	triangleMesh;	// from a SF_TRIANGLES surface, only marked with r_marksOnTriangleMeshes
+} markTriangle_t;
+
 typedef struct bmodel_s {
 	vec3_t		bounds[2];		// for culling
 	msurface_t	*firstSurface;
@@ -829,6 +843,9 @@ typedef struct world_s {
 	int			nummarksurfaces;
 	msurface_t	**marksurfaces;
 
+	int			numMarkTriangles;
+	markTriangle_t	*markTriangles;
+
 	int			numfogs;
 	fog_t		*fogs;
 	int			globalFog;
@@ -882,6 +899,9 @@ void		R_Modellist_f (void);
 #define	MAX_DRAWSURFS			0x10000
 #define	DRAWSURF_MASK			(MAX_DRAWSURFS-1)
 
+// ghoul2 skinning matrices the front end can hand the back end each frame
+#define	MAX_GHOUL2_RENDER_BONES	0x4000
+
 /*
 
 the drawsurf sort data is packed into a single 32 bit value so it can be
@@ -985,10 +1005,11 @@ typedef struct trGlobals_s {
 	int						frameCount;		// incremented every frame
 	int						sceneCount;		// incremented every scene
 	int						viewCount;		// incremented every view (twice a scene if portaled)
-											// and every R_MarkFragments call
 
 	int						frameSceneNum;	// zeroed at RE_BeginFrame
 
+	int						smpFrame;		// which backEndData the front end fills
+
 	qboolean				worldMapLoaded;
 	world_t					*world;
 	char					worldDir[MAX_QPATH];		// ie: maps/tim_dm2 (copy of world_t::name sans extension but still includes the path)
@@ -1124,6 +1145,10 @@ extern cvar_t	*r_verbose;				// used for verbose debug spew
 
 extern cvar_t	*r_znear;				// near Z clip plane
 
+extern cvar_t	*r_simd;				// use SSE2/NEON code paths
+
+extern cvar_t	*r_smp;					// run the back end on its own thread
+
 extern cvar_t	*r_stencilbits;			// number of desired stencil bits
 extern cvar_t	*r_depthbits;			// number of desired depth bits
 extern cvar_t	*r_colorbits;			// number of desired color bits, only relevant for fullscreen
@@ -1622,6 +1647,7 @@ MARKERS, POLYGON PROJECTION ON WORLD POLYGONS
 */
 
 int R_MarkFragments( int numPoints, const vec3_t *points, const vec3_t projection, int maxPoints, vec3_t pointBuffer, int maxFragments, markFragment_t *fragmentBuffer );
+void R_BuildMarkTriangles( world_t &worldData );
 
 
 /*
@@ -1661,7 +1687,7 @@ public:
 #else
 	const int		ident;			// ident of this surface - required so the materials renderer knows what sort of surface this refers to
 #endif
-	CBoneCache 		*boneCache;
+	const mdxaBone_t	*bones;		// skinning matrices by bone number, copied into backEndData by the front end
 	mdxmSurface_t	*surfaceData;	// pointer to surface data loaded into file - only used by client renderer DO NOT USE IN GAME SIDE - if there is a vid restart this will be out of wack on the game
 #ifdef _G2_GORE
 	float			*alternateTex;		// alternate texture coordinates.
@@ -1676,7 +1702,7 @@ public:
 	CRenderableSurface& operator= ( const CRenderableSurface& src )
 	{
 		ident	 = src.ident;
-		boneCache = src.boneCache;
+		bones = src.bones;
 		surfaceData = src.surfaceData;
 		alternateTex = src.alternateTex;
 		goreChain = src.goreChain;
@@ -1687,7 +1713,7 @@ public:
 
 CRenderableSurface():
 	ident(SF_MDX),
-	boneCache(0),
+	bones(0),
 #ifdef _G2_GORE
 	surfaceData(0),
 	alternateTex(0),
@@ -1701,7 +1727,7 @@ CRenderableSurface():
 	void Init()
 	{
 		ident = SF_MDX;
-		boneCache=0;
+		bones=0;
 		surfaceData=0;
 		alternateTex=0;
 		goreChain=0;
@@ -1756,6 +1782,7 @@ RENDERER BACK END FUNCTIONS
 */
 
 void RB_ExecuteRenderCommands( const void *data );
+void RB_MakeCurrent( bool current );
 
 /*
 =============================================================
@@ -1830,8 +1857,6 @@ typedef struct videoFrameCommand_s {
 	int            commandId;
 	int            width;
 	int            height;
-	byte          *captureBuffer;
-	byte          *encodeBuffer;
 	qboolean      motionJpeg;
 } videoFrameCommand_t;
 
@@ -1859,13 +1884,17 @@ typedef struct backEndData_s {
 	trMiniRefEntity_t	miniEntities[MAX_MINI_ENTITIES];
 	srfPoly_t	*polys;//[MAX_POLYS];
 	polyVert_t	*polyVerts;//[MAX_POLYVERTS];
+	mdxaBone_t	ghoul2Bones[MAX_GHOUL2_RENDER_BONES];
+	int			numGhoul2Bones;
 	renderCommandList_t	commands;
 } backEndData_t;
 
 extern	int		max_polys;
 extern	int		max_polyverts;
 
-extern	backEndData_t	*backEndData;
+#define	SMP_FRAMES		2
+
+extern	backEndData_t	*backEndData[SMP_FRAMES];	// the second one is only allocated with r_smp
 
 
 void RB_ExecuteRenderCommands( const void *data );
@@ -1883,7 +1912,8 @@ void RE_RotatePic2 ( float x, float y, float w, float h,
 					  float s1, float t1, float s2, float t2,float a, qhandle_t hShader );
 void RE_BeginFrame( stereoFrame_t stereoFrame );
 void RE_EndFrame( int *frontEndMsec, int *backEndMsec );
-void RE_TakeVideoFrame( int width, int height, byte *captureBuffer, byte *encodeBuffer, qboolean motionJpeg );
+void RE_TakeVideoFrame( int width, int height, qboolean motionJpeg );
+void RE_FinishVideoFrames( void );
 
 /*
 Ghoul2 Insert Start
@@ -1904,5 +1934,6 @@ void R_AddDecals( void );
 
 // tr_surfacesprites
 void RB_DrawSurfaceSprites( shaderStage_t *stage, shaderCommands_t *input);
+void R_ClearSurfaceSpriteCache( void );
 
 qboolean ShaderHashTableExists(void);
@@ -27,8 +27,6 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 
 #define MAX_VERTS_ON_POLY		64
 
-#define MARKER_OFFSET			0	// 1
-
 /*
 =============
 R_ChopPolyBehindPlane
@@ -128,14 +126,199 @@ static void R_ChopPolyBehindPlane( int numInPoints, vec3_t inPoints[MAX_VERTS_ON
 
 /*
 =================
-R_BoxSurfaces_r
+R_AddMarkTriangle
+=================
+*/
+static void R_AddMarkTriangle( markTriangle_t *tri, const float *p0, const float *p1, const float *p2,
+							   const vec3_t normal, float maxFacing, qboolean triangleMesh ) {
+	VectorCopy( p0, tri->points[0] );
+	VectorCopy( p1, tri->points[1] );
+	VectorCopy( p2, tri->points[2] );
+
+	ClearBounds( tri->mins, tri->maxs );
+	for ( int i = 0 ; i < 3 ; i++ ) {
+		AddPointToBounds( tri->points[i], tri->mins, tri->maxs );
+	}
+
+	VectorCopy( normal, tri->normal );
+	tri->maxFacing = maxFacing;
+	tri->markCount = 0;
+	tri->triangleMesh = triangleMesh;
+}
+
+/*
+=================
+R_SurfaceMarkTriangles
 
+Writes the triangles of a surface that marks can be projected onto to tris, or only
+counts them if tris is NULL.
 =================
 */
-void R_BoxSurfaces_r(mnode_t *node, vec3_t mins, vec3_t maxs, surfaceType_t **list, int listsize, int *listlength, vec3_t dir) {
+static int R_SurfaceMarkTriangles( const msurface_t *surf, markTriangle_t *tris ) {
+	int		numTris = 0;
+	int		i, j, k;
+	vec3_t	v1, v2, normal;
+
+	if ( ( surf->shader->surfaceFlags & ( SURF_NOIMPACT | SURF_NOMARKS ) )
+		|| ( surf->shader->contentFlags & CONTENTS_FOG ) ) {
+		return 0;
+	}
+
+	switch ( *surf->data ) {
+	case SF_GRID: {
+		const srfGridMesh_t *cv = (const srfGridMesh_t *)surf->data;
+
+		// We triangulate the grid; LOD is not taken into account, not such a big deal though.
+		for ( i = 0 ; i < cv->height - 1 ; i++ ) {
+			for ( j = 0 ; j < cv->width - 1 ; j++ ) {
+				const drawVert_t *dv = cv->verts + i * cv->width + j;
+
+				if ( tris ) {
+					VectorSubtract( dv[0].xyz, dv[cv->width].xyz, v1 );
+					VectorSubtract( dv[1].xyz, dv[cv->width].xyz, v2 );
+					CrossProduct( v1, v2, normal );
+					VectorNormalize( normal );
+					R_AddMarkTriangle( &tris[numTris], dv[0].xyz, dv[cv->width].xyz, dv[1].xyz, normal, -0.1f, qfalse );
+
+					VectorSubtract( dv[1].xyz, dv[cv->width].xyz, v1 );
+					VectorSubtract( dv[cv->width+1].xyz, dv[cv->width].xyz, v2 );
+					CrossProduct( v1, v2, normal );
+					VectorNormalize( normal );
+					R_AddMarkTriangle( &tris[numTris+1], dv[1].xyz, dv[cv->width].xyz, dv[cv->width+1].xyz, normal, -0.05f, qfalse );
+				}
+				numTris += 2;
+			}
+		}
+		break;
+	}
+
+	case SF_FACE: {
+		const srfSurfaceFace_t *face = (const srfSurfaceFace_t *)surf->data;
+		const int *indexes = (const int *)( (const byte *)face + face->ofsIndices );
+
+		for ( k = 0 ; k < face->numIndices ; k += 3 ) {
+			if ( tris ) {
+				R_AddMarkTriangle( &tris[numTris],
+								   face->points[0] + VERTEXSIZE * indexes[k],
+								   face->points[0] + VERTEXSIZE * indexes[k+1],
+								   face->points[0] + VERTEXSIZE * indexes[k+2],
+								   face->plane.normal, -0.5f, qfalse );
+			}
+			numTris++;
+		}
+		break;
+	}
+
+	case SF_TRIANGLES: {
+		const srfTriangles_t *mesh = (const srfTriangles_t *)surf->data;
+
+		for ( k = 0 ; k < mesh->numIndexes ; k += 3 ) {
+			if ( tris ) {
+				R_AddMarkTriangle( &tris[numTris],
+								   mesh->verts[mesh->indexes[k]].xyz,
+								   mesh->verts[mesh->indexes[k+1]].xyz,
+								   mesh->verts[mesh->indexes[k+2]].xyz,
+								   vec3_origin, 1.0f, qtrue );
+			}
+			numTris++;
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+
+	return numTris;
+}
+
+static qboolean R_BoundsOverlap( const vec3_t mins1, const vec3_t maxs1, const vec3_t mins2, const vec3_t maxs2 ) {
+	return (qboolean)( mins1[0] <= maxs2[0] && maxs1[0] >= mins2[0]
+					&& mins1[1] <= maxs2[1] && maxs1[1] >= mins2[1]
+					&& mins1[2] <= maxs2[2] && maxs1[2] >= mins2[2] );
+}
+
+/*
+=================
+R_BuildMarkTriangles
+
+Triangulates every world surface that can be marked, and gives each leaf the list of
+triangles that reach into it, so that R_MarkFragments only has to look at the triangles
+near an impact.
+=================
+*/
+void R_BuildMarkTriangles( world_t &worldData ) {
+	int			i, j, k;
+	int			numTris, numRefs;
+	int			*surfTris;
+	int			*refs;
+	mnode_t		*leaf;
+
+	// triangulate the surfaces, remembering where the triangles of each one start
+	surfTris = (int *)Hunk_AllocateTempMemory( ( worldData.numsurfaces + 1 ) * sizeof( int ) );
+	numTris = 0;
+	for ( i = 0 ; i < worldData.numsurfaces ; i++ ) {
+		surfTris[i] = numTris;
+		numTris += R_SurfaceMarkTriangles( &worldData.surfaces[i], NULL );
+	}
+	surfTris[i] = numTris;
+
+	worldData.numMarkTriangles = numTris;
+	worldData.markTriangles = (markTriangle_t *)Hunk_Alloc( numTris * sizeof( markTriangle_t ), h_low );
+	for ( i = 0 ; i < worldData.numsurfaces ; i++ ) {
+		R_SurfaceMarkTriangles( &worldData.surfaces[i], worldData.markTriangles + surfTris[i] );
+	}
+
+	// count and then fill in the triangles of each leaf
+	numRefs = 0;
+	refs = NULL;
+	for ( int pass = 0 ; pass < 2 ; pass++ ) {
+		if ( pass == 1 ) {
+			refs = (int *)Hunk_Alloc( numRefs * sizeof( int ), h_low );
+		}
+
+		for ( i = 0, leaf = worldData.nodes ; i < worldData.numnodes ; i++, leaf++ ) {
+			if ( leaf->contents == -1 ) {
+				continue;
+			}
+
+			leaf->firstmarktriangle = refs;
+			leaf->nummarktriangles = 0;
 
-	int			s, c;
-	msurface_t	*surf, **mark;
+			for ( j = 0 ; j < leaf->nummarksurfaces ; j++ ) {
+				const int surfNum = leaf->firstmarksurface[j] - worldData.surfaces;
+
+				for ( k = surfTris[surfNum] ; k < surfTris[surfNum + 1] ; k++ ) {
+					const markTriangle_t *tri = &worldData.markTriangles[k];
+					if ( !R_BoundsOverlap( tri->mins, tri->maxs, leaf->mins, leaf->maxs ) ) {
+						continue;
+					}
+					if ( refs ) {
+						*refs++ = k;
+					}
+					leaf->nummarktriangles++;
+				}
+			}
+
+			if ( !refs ) {
+				numRefs += leaf->nummarktriangles;
+			}
+		}
+	}
+
+	Hunk_FreeTempMemory( surfTris );
+}
+
+/*
+=================
+R_BoxMarkTriangles_r
+
+Adds the triangles in all leafs touching the box that haven't been seen yet.
+=================
+*/
+static void R_BoxMarkTriangles_r( mnode_t *node, vec3_t mins, vec3_t maxs,
+								  int markCount, int *list, int listsize, int *listlength ) {
+	int		s, i;
 
 	// do the tail recursion in a loop
 	while ( node->contents == -1 ) {
@@ -145,46 +328,25 @@ void R_BoxSurfaces_r(mnode_t *node, vec3_t mins, vec3_t maxs, surfaceType_t **li
 		} else if (s == 2) {
 			node = node->children[1];
 		} else {
-			R_BoxSurfaces_r(node->children[0], mins, maxs, list, listsize, listlength, dir);
+			R_BoxMarkTriangles_r( node->children[0], mins, maxs, markCount, list, listsize, listlength );
 			node = node->children[1];
 		}
 	}
 
-	// add the individual surfaces
-	mark = node->firstmarksurface;
-	c = node->nummarksurfaces;
-	while (c--) {
-		//
-		if (*listlength >= listsize) break;
-		//
-		surf = *mark;
-		// check if the surface has NOIMPACT or NOMARKS set
-		if ( ( surf->shader->surfaceFlags & ( SURF_NOIMPACT | SURF_NOMARKS ) )
-			|| ( surf->shader->contentFlags & CONTENTS_FOG ) ) {
-			surf->viewCount = tr.viewCount;
-		}
-		// extra check for surfaces to avoid list overflows
-		else if (*(surf->data) == SF_FACE) {
-			// the face plane should go through the box
-			s = BoxOnPlaneSide( mins, maxs, &(( srfSurfaceFace_t * ) surf->data)->plane );
-			if (s == 1 || s == 2) {
-				surf->viewCount = tr.viewCount;
-			} else if (DotProduct((( srfSurfaceFace_t * ) surf->data)->plane.normal, dir) > -0.5) {
-			// don't add faces that make sharp angles with the projection direction
-				surf->viewCount = tr.viewCount;
-			}
-		}
-		else if (*(surfaceType_t *) (surf->data) != SF_GRID &&
-			 *(surfaceType_t *) (surf->data) != SF_TRIANGLES)
-			surf->viewCount = tr.viewCount;
-		// check the viewCount because the surface may have
+	for ( i = 0 ; i < node->nummarktriangles && *listlength < listsize ; i++ ) {
+		const int triNum = node->firstmarktriangle[i];
+		markTriangle_t *tri = &tr.world->markTriangles[triNum];
+
+		// check the markCount because the triangle may have
 		// already been added if it spans multiple leafs
-		if (surf->viewCount != tr.viewCount) {
-			surf->viewCount = tr.viewCount;
-			list[*listlength] = (surfaceType_t *) surf->data;
-			(*listlength)++;
+		if ( tri->markCount == markCount ) {
+			continue;
+		}
+		tri->markCount = markCount;
+
+		if ( R_BoundsOverlap( tri->mins, tri->maxs, mins, maxs ) ) {
+			list[(*listlength)++] = triNum;
 		}
-		mark++;
 	}
 }
 
@@ -253,41 +415,45 @@ R_MarkFragments
 
 =================
 */
+#define MAX_MARK_TRIANGLES		1024
+
 int R_MarkFragments( int numPoints, const vec3_t *points, const vec3_t projection,
 				   int maxPoints, vec3_t pointBuffer, int maxFragments, markFragment_t *fragmentBuffer ) {
-	int				numsurfaces, numPlanes;
-	int				i, j, k, m, n;
-	surfaceType_t	*surfaces[64];
+	static int		markCount;
+	int				numTriangles, numPlanes;
+	int				i;
+	int				triangles[MAX_MARK_TRIANGLES];
 	vec3_t			mins, maxs;
 	int				returnedFragments;
 	int				returnedPoints;
 	vec3_t			normals[MAX_VERTS_ON_POLY+2];
 	float			dists[MAX_VERTS_ON_POLY+2];
 	vec3_t			clipPoints[2][MAX_VERTS_ON_POLY];
-	int				numClipPoints;
-	float			*v;
-	srfGridMesh_t	*cv;
-	drawVert_t		*dv;
-	vec3_t			normal;
 	vec3_t			projectionDir;
 	vec3_t			v1, v2;
-	int				*indexes;
 
-	//increment view count for double check prevention
-	tr.viewCount++;
+	if ( !tr.world || !tr.world->markTriangles ) {
+		return 0;
+	}
+
+	//increment mark count for double check prevention
+	markCount++;
 
 	//
 	VectorNormalize2( projection, projectionDir );
-	// find all the brushes that are to be considered
+	// find the volume the near and far clipping planes below leave of the projected polygon,
+	// with a unit to spare for the clipping epsilon
 	ClearBounds( mins, maxs );
 	for ( i = 0 ; i < numPoints ; i++ ) {
 		vec3_t	temp;
+		float	d;
+
+		VectorSubtract( points[i], points[0], temp );
+		d = DotProduct( temp, projectionDir );
 
-		AddPointToBounds( points[i], mins, maxs );
-		VectorAdd( points[i], projection, temp );
+		VectorMA( points[i], -33 - d, projectionDir, temp );
 		AddPointToBounds( temp, mins, maxs );
-		// make sure we get all the leafs (also the one(s) in front of the hit surface)
-		VectorMA( points[i], -20, projectionDir, temp );
+		VectorMA( points[i], 21 - d, projectionDir, temp );
 		AddPointToBounds( temp, mins, maxs );
 	}
 
@@ -309,146 +475,35 @@ int R_MarkFragments( int numPoints, const vec3_t *points, const vec3_t projectio
 	dists[numPoints+1] = DotProduct(normals[numPoints+1], points[0]) - 20;
 	numPlanes = numPoints + 2;
 
-	numsurfaces = 0;
-	R_BoxSurfaces_r(tr.world->nodes, mins, maxs, surfaces, 64, &numsurfaces, projectionDir);
-	//assert(numsurfaces <= 64);
-	//assert(numsurfaces != 64);
+	numTriangles = 0;
+	R_BoxMarkTriangles_r( tr.world->nodes, mins, maxs, markCount, triangles, MAX_MARK_TRIANGLES, &numTriangles );
 
 	returnedPoints = 0;
 	returnedFragments = 0;
 
-	for ( i = 0 ; i < numsurfaces ; i++ ) {
-
-		if (*surfaces[i] == SF_GRID) {
-
-			cv = (srfGridMesh_t *) surfaces[i];
-			for ( m = 0 ; m < cv->height - 1 ; m++ ) {
-				for ( n = 0 ; n < cv->width - 1 ; n++ ) {
-					// We triangulate the grid and chop all triangles within
-					// the bounding planes of the to be projected polygon.
-					// LOD is not taken into account, not such a big deal though.
-					//
-					// It's probably much nicer to chop the grid itself and deal
-					// with this grid as a normal SF_GRID surface so LOD will
-					// be applied. However the LOD of that chopped grid must
-					// be synced with the LOD of the original curve.
-					// One way to do this; the chopped grid shares vertices with
-					// the original curve. When LOD is applied to the original
-					// curve the unused vertices are flagged. Now the chopped curve
-					// should skip the flagged vertices. This still leaves the
-					// problems with the vertices at the chopped grid edges.
-					//
-					// To avoid issues when LOD applied to "hollow curves" (like
-					// the ones around many jump pads) we now just add a 2 unit
-					// offset to the triangle vertices.
-					// The offset is added in the vertex normal vector direction
-					// so all triangles will still fit together.
-					// The 2 unit offset should avoid pretty much all LOD problems.
-
-					numClipPoints = 3;
-
-					dv = cv->verts + m * cv->width + n;
-
-					VectorCopy(dv[0].xyz, clipPoints[0][0]);
-					VectorMA(clipPoints[0][0], MARKER_OFFSET, dv[0].normal, clipPoints[0][0]);
-					VectorCopy(dv[cv->width].xyz, clipPoints[0][1]);
-					VectorMA(clipPoints[0][1], MARKER_OFFSET, dv[cv->width].normal, clipPoints[0][1]);
-					VectorCopy(dv[1].xyz, clipPoints[0][2]);
-					VectorMA(clipPoints[0][2], MARKER_OFFSET, dv[1].normal, clipPoints[0][2]);
-					// check the normal of this triangle
-					VectorSubtract(clipPoints[0][0], clipPoints[0][1], v1);
-					VectorSubtract(clipPoints[0][2], clipPoints[0][1], v2);
-					CrossProduct(v1, v2, normal);
-					VectorNormalizeFast(normal);
-					if (DotProduct(normal, projectionDir) < -0.1) {
-						// add the fragments of this triangle
-						R_AddMarkFragments(numClipPoints, clipPoints,
-										   numPlanes, normals, dists,
-										   maxPoints, pointBuffer,
-										   maxFragments, fragmentBuffer,
-										   &returnedPoints, &returnedFragments, mins, maxs);
-
-						if ( returnedFragments == maxFragments ) {
-							return returnedFragments;	// not enough space for more fragments
-						}
-					}
+	for ( i = 0 ; i < numTriangles ; i++ ) {
+		const markTriangle_t *tri = &tr.world->markTriangles[triangles[i]];
 
-					VectorCopy(dv[1].xyz, clipPoints[0][0]);
-					VectorMA(clipPoints[0][0], MARKER_OFFSET, dv[1].normal, clipPoints[0][0]);
-					VectorCopy(dv[cv->width].xyz, clipPoints[0][1]);
-					VectorMA(clipPoints[0][1], MARKER_OFFSET, dv[cv->width].normal, clipPoints[0][1]);
-					VectorCopy(dv[cv->width+1].xyz, clipPoints[0][2]);
-					VectorMA(clipPoints[0][2], MARKER_OFFSET, dv[cv->width+1].normal, clipPoints[0][2]);
-					// check the normal of this triangle
-					VectorSubtract(clipPoints[0][0], clipPoints[0][1], v1);
-					VectorSubtract(clipPoints[0][2], clipPoints[0][1], v2);
-					CrossProduct(v1, v2, normal);
-					VectorNormalizeFast(normal);
-					if (DotProduct(normal, projectionDir) < -0.05) {
-						// add the fragments of this triangle
-						R_AddMarkFragments(numClipPoints, clipPoints,
-										   numPlanes, normals, dists,
-										   maxPoints, pointBuffer,
-										   maxFragments, fragmentBuffer,
-										   &returnedPoints, &returnedFragments, mins, maxs);
-
-						if ( returnedFragments == maxFragments ) {
-							return returnedFragments;	// not enough space for more fragments
-						}
-					}
-				}
-			}
+		if ( tri->triangleMesh && !r_marksOnTriangleMeshes->integer ) {
+			continue;
 		}
-		else if (*surfaces[i] == SF_FACE) {
 
-			srfSurfaceFace_t *surf = ( srfSurfaceFace_t * ) surfaces[i];
-			// check the normal of this face
-			if (DotProduct(surf->plane.normal, projectionDir) > -0.5) {
-				continue;
-			}
-
-			indexes = (int *)( (byte *)surf + surf->ofsIndices );
-			for ( k = 0 ; k < surf->numIndices ; k += 3 ) {
-				for ( j = 0 ; j < 3 ; j++ ) {
-					v = surf->points[0] + VERTEXSIZE * indexes[k+j];;
-					VectorMA( v, MARKER_OFFSET, surf->plane.normal, clipPoints[0][j] );
-				}
-				// add the fragments of this face
-				R_AddMarkFragments( 3 , clipPoints,
-								   numPlanes, normals, dists,
-								   maxPoints, pointBuffer,
-								   maxFragments, fragmentBuffer,
-								   &returnedPoints, &returnedFragments, mins, maxs);
-				if ( returnedFragments == maxFragments ) {
-					return returnedFragments;	// not enough space for more fragments
-				}
-			}
+		// don't add triangles that make sharp angles with the projection direction
+		if ( DotProduct( tri->normal, projectionDir ) >= tri->maxFacing ) {
 			continue;
 		}
-		else if(*surfaces[i] == SF_TRIANGLES && r_marksOnTriangleMeshes->integer) {
 
-			srfTriangles_t *surf = (srfTriangles_t *) surfaces[i];
+		memcpy( clipPoints[0], tri->points, sizeof( tri->points ) );
 
-			for (k = 0; k < surf->numIndexes; k += 3)
-			{
-				for(j = 0; j < 3; j++)
-				{
-					v = surf->verts[surf->indexes[k + j]].xyz;
-					VectorMA(v, MARKER_OFFSET, surf->verts[surf->indexes[k + j]].normal, clipPoints[0][j]);
-				}
-
-				// add the fragments of this face
-				R_AddMarkFragments(3, clipPoints,
-								   numPlanes, normals, dists,
-								   maxPoints, pointBuffer,
-								   maxFragments, fragmentBuffer, &returnedPoints, &returnedFragments, mins, maxs);
-				if(returnedFragments == maxFragments)
-				{
-					return returnedFragments;	// not enough space for more fragments
-				}
-			}
+		// add the fragments of this triangle
+		R_AddMarkFragments( 3, clipPoints,
+						   numPlanes, normals, dists,
+						   maxPoints, pointBuffer,
+						   maxFragments, fragmentBuffer,
+						   &returnedPoints, &returnedFragments, mins, maxs );
+		if ( returnedFragments == maxFragments ) {
+			return returnedFragments;	// not enough space for more fragments
 		}
 	}
 	return returnedFragments;
 }
-
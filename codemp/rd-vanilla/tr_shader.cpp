@@ -45,7 +45,18 @@ static	texModInfo_t	texMods[MAX_SHADER_STAGES][TR_MAX_TEXMODS];
 static	shader_t*		hashTable[FILE_HASH_SIZE];
 
 #define MAX_SHADERTEXT_HASH		2048
-static char **shaderTextHashTable[MAX_SHADERTEXT_HASH] = { 0 };
+
+// Every shader definition in s_shaderText is indexed by name when the shader
+// files are scanned, so looking one up never has to re-parse any text. Each
+// bucket is terminated by an entry with a NULL name.
+// The index points into s_shaderText, which is read from the shader files on
+// every load anyway, so it is rebuilt along with it rather than kept on disk.
+typedef struct shaderTextEntry_s {
+	const char	*name;
+	const char	*text;	// points just past the name, at the opening brace
+} shaderTextEntry_t;
+
+static shaderTextEntry_t *shaderTextHashTable[MAX_SHADERTEXT_HASH] = { 0 };
 
 void KillTheShaderHashTable(void)
 {
@@ -2552,7 +2563,7 @@ sortedIndex.
 extern bool gServerSkinHack;
 static void FixRenderCommandList( int newShader ) {
 	if( !gServerSkinHack ) {
-		renderCommandList_t	*cmdList = &backEndData->commands;
+		renderCommandList_t	*cmdList = &backEndData[tr.smpFrame]->commands;
 
 		if( cmdList ) {
 			const void *curCmd = cmdList->cmds;
@@ -2649,6 +2660,9 @@ static void SortNewShader( void ) {
 	newShader = tr.shaders[ tr.numShaders - 1 ];
 	sort = newShader->sort;
 
+	// the render thread looks shaders up by sortedIndex
+	R_WaitRenderThread();
+
 	for ( i = tr.numShaders - 2 ; i >= 0 ; i-- ) {
 		if ( tr.sortedShaders[ i ]->sort <= sort ) {
 			break;
@@ -3220,18 +3234,19 @@ If found, it will return a valid shader
 static const char *FindShaderInShaderText( const char *shadername ) {
 	char *token;
 	const char *p;
+	const shaderTextEntry_t *entry;
 
-	int i, hash;
+	int hash;
 
 	hash = generateHashValue(shadername, MAX_SHADERTEXT_HASH);
 
 	if ( shaderTextHashTable[hash] ) {
-		for (i = 0; shaderTextHashTable[hash][i]; i++) {
-			p = shaderTextHashTable[hash][i];
-			token = COM_ParseExt(&p, qtrue);
-			if ( !Q_stricmp( token, shadername ) )
-				return p;
+		// the index covers every definition, so a miss here is final
+		for ( entry = shaderTextHashTable[hash]; entry->name; entry++ ) {
+			if ( !Q_stricmp( entry->name, shadername ) )
+				return entry->text;
 		}
+		return NULL;
 	}
 
 	p = s_shaderText;
@@ -3969,8 +3984,9 @@ static void ScanAndLoadShaderFiles( void )
 	const char *p;
 	int numShaderFiles;
 	int i;
-	char *oldp, *token, *hashMem, *textEnd;
-	int shaderTextHashTableSizes[MAX_SHADERTEXT_HASH], hash, size;
+	char *token, *hashMem, *nameMem, *textEnd;
+	int shaderTextHashTableSizes[MAX_SHADERTEXT_HASH], hash, size, nameSize, nameLength;
+	shaderTextEntry_t *entry;
 	char shaderName[MAX_QPATH];
 	int shaderLine;
 
@@ -4076,6 +4092,7 @@ static void ScanAndLoadShaderFiles( void )
 
 	memset(shaderTextHashTableSizes, 0, sizeof(shaderTextHashTableSizes));
 	size = 0;
+	nameSize = 0;
 
 	p = s_shaderText;
 	// look for shader names
@@ -4094,16 +4111,19 @@ static void ScanAndLoadShaderFiles( void )
 		hash = generateHashValue(token, MAX_SHADERTEXT_HASH);
 		shaderTextHashTableSizes[hash]++;
 		size++;
+		nameSize += strlen(token) + 1;
 		SkipBracedSection( &p, 0 );
 	}
 
 	size += MAX_SHADERTEXT_HASH;
 
-	hashMem = (char *)ri.Hunk_Alloc( size * sizeof(char *), h_low );
+	// the entries and a copy of every name share one allocation
+	hashMem = (char *)ri.Hunk_Alloc( size * sizeof(shaderTextEntry_t) + nameSize, h_low );
+	nameMem = hashMem + size * sizeof(shaderTextEntry_t);
 
 	for (i = 0; i < MAX_SHADERTEXT_HASH; i++) {
-		shaderTextHashTable[i] = (char **) hashMem;
-		hashMem = ((char *) hashMem) + ((shaderTextHashTableSizes[i] + 1) * sizeof(char *));
+		shaderTextHashTable[i] = (shaderTextEntry_t *) hashMem;
+		hashMem = ((char *) hashMem) + ((shaderTextHashTableSizes[i] + 1) * sizeof(shaderTextEntry_t));
 	}
 
 	memset(shaderTextHashTableSizes, 0, sizeof(shaderTextHashTableSizes));
@@ -4111,7 +4131,6 @@ static void ScanAndLoadShaderFiles( void )
 	p = s_shaderText;
 	// look for shader names
 	while ( 1 ) {
-		oldp = (char *)p;
 		token = COM_ParseExt( &p, qtrue );
 		if ( token[0] == 0 ) {
 			break;
@@ -4124,7 +4143,13 @@ static void ScanAndLoadShaderFiles( void )
 		}
 
 		hash = generateHashValue(token, MAX_SHADERTEXT_HASH);
-		shaderTextHashTable[hash][shaderTextHashTableSizes[hash]++] = oldp;
+		entry = &shaderTextHashTable[hash][shaderTextHashTableSizes[hash]++];
+
+		nameLength = strlen(token) + 1;
+		Com_Memcpy(nameMem, token, nameLength);
+		entry->name = nameMem;
+		entry->text = p;
+		nameMem += nameLength;
 
 		SkipBracedSection( &p, 0 );
 	}
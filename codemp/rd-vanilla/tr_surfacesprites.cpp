@@ -27,6 +27,8 @@ along with this program; if not, see <http://www.gnu.org/licenses/>.
 #include "tr_quicksprite.h"
 #include "tr_WorldEffects.h"
 
+#include <vector>
+
 
 /////===== Part of the VERTIGON system =====/////
 // The surfacesprites are a simple system.  When a polygon with this shader stage on it is drawn,
@@ -327,6 +329,280 @@ qboolean SSAdditiveTransparency=qfalse;
 qboolean SSUsingFog=qfalse;
 
 
+/////////////////////////////////////////////
+// Sprite placement cache
+
+// Where the sprites of a vertical or oriented stage sit on a triangle and how big they are only
+// depends on the triangle and the stage, so for static geometry that is worked out the first time
+// the triangle is drawn and kept until the next map load.  Every frame then only does the fade,
+// wind and lighting of the sprites that were placed.
+
+#define SS_TRIANGLE_HASH_SIZE	16384
+#define SS_MAX_CACHED_SPRITES	262144
+
+typedef struct ssSprite_s
+{
+	vec3_t	origin;
+	float	fa, fb, fc;				// barycentric position on the triangle
+	float	fadeRandom;				// random part of when the sprite starts to fade
+	float	width, height;			// width before fadeScale, negative if flipped
+	vec2_t	skew;					// vertical sprites only
+	int		rightVector;			// vertical sprites only
+} ssSprite_t;
+
+typedef struct ssTriangle_s
+{
+	const surfaceSprite_t	*ss;
+	vec3_t					xyz[3];
+	int						firstSprite;
+	int						numSprites;
+	int						next;
+} ssTriangle_t;
+
+static std::vector<ssSprite_t>		ssCachedSprites;
+static std::vector<ssTriangle_t>	ssCachedTriangles;
+static int							ssTriangleHash[SS_TRIANGLE_HASH_SIZE];
+static qboolean						ssCacheInitialized = qfalse;
+
+static std::vector<ssSprite_t>		ssScratchSprites;
+static std::vector<float>			ssSpriteAlphaPos;
+static std::vector<float>			ssSpriteAlpha;
+
+// Whether the tess being drawn holds static geometry whose sprites can be cached.
+qboolean SSCacheable=qfalse;
+
+/*
+===============
+R_ClearSurfaceSpriteCache
+
+Forgets all placed sprites. Must be called whenever the shaders or the world change.
+===============
+*/
+void R_ClearSurfaceSpriteCache(void)
+{
+	ssCachedSprites.clear();
+	ssCachedSprites.shrink_to_fit();
+	ssCachedTriangles.clear();
+	ssCachedTriangles.shrink_to_fit();
+	memset(ssTriangleHash, -1, sizeof(ssTriangleHash));
+	ssCacheInitialized = qtrue;
+}
+
+static int RB_HashSurfaceSpriteTriangle(const surfaceSprite_t *ss, const vec3_t v1, const vec3_t v2, const vec3_t v3)
+{
+	const float *verts[3] = { v1, v2, v3 };
+	uint32_t hash = 2166136261u ^ (uint32_t)(size_t)ss;
+
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			uint32_t bits;
+			memcpy(&bits, &verts[i][j], sizeof(bits));
+			hash = (hash ^ bits) * 16777619u;
+		}
+	}
+
+	return (int)((hash ^ (hash >> 16)) & (SS_TRIANGLE_HASH_SIZE - 1));
+}
+
+/*
+===============
+RB_PlaceSurfaceSprites
+
+Appends the sprites of a vertical (or flattened) or an oriented stage on the given triangle to
+sprites. This walks the random chart in exactly the same order the sprites were always generated in,
+so that they keep their places.
+===============
+*/
+static void RB_PlaceSurfaceSprites(const surfaceSprite_t *ss, const vec3_t v1, const vec3_t v2, const vec3_t v3,
+									bool vertical, std::vector<ssSprite_t>& sprites)
+{
+	vec2_t vec1to2, vec1to3;
+	float triarea, step;
+	float posi, posj;
+	float fa, fb;
+	byte randomindex, randominterval, randomindex2;
+	int rightvector = 0;
+	ssSprite_t sprite;
+
+	// Find the area in order to calculate the stepsize
+	vec1to2[0] = v2[0] - v1[0];
+	vec1to2[1] = v2[1] - v1[1];
+	vec1to3[0] = v3[0] - v1[0];
+	vec1to3[1] = v3[1] - v1[1];
+
+	// Now get the cross product of this sum.
+	triarea = vec1to3[0]*vec1to2[1] - vec1to3[1]*vec1to2[0];
+	triarea=fabs(triarea);
+	if (triarea <= 1.0)
+	{	// Insanely small abhorrent triangle.
+		return;
+	}
+	step = ss->density * Q_rsqrt(triarea);
+
+	randomindex = (byte)(v1[0]+v1[1]+v2[0]+v2[1]+v3[0]+v3[1]);
+	randominterval = (byte)(v1[0]+v2[1]+v3[2])|0x03;	// Make sure the interval is at least 3, and always odd
+
+	sprite.skew[0] = sprite.skew[1] = 0;
+	sprite.rightVector = 0;
+
+	for (posi=0; posi<1.0; posi+=step)
+	{
+		for (posj=0; posj<(1.0-posi); posj+=step)
+		{
+			fa=posi+randomchart[randomindex]*step;
+			randomindex += randominterval;
+
+			if (vertical)
+			{
+				fb=posj+randomchart[randomindex]*step;
+				randomindex += randominterval;
+
+				rightvector=(rightvector+1)&3;
+
+				if (fa>1.0)
+					continue;
+			}
+			else
+			{
+				if (fa>1.0)
+					continue;
+
+				fb=posj+randomchart[randomindex]*step;
+				randomindex += randominterval;
+			}
+
+			if (fb>(1.0-fa))
+				continue;
+
+			sprite.fa = fa;
+			sprite.fb = fb;
+			sprite.fc = 1.0-fa-fb;
+
+			VectorScale(v1, sprite.fa, sprite.origin);
+			VectorMA(sprite.origin, sprite.fb, v2, sprite.origin);
+			VectorMA(sprite.origin, sprite.fc, v3, sprite.origin);
+
+			sprite.fadeRandom = randomchart[randomindex];
+			randomindex += randominterval;
+
+			if (!vertical)
+			{
+				randomindex += randominterval;
+			}
+
+			randomindex2 = randomindex;
+			sprite.width = ss->width*(1.0 + (ss->variance[0]*randomchart[randomindex2]));
+			sprite.height = ss->height*(1.0 + (ss->variance[1]*randomchart[randomindex2++]));
+			if (randomchart[randomindex2++]>0.5)
+			{
+				sprite.width = -sprite.width;
+			}
+
+			if (vertical)
+			{
+				if (ss->vertSkew != 0)
+				{	// flrand(-vertskew, vertskew)
+					sprite.skew[0] = sprite.height * ((ss->vertSkew*2.0f*randomchart[randomindex2++])-ss->vertSkew);
+					sprite.skew[1] = sprite.height * ((ss->vertSkew*2.0f*randomchart[randomindex2++])-ss->vertSkew);
+				}
+				sprite.rightVector = rightvector;
+			}
+
+			sprites.push_back(sprite);
+		}
+	}
+}
+
+/*
+===============
+RB_SurfaceSpritesForTriangle
+
+Returns the sprites of the given stage on a triangle, from the cache if the geometry is static.
+===============
+*/
+static const ssSprite_t *RB_SurfaceSpritesForTriangle(const surfaceSprite_t *ss, const vec3_t v1, const vec3_t v2, const vec3_t v3,
+														bool vertical, int *numSprites)
+{
+	if (SSCacheable)
+	{
+		if (!ssCacheInitialized)
+		{
+			R_ClearSurfaceSpriteCache();
+		}
+
+		const int hash = RB_HashSurfaceSpriteTriangle(ss, v1, v2, v3);
+		for (int i = ssTriangleHash[hash]; i >= 0; i = ssCachedTriangles[i].next)
+		{
+			const ssTriangle_t& tri = ssCachedTriangles[i];
+			if (tri.ss == ss && VectorCompare(tri.xyz[0], v1) && VectorCompare(tri.xyz[1], v2) && VectorCompare(tri.xyz[2], v3))
+			{
+				*numSprites = tri.numSprites;
+				return tri.numSprites ? &ssCachedSprites[tri.firstSprite] : NULL;
+			}
+		}
+
+		if (ssCachedSprites.size() < SS_MAX_CACHED_SPRITES)
+		{
+			ssTriangle_t tri;
+			tri.ss = ss;
+			VectorCopy(v1, tri.xyz[0]);
+			VectorCopy(v2, tri.xyz[1]);
+			VectorCopy(v3, tri.xyz[2]);
+			tri.firstSprite = (int)ssCachedSprites.size();
+			RB_PlaceSurfaceSprites(ss, v1, v2, v3, vertical, ssCachedSprites);
+			tri.numSprites = (int)ssCachedSprites.size() - tri.firstSprite;
+			tri.next = ssTriangleHash[hash];
+			ssTriangleHash[hash] = (int)ssCachedTriangles.size();
+			ssCachedTriangles.push_back(tri);
+
+			*numSprites = tri.numSprites;
+			return tri.numSprites ? &ssCachedSprites[tri.firstSprite] : NULL;
+		}
+	}
+
+	// Moving geometry, or the cache is full.
+	ssScratchSprites.clear();
+	RB_PlaceSurfaceSprites(ss, v1, v2, v3, vertical, ssScratchSprites);
+	*numSprites = (int)ssScratchSprites.size();
+	return ssScratchSprites.data();
+}
+
+/*
+===============
+RB_FadeSurfaceSprites
+
+Works out the alpha of all sprites on a triangle in one go, leaving it in ssSpriteAlpha. Sprites with
+an alpha of zero or less aren't drawn.
+===============
+*/
+static void RB_FadeSurfaceSprites(const ssSprite_t *sprites, int numSprites, float a1, float a2, float a3, float faderange)
+{
+	if ((int)ssSpriteAlpha.size() < numSprites)
+	{
+		ssSpriteAlphaPos.resize(numSprites);
+		ssSpriteAlpha.resize(numSprites);
+	}
+
+	float *alphapos = ssSpriteAlphaPos.data();
+	float *alpha = ssSpriteAlpha.data();
+	const float invfaderange = 1.0f / faderange;
+
+	for (int i = 0; i < numSprites; i++)
+	{
+		// total alpha, minus random factor so some things fade out sooner.
+		alphapos[i] = a1*sprites[i].fa + a2*sprites[i].fb + a3*sprites[i].fc;
+
+		// Note that the alpha at this point is a value from 1.0 to 0.0, but represents when to START fading
+		const float fadestart = faderange + (1.0f-faderange) * sprites[i].fadeRandom;
+
+		// Find where the alpha is relative to the fadestart, and calc the real alpha to draw at.
+		alpha[i] = Q_min(1.0f - (fadestart-alphapos[i])*invfaderange, 1.0f);
+	}
+}
+
+
 /////////////////////////////////////////////
 // Vertical surface sprites
 
@@ -339,7 +615,7 @@ static void RB_VerticalSurfaceSprite(vec3_t loc, float width, float height, byte
 	float points[16];
 	color4ub_t color;
 
-	angle = ((loc[0]+loc[1])*0.02+(tr.refdef.time*0.0015));
+	angle = ((loc[0]+loc[1])*0.02+(backEnd.refdef.time*0.0015));
 
 	if (windidle>0.0)
 	{
@@ -451,7 +727,7 @@ static void RB_VerticalSurfaceSpriteWindPoint(vec3_t loc, float width, float hei
 
 //	wind += 1.0-windforce;
 
-	angle = (loc[0]+loc[1])*0.02+(tr.refdef.time*0.0015);
+	angle = (loc[0]+loc[1])*0.02+(backEnd.refdef.time*0.0015);
 
 	if (curWindSpeed <80.0)
 	{
@@ -481,7 +757,7 @@ static void RB_VerticalSurfaceSpriteWindPoint(vec3_t loc, float width, float hei
 
 	loc2[0] += height*winddiff[0]*windforce;
 	loc2[1] += height*winddiff[1]*windforce;
-	loc2[2] -= height*windforce*(0.75 + 0.15*sin((tr.refdef.time + 500*windforce)*0.01));
+	loc2[2] -= height*windforce*(0.75 + 0.15*sin((backEnd.refdef.time + 500*windforce)*0.01));
 
 	if ( flattened )
 	{
@@ -536,8 +812,7 @@ static void RB_DrawVerticalSurfaceSprites( shaderStage_t *stage, shaderCommands_
 {
 	int curindex, curvert;
  	vec3_t dist;
-	float triarea;
-	vec2_t vec1to2, vec1to3;
+	float step;
 
 	vec3_t v1,v2,v3;
 	float a1,a2,a3;
@@ -546,21 +821,19 @@ static void RB_DrawVerticalSurfaceSprites( shaderStage_t *stage, shaderCommands_
 	vec2_t winddiff1, winddiff2, winddiff3;
 	float  windforce1, windforce2, windforce3;
 
-	float posi, posj;
-	float step;
-	float fa,fb,fc;
+	const ssSprite_t *sprites;
+	int numSprites;
 
 	vec3_t curpoint;
-	float width, height;
-	float alpha, alphapos, thisspritesfadestart, light;
-
-	byte randomindex2;
+	float width;
+	float alpha, alphapos, light;
 
-	vec2_t skew={0,0};
+	vec2_t skew;
 	vec2_t fogv;
 	vec2_t winddiffv;
 	float windforce=0;
 	qboolean usewindpoint = (qboolean) !! (curWindPointActive && stage->ss->wind > 0);
+	const bool flattened = SURFSPRITE_FLATTENED == stage->ss->surfaceSpriteType;
 
 	float cutdist=stage->ss->fadeMax*rangescalefactor, cutdist2=cutdist*cutdist;
 	float fadedist=stage->ss->fadeDist*rangescalefactor, fadedist2=fadedist*fadedist;
@@ -698,134 +971,70 @@ static void RB_DrawVerticalSurfaceSprites( shaderStage_t *stage, shaderCommands_
 			continue;
 		}
 
-		// Find the area in order to calculate the stepsize
-		vec1to2[0] = v2[0] - v1[0];
-		vec1to2[1] = v2[1] - v1[1];
-		vec1to3[0] = v3[0] - v1[0];
-		vec1to3[1] = v3[1] - v1[1];
-
-		// Now get the cross product of this sum.
-		triarea = vec1to3[0]*vec1to2[1] - vec1to3[1]*vec1to2[0];
-		triarea=fabs(triarea);
-		if (triarea <= 1.0)
-		{	// Insanely small abhorrent triangle.
+		sprites = RB_SurfaceSpritesForTriangle(stage->ss, v1, v2, v3, true, &numSprites);
+		if (!numSprites)
+		{
 			continue;
 		}
-		step = stage->ss->density * Q_rsqrt(triarea);
 
-		randomindex = (byte)(v1[0]+v1[1]+v2[0]+v2[1]+v3[0]+v3[1]);
-		randominterval = (byte)(v1[0]+v2[1]+v3[2])|0x03;	// Make sure the interval is at least 3, and always odd
-		rightvectorcount = 0;
+		RB_FadeSurfaceSprites(sprites, numSprites, a1, a2, a3, faderange);
 
-		for (posi=0; posi<1.0; posi+=step)
+		for (int i = 0; i < numSprites; i++)
 		{
-			for (posj=0; posj<(1.0-posi); posj+=step)
-			{
-				fa=posi+randomchart[randomindex]*step;
-				randomindex += randominterval;
-
-				fb=posj+randomchart[randomindex]*step;
-				randomindex += randominterval;
-
-				rightvectorcount=(rightvectorcount+1)&3;
-
-				if (fa>1.0)
-					continue;
-
-				if (fb>(1.0-fa))
-					continue;
+			const ssSprite_t *sprite = &sprites[i];
 
-				fc = 1.0-fa-fb;
-
-				// total alpha, minus random factor so some things fade out sooner.
-				alphapos = a1*fa + a2*fb + a3*fc;
-
-				// Note that the alpha at this point is a value from 1.0 to 0.0, but represents when to START fading
-				thisspritesfadestart = faderange + (1.0-faderange) * randomchart[randomindex];
-				randomindex += randominterval;
-
-				// Find where the alpha is relative to the fadestart, and calc the real alpha to draw at.
-				alpha = 1.0 - ((thisspritesfadestart-alphapos)/faderange);
-				if (alpha > 0.0)
-				{
-					if (alpha > 1.0)
-						alpha=1.0;
-
-					if (SSUsingFog)
-					{
-						fogv[0] = fog1[0]*fa + fog2[0]*fb + fog3[0]*fc;
-						fogv[1] = fog1[1]*fa + fog2[1]*fb + fog3[1]*fc;
-					}
-
-					if (usewindpoint)
-					{
-						winddiffv[0] = winddiff1[0]*fa + winddiff2[0]*fb + winddiff3[0]*fc;
-						winddiffv[1] = winddiff1[1]*fa + winddiff2[1]*fb + winddiff3[1]*fc;
-						windforce = windforce1*fa + windforce2*fb + windforce3*fc;
-					}
+			alpha = ssSpriteAlpha[i];
+			if (alpha <= 0.0)
+			{
+				continue;
+			}
+			alphapos = ssSpriteAlphaPos[i];
 
-					VectorScale(v1, fa, curpoint);
-					VectorMA(curpoint, fb, v2, curpoint);
-					VectorMA(curpoint, fc, v3, curpoint);
+			if (SSUsingFog)
+			{
+				fogv[0] = fog1[0]*sprite->fa + fog2[0]*sprite->fb + fog3[0]*sprite->fc;
+				fogv[1] = fog1[1]*sprite->fa + fog2[1]*sprite->fb + fog3[1]*sprite->fc;
+			}
 
-					light = l1*fa + l2*fb + l3*fc;
-					if (SSAdditiveTransparency)
-					{	// Additive transparency, scale light value
-//						light *= alpha;
-						light = (128 + (light*0.5))*alpha;
-						alpha = 1.0;
-					}
+			if (usewindpoint)
+			{
+				winddiffv[0] = winddiff1[0]*sprite->fa + winddiff2[0]*sprite->fb + winddiff3[0]*sprite->fc;
+				winddiffv[1] = winddiff1[1]*sprite->fa + winddiff2[1]*sprite->fb + winddiff3[1]*sprite->fc;
+				windforce = windforce1*sprite->fa + windforce2*sprite->fb + windforce3*sprite->fc;
+			}
 
-					randomindex2 = randomindex;
-					width = stage->ss->width*(1.0 + (stage->ss->variance[0]*randomchart[randomindex2]));
-					height = stage->ss->height*(1.0 + (stage->ss->variance[1]*randomchart[randomindex2++]));
-					if (randomchart[randomindex2++]>0.5)
-					{
-						width = -width;
-					}
-					if (stage->ss->fadeScale!=0 && alphapos < 1.0)
-					{
-						width *= 1.0 + (stage->ss->fadeScale*(1.0-alphapos));
-					}
+			light = l1*sprite->fa + l2*sprite->fb + l3*sprite->fc;
+			if (SSAdditiveTransparency)
+			{	// Additive transparency, scale light value
+//				light *= alpha;
+				light = (128 + (light*0.5))*alpha;
+				alpha = 1.0;
+			}
 
-					if (stage->ss->vertSkew != 0)
-					{	// flrand(-vertskew, vertskew)
-						skew[0] = height * ((stage->ss->vertSkew*2.0f*randomchart[randomindex2++])-stage->ss->vertSkew);
-						skew[1] = height * ((stage->ss->vertSkew*2.0f*randomchart[randomindex2++])-stage->ss->vertSkew);
-					}
+			width = sprite->width;
+			if (stage->ss->fadeScale!=0 && alphapos < 1.0)
+			{
+				width *= 1.0 + (stage->ss->fadeScale*(1.0-alphapos));
+			}
 
-					if (usewindpoint && windforce > 0 && stage->ss->wind > 0.0)
-					{
-						if (SSUsingFog)
-						{
-							RB_VerticalSurfaceSpriteWindPoint(curpoint, width, height, (byte)light, (byte)(alpha*255.0),
-										stage->ss->wind, stage->ss->windIdle, fogv, stage->ss->facing, skew,
-										winddiffv, windforce, SURFSPRITE_FLATTENED == stage->ss->surfaceSpriteType);
-						}
-						else
-						{
-							RB_VerticalSurfaceSpriteWindPoint(curpoint, width, height, (byte)light, (byte)(alpha*255.0),
-										stage->ss->wind, stage->ss->windIdle, NULL, stage->ss->facing, skew,
-										winddiffv, windforce, SURFSPRITE_FLATTENED == stage->ss->surfaceSpriteType);
-						}
-					}
-					else
-					{
-						if (SSUsingFog)
-						{
-							RB_VerticalSurfaceSprite(curpoint, width, height, (byte)light, (byte)(alpha*255.0),
-										stage->ss->wind, stage->ss->windIdle, fogv, stage->ss->facing, skew, SURFSPRITE_FLATTENED == stage->ss->surfaceSpriteType);
-						}
-						else
-						{
-							RB_VerticalSurfaceSprite(curpoint, width, height, (byte)light, (byte)(alpha*255.0),
-										stage->ss->wind, stage->ss->windIdle, NULL, stage->ss->facing, skew, SURFSPRITE_FLATTENED == stage->ss->surfaceSpriteType);
-						}
-					}
+			rightvectorcount = sprite->rightVector;
+			VectorCopy(sprite->origin, curpoint);
+			skew[0] = sprite->skew[0];
+			skew[1] = sprite->skew[1];
 
-					totalsurfsprites++;
-				}
+			if (usewindpoint && windforce > 0 && stage->ss->wind > 0.0)
+			{
+				RB_VerticalSurfaceSpriteWindPoint(curpoint, width, sprite->height, (byte)light, (byte)(alpha*255.0),
+							stage->ss->wind, stage->ss->windIdle, SSUsingFog ? fogv : NULL, stage->ss->facing, skew,
+							winddiffv, windforce, flattened);
 			}
+			else
+			{
+				RB_VerticalSurfaceSprite(curpoint, width, sprite->height, (byte)light, (byte)(alpha*255.0),
+							stage->ss->wind, stage->ss->windIdle, SSUsingFog ? fogv : NULL, stage->ss->facing, skew, flattened);
+			}
+
+			totalsurfsprites++;
 		}
 	}
 }
@@ -920,22 +1129,19 @@ static void RB_DrawOrientedSurfaceSprites( shaderStage_t *stage, shaderCommands_
 {
 	int curindex, curvert;
  	vec3_t dist;
-	float triarea, minnormal;
-	vec2_t vec1to2, vec1to3;
+	float minnormal;
 
 	vec3_t v1,v2,v3;
 	float a1,a2,a3;
 	float l1,l2,l3;
 	vec2_t fog1, fog2, fog3;
 
-	float posi, posj;
-	float step;
-	float fa,fb,fc;
+	const ssSprite_t *sprites;
+	int numSprites;
 
 	vec3_t curpoint;
-	float width, height;
-	float alpha, alphapos, thisspritesfadestart, light;
-	byte randomindex2;
+	float width;
+	float alpha, alphapos, light;
 	vec2_t fogv;
 
 	float cutdist=stage->ss->fadeMax*rangescalefactor, cutdist2=cutdist*cutdist;
@@ -1009,98 +1215,50 @@ static void RB_DrawOrientedSurfaceSprites( shaderStage_t *stage, shaderCommands_
 			continue;
 		}
 
-		// Find the area in order to calculate the stepsize
-		vec1to2[0] = v2[0] - v1[0];
-		vec1to2[1] = v2[1] - v1[1];
-		vec1to3[0] = v3[0] - v1[0];
-		vec1to3[1] = v3[1] - v1[1];
-
-		// Now get the cross product of this sum.
-		triarea = vec1to3[0]*vec1to2[1] - vec1to3[1]*vec1to2[0];
-		triarea=fabs(triarea);
-		if (triarea <= 1.0)
-		{	// Insanely small abhorrent triangle.
+		sprites = RB_SurfaceSpritesForTriangle(stage->ss, v1, v2, v3, false, &numSprites);
+		if (!numSprites)
+		{
 			continue;
 		}
-		step = stage->ss->density * Q_rsqrt(triarea);
 
-		randomindex = (byte)(v1[0]+v1[1]+v2[0]+v2[1]+v3[0]+v3[1]);
-		randominterval = (byte)(v1[0]+v2[1]+v3[2])|0x03;	// Make sure the interval is at least 3, and always odd
+		RB_FadeSurfaceSprites(sprites, numSprites, a1, a2, a3, faderange);
 
-		for (posi=0; posi<1.0; posi+=step)
+		for (int i = 0; i < numSprites; i++)
 		{
-			for (posj=0; posj<(1.0-posi); posj+=step)
-			{
-				fa=posi+randomchart[randomindex]*step;
-				randomindex += randominterval;
-				if (fa>1.0)
-					continue;
-
-				fb=posj+randomchart[randomindex]*step;
-				randomindex += randominterval;
-				if (fb>(1.0-fa))
-					continue;
+			const ssSprite_t *sprite = &sprites[i];
 
-				fc = 1.0-fa-fb;
-
-				// total alpha, minus random factor so some things fade out sooner.
-				alphapos = a1*fa + a2*fb + a3*fc;
-
-				// Note that the alpha at this point is a value from 1.0 to 0.0, but represents when to START fading
-				thisspritesfadestart = faderange + (1.0-faderange) * randomchart[randomindex];
-				randomindex += randominterval;
-
-				// Find where the alpha is relative to the fadestart, and calc the real alpha to draw at.
-				alpha = 1.0 - ((thisspritesfadestart-alphapos)/faderange);
-
-				randomindex += randominterval;
-				if (alpha > 0.0)
-				{
-					if (alpha > 1.0)
-						alpha=1.0;
-
-					if (SSUsingFog)
-					{
-						fogv[0] = fog1[0]*fa + fog2[0]*fb + fog3[0]*fc;
-						fogv[1] = fog1[1]*fa + fog2[1]*fb + fog3[1]*fc;
-					}
+			alpha = ssSpriteAlpha[i];
+			if (alpha <= 0.0)
+			{
+				continue;
+			}
+			alphapos = ssSpriteAlphaPos[i];
 
-					VectorScale(v1, fa, curpoint);
-					VectorMA(curpoint, fb, v2, curpoint);
-					VectorMA(curpoint, fc, v3, curpoint);
+			if (SSUsingFog)
+			{
+				fogv[0] = fog1[0]*sprite->fa + fog2[0]*sprite->fb + fog3[0]*sprite->fc;
+				fogv[1] = fog1[1]*sprite->fa + fog2[1]*sprite->fb + fog3[1]*sprite->fc;
+			}
 
-					light = l1*fa + l2*fb + l3*fc;
-					if (SSAdditiveTransparency)
-					{	// Additive transparency, scale light value
-//						light *= alpha;
-						light = (128 + (light*0.5))*alpha;
-						alpha = 1.0;
-					}
+			light = l1*sprite->fa + l2*sprite->fb + l3*sprite->fc;
+			if (SSAdditiveTransparency)
+			{	// Additive transparency, scale light value
+//				light *= alpha;
+				light = (128 + (light*0.5))*alpha;
+				alpha = 1.0;
+			}
 
-					randomindex2 = randomindex;
-					width = stage->ss->width*(1.0 + (stage->ss->variance[0]*randomchart[randomindex2]));
-					height = stage->ss->height*(1.0 + (stage->ss->variance[1]*randomchart[randomindex2++]));
-					if (randomchart[randomindex2++]>0.5)
-					{
-						width = -width;
-					}
-					if (stage->ss->fadeScale!=0 && alphapos < 1.0)
-					{
-						width *= 1.0 + (stage->ss->fadeScale*(1.0-alphapos));
-					}
+			width = sprite->width;
+			if (stage->ss->fadeScale!=0 && alphapos < 1.0)
+			{
+				width *= 1.0 + (stage->ss->fadeScale*(1.0-alphapos));
+			}
 
-					if (SSUsingFog)
-					{
-						RB_OrientedSurfaceSprite(curpoint, width, height, (byte)light, (byte)(alpha*255.0), fogv, stage->ss->facing);
-					}
-					else
-					{
-						RB_OrientedSurfaceSprite(curpoint, width, height, (byte)light, (byte)(alpha*255.0), NULL, stage->ss->facing);
-					}
+			VectorCopy(sprite->origin, curpoint);
+			RB_OrientedSurfaceSprite(curpoint, width, sprite->height, (byte)light, (byte)(alpha*255.0),
+						SSUsingFog ? fogv : NULL, stage->ss->facing);
 
-					totalsurfsprites++;
-				}
-			}
+			totalsurfsprites++;
 		}
 	}
 }
@@ -1331,7 +1489,7 @@ static void RB_DrawEffectSurfaceSprites( shaderStage_t *stage, shaderCommands_t
 		{
 			for (posj=0; posj<(1.0-posi); posj+=step)
 			{
-				effecttime = (tr.refdef.time+10000.0*randomchart[randomindex])/stage->ss->fxDuration;
+				effecttime = (backEnd.refdef.time+10000.0*randomchart[randomindex])/stage->ss->fxDuration;
 				effectpos = (float)effecttime - (int)effecttime;
 
 				randomindex2 = randomindex+effecttime;
@@ -1480,6 +1638,20 @@ void RB_DrawSurfaceSprites( shaderStage_t *stage, shaderCommands_t *input)
 		ssLastEntityDrawn = backEnd.currentEntity;
 	}
 
+	// Sprites on static geometry only need to be placed once.
+	if (tess.shader->numDeforms)
+	{
+		SSCacheable = qfalse;
+	}
+	else if (backEnd.currentEntity == &tr.worldEntity)
+	{
+		SSCacheable = qtrue;
+	}
+	else
+	{
+		SSCacheable = (qboolean)(R_GetModelByHandle(backEnd.currentEntity->e.hModel)->type == MOD_BRUSH);
+	}
+
 	switch(stage->ss->surfaceSpriteType)
 	{
 	case SURFSPRITE_FLATTENED:
@@ -1059,11 +1059,14 @@ into a more C friendly form.
 =================
 */
 void SV_UserinfoChanged( client_t *cl ) {
-	char	*val=NULL, *ip=NULL;
+	const char	*val=NULL, *ip=NULL;
 	int		i=0, len=0;
+	static infoDict_t info;
+
+	InfoDict_Parse( &info, cl->userinfo );
 
 	// name for C code
-	Q_strncpyz( cl->name, Info_ValueForKey (cl->userinfo, "name"), sizeof(cl->name) );
+	Q_strncpyz( cl->name, InfoDict_ValueForKey (&info, "name"), sizeof(cl->name) );
 
 	// rate command
 
@@ -1072,7 +1075,7 @@ void SV_UserinfoChanged( client_t *cl ) {
 	if ( Sys_IsLANAddress( &cl->netchan.remoteAddress ) && com_dedicated->integer != 2 && sv_lanForceRate->integer == 1 ) {
 		cl->rate = 100000;	// lans should not rate limit
 	} else {
-		val = Info_ValueForKey (cl->userinfo, "rate");
+		val = InfoDict_ValueForKey (&info, "rate");
 		if (sv_ratePolicy->integer == 1)
 		{
 			// NOTE: what if server sets some dumb sv_clientRate value?
@@ -1096,7 +1099,7 @@ void SV_UserinfoChanged( client_t *cl ) {
 	//Note: cl->snapshotMsec is also validated in sv_main.cpp -> SV_CheckCvars if sv_fps, sv_snapsMin or sv_snapsMax is changed
 	int minSnaps = Com_Clampi(1, sv_snapsMax->integer, sv_snapsMin->integer); // between 1 and sv_snapsMax ( 1 <-> 40 )
 	int maxSnaps = Q_min(sv_fps->integer, sv_snapsMax->integer); // can't produce more than sv_fps snapshots/sec, but can send less than sv_fps snapshots/sec
-	val = Info_ValueForKey(cl->userinfo, "snaps");
+	val = InfoDict_ValueForKey(&info, "snaps");
 	cl->wishSnaps = atoi(val);
 	if (!cl->wishSnaps)
 		cl->wishSnaps = maxSnaps;
@@ -1126,9 +1129,9 @@ void SV_UserinfoChanged( client_t *cl ) {
 	if( NET_IsLocalAddress(&cl->netchan.remoteAddress) )
 		ip = "localhost";
 	else
-		ip = (char*)NET_AdrToString( &cl->netchan.remoteAddress );
+		ip = NET_AdrToString( &cl->netchan.remoteAddress );
 
-	val = Info_ValueForKey( cl->userinfo, "ip" );
+	val = InfoDict_ValueForKey( &info, "ip" );
 	if( val[0] )
 		len = strlen( ip ) - strlen( val ) + strlen( cl->userinfo );
 	else
@@ -1136,8 +1139,10 @@ void SV_UserinfoChanged( client_t *cl ) {
 
 	if( len >= MAX_INFO_STRING )
 		SV_DropClient( cl, "userinfo string length exceeded" );
-	else
-		Info_SetValueForKey( cl->userinfo, "ip", ip );
+	else if ( strcmp( val, ip ) ) {
+		InfoDict_SetValueForKey( &info, "ip", ip );
+		Q_strncpyz( cl->userinfo, InfoDict_String( &info ), sizeof( cl->userinfo ) );
+	}
 }
 
 #define INFO_CHANGE_MIN_INTERVAL	6000 //6 seconds is reasonable I suppose
@@ -869,9 +869,11 @@ static void SV_InitRef( void ) {
 	ri.FS_FOpenFileByMode = FS_FOpenFileByMode;
 	ri.FS_FileExists = FS_FileExists;
 	ri.FS_FileIsInPAK = FS_FileIsInPAK;
+	ri.FS_FileStamp = FS_FileStamp;
 	ri.FS_ListFiles = FS_ListFiles;
 	ri.FS_Write = FS_Write;
 	ri.FS_WriteFile = FS_WriteFile;
+	ri.FS_HomeRemove = FS_HomeRemove;
 	ri.CM_BoxTrace = CM_BoxTrace;
 	ri.CM_DrawDebugSurface = CM_DrawDebugSurface;
 //	ri.CM_CullWorldBox = CM_CullWorldBox;
@@ -7411,6 +7411,7 @@ UI_BuildServerDisplayList
 static void UI_BuildServerDisplayList(int force) {
 	int i, count, clients, maxClients, ping, game, len, passw/*, visible*/;
 	char info[MAX_STRING_CHARS];
+	static infoDict_t infoDict;
 //	qboolean startRefresh = qtrue; TTimo: unused
 	int	lanSource;
 
@@ -7482,7 +7483,9 @@ static void UI_BuildServerDisplayList(int force) {
 				continue;
 			}
 
-			clients = atoi(Info_ValueForKey(info, "clients"));
+			InfoDict_Parse( &infoDict, info );
+
+			clients = atoi(InfoDict_ValueForKey(&infoDict, "clients"));
 			uiInfo.serverStatus.numPlayersOnServers += clients;
 
 			if (ui_browserShowEmpty.integer == 0) {
@@ -7493,7 +7496,7 @@ static void UI_BuildServerDisplayList(int force) {
 			}
 
 			if (ui_browserShowFull.integer == 0) {
-				maxClients = atoi(Info_ValueForKey(info, "sv_maxclients"));
+				maxClients = atoi(InfoDict_ValueForKey(&infoDict, "sv_maxclients"));
 				if (clients == maxClients) {
 					trap->LAN_MarkServerVisible(lanSource, i, qfalse);
 					continue;
@@ -7501,7 +7504,7 @@ static void UI_BuildServerDisplayList(int force) {
 			}
 
 			if ( ui_browserShowPasswordProtected.integer == 0 ) {
-				passw = atoi(Info_ValueForKey(info, "needpass"));
+				passw = atoi(InfoDict_ValueForKey(&infoDict, "needpass"));
 				if (passw && !ui_browserShowPasswordProtected.integer) {
 					trap->LAN_MarkServerVisible(lanSource, i, qfalse);
 					continue;
@@ -7509,7 +7512,7 @@ static void UI_BuildServerDisplayList(int force) {
 			}
 
 			if (uiInfo.joinGameTypes[ui_joinGametype.integer].gtEnum != -1) {
-				game = atoi(Info_ValueForKey(info, "gametype"));
+				game = atoi(InfoDict_ValueForKey(&infoDict, "gametype"));
 				if (game != uiInfo.joinGameTypes[ui_joinGametype.integer].gtEnum) {
 					trap->LAN_MarkServerVisible(lanSource, i, qfalse);
 					continue;
@@ -7517,7 +7520,7 @@ static void UI_BuildServerDisplayList(int force) {
 			}
 
 			if (ui_serverFilterType.integer > 0 && ui_serverFilterType.integer <= uiInfo.modCount) {
-				if (Q_stricmp(Info_ValueForKey(info, "game"), UI_FilterDir( ui_serverFilterType.integer ) ) != 0) {
+				if (Q_stricmp(InfoDict_ValueForKey(&infoDict, "game"), UI_FilterDir( ui_serverFilterType.integer ) ) != 0) {
 					trap->LAN_MarkServerVisible(lanSource, i, qfalse);
 					continue;
 				}
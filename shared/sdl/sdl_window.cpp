@@ -894,3 +894,11 @@ qboolean WIN_GL_ExtensionSupported( const char *extension )
 {
 	return SDL_GL_ExtensionSupported( extension ) == SDL_TRUE ? qtrue : qfalse;
 }
+
+void WIN_GL_MakeCurrent( qboolean current )
+{
+	if ( SDL_GL_MakeCurrent( screen, current ? opengl_context : NULL ) < 0 )
+	{
+		Com_DPrintf( "SDL_GL_MakeCurrent failed: %s\n", SDL_GetError() );
+	}
+}
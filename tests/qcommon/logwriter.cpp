@@ -0,0 +1,159 @@
+#include "qcommon/logwriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+	std::string ReadAll( FILE *file )
+	{
+		std::string contents;
+		std::vector< char > block( 4096 );
+
+		fflush( file );
+		rewind( file );
+		size_t size;
+		while( ( size = fread( block.data(), 1, block.size(), file ) ) > 0 )
+		{
+			contents.append( block.data(), size );
+		}
+		return contents;
+	}
+
+	struct TempLog
+	{
+		FILE *file;
+
+		TempLog() : file( tmpfile() )
+		{
+			BOOST_REQUIRE( file != nullptr );
+		}
+		~TempLog()
+		{
+			LogWriter_Stop();
+			fclose( file );
+		}
+	};
+}
+
+BOOST_AUTO_TEST_SUITE( qcommon )
+
+BOOST_AUTO_TEST_SUITE( logwriter )
+
+BOOST_FIXTURE_TEST_CASE( writes_everything_in_order, TempLog )
+{
+	LogWriter_Start( file, false );
+
+	// several times the ring, so appending has to wait for the thread
+	std::string expected;
+	for( int line = 0; expected.size() < LOGWRITER_RING_SIZE * 4; line++ )
+	{
+		const std::string text = "line " + std::to_string( line ) + "\n";
+		LogWriter_Append( text.data(), text.size() );
+		expected += text;
+	}
+	BOOST_CHECK_EQUAL( LogWriter_Size(), expected.size() );
+
+	LogWriter_Stop();
+	BOOST_CHECK( !LogWriter_Active() );
+	BOOST_CHECK( ReadAll( file ) == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( appends_larger_than_the_ring, TempLog )
+{
+	LogWriter_Start( file, false );
+
+	const std::string big( LOGWRITER_RING_SIZE * 2 + 17, 'x' );
+	LogWriter_Append( "a", 1 );
+	LogWriter_Append( big.data(), big.size() );
+	LogWriter_Append( "b", 1 );
+
+	LogWriter_Stop();
+	BOOST_CHECK( ReadAll( file ) == "a" + big + "b" );
+}
+
+BOOST_FIXTURE_TEST_CASE( flush_writes_what_was_appended, TempLog )
+{
+	LogWriter_Start( file, false );
+
+	LogWriter_Append( "first\n", 6 );
+	LogWriter_Flush();
+	BOOST_CHECK_EQUAL( ftell( file ), 6 );
+
+	LogWriter_Append( "second\n", 7 );
+	LogWriter_Flush();
+	BOOST_CHECK_EQUAL( ftell( file ), 13 );
+	BOOST_CHECK( LogWriter_Active() );
+
+	// and sizes start over with the next file
+	LogWriter_Stop();
+	LogWriter_Start( file, false );
+	BOOST_CHECK_EQUAL( LogWriter_Size(), 0u );
+	LogWriter_Append( "third\n", 6 );
+	BOOST_CHECK_EQUAL( LogWriter_Size(), 6u );
+	LogWriter_Stop();
+
+	BOOST_CHECK( ReadAll( file ) == "first\nsecond\nthird\n" );
+}
+
+BOOST_FIXTURE_TEST_CASE( appends_from_several_threads, TempLog )
+{
+	LogWriter_Start( file, false );
+
+	// enough for the ring to fill up while the others append
+	const int numThreads = 4;
+	const int numLines = 20000;
+	std::vector< std::thread > threads;
+	for( int t = 0; t < numThreads; t++ )
+	{
+		threads.emplace_back( [t, numLines] {
+			for( int line = 0; line < numLines; line++ )
+			{
+				const std::string text = "thread " + std::to_string( t ) + " line " + std::to_string( line ) + "\n";
+				LogWriter_Append( text.data(), text.size() );
+			}
+		} );
+	}
+	for( auto& thread : threads )
+	{
+		thread.join();
+	}
+	LogWriter_Stop();
+
+	// every line arrives whole, and each thread's lines stay in order
+	std::istringstream contents( ReadAll( file ) );
+	std::vector< int > nextLine( numThreads, 0 );
+	std::string text;
+	while( std::getline( contents, text ) )
+	{
+		int t, line;
+		BOOST_REQUIRE( sscanf( text.c_str(), "thread %d line %d", &t, &line ) == 2 );
+		BOOST_REQUIRE( t >= 0 && t < numThreads );
+		BOOST_REQUIRE_EQUAL( line, nextLine[t] );
+		nextLine[t]++;
+	}
+	BOOST_CHECK( std::all_of( nextLine.begin(), nextLine.end(), [numLines]( int n ) { return n == numLines; } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( flush_each_write_writes_before_returning, TempLog )
+{
+	LogWriter_Start( file, true );
+
+	LogWriter_Append( "first\n", 6 );
+	BOOST_CHECK_EQUAL( ftell( file ), 6 );
+	LogWriter_Append( "second\n", 7 );
+	BOOST_CHECK_EQUAL( ftell( file ), 13 );
+
+	LogWriter_Stop();
+	BOOST_CHECK( ReadAll( file ) == "first\nsecond\n" );
+}
+
+BOOST_AUTO_TEST_SUITE_END() // logwriter
+
+BOOST_AUTO_TEST_SUITE_END() // qcommon
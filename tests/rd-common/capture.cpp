@@ -0,0 +1,184 @@
+#include "rd-common/tr_capture.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+	// null encoders: "encoding" copies the frame number out of the pixels.
+	// The encoder can be held at a gate, to see what the caller can do while
+	// the worker is busy.
+	struct NullCapture
+	{
+		std::mutex mutex;
+		std::condition_variable gateChanged;
+		bool gateClosed = false;
+
+		std::vector< int > encoded;
+		std::vector< std::thread::id > encodedBy;
+		std::vector< int > written;
+		std::vector< std::thread::id > writtenBy;
+
+		NullCapture();
+		~NullCapture();
+
+		void SetGate( bool closed )
+		{
+			std::lock_guard< std::mutex > lock( mutex );
+			gateClosed = closed;
+			gateChanged.notify_all();
+		}
+
+		size_t NumEncoded()
+		{
+			std::lock_guard< std::mutex > lock( mutex );
+			return encoded.size();
+		}
+	};
+
+	NullCapture *capture;
+
+	NullCapture::NullCapture()
+	{
+		capture = this;
+	}
+
+	NullCapture::~NullCapture()
+	{
+		SetGate( false );
+		R_ShutdownCaptureThread();
+		capture = nullptr;
+	}
+
+	int FrameNumber( const captureJob_t *job )
+	{
+		int frame;
+		std::memcpy( &frame, job->pixels, sizeof( frame ) );
+		return frame;
+	}
+
+	void NullEncode( captureJob_t *job )
+	{
+		std::unique_lock< std::mutex > lock( capture->mutex );
+		capture->gateChanged.wait( lock, [] { return !capture->gateClosed; } );
+		capture->encoded.push_back( FrameNumber( job ) );
+		capture->encodedBy.push_back( std::this_thread::get_id() );
+	}
+
+	void NullEncodeForWrite( captureJob_t *job )
+	{
+		NullEncode( job );
+
+		// grow the output in two steps, as an encoder that doesn't know its
+		// size up front would
+		const int frame = FrameNumber( job );
+		unsigned char *out = R_CaptureEncodeBuffer( job, sizeof( frame ) );
+		std::memcpy( out, &frame, sizeof( frame ) );
+		R_CaptureEncodeBuffer( job, 1024 );
+		job->encodedSize = sizeof( frame );
+	}
+
+	void NullWrite( captureJob_t *job )
+	{
+		int frame;
+		BOOST_REQUIRE_EQUAL( job->encodedSize, sizeof( frame ) );
+		std::memcpy( &frame, job->encoded, sizeof( frame ) );
+		capture->written.push_back( frame );
+		capture->writtenBy.push_back( std::this_thread::get_id() );
+	}
+
+	void QueueFrame( int frame, captureFunc_t encode, captureFunc_t write )
+	{
+		captureJob_t *job = R_GetCaptureJob( 64 * 1024 );
+		BOOST_REQUIRE( job != nullptr );
+		std::memcpy( job->pixels, &frame, sizeof( frame ) );
+		job->encode = encode;
+		job->write = write;
+		R_QueueCaptureJob( job );
+	}
+}
+
+BOOST_AUTO_TEST_SUITE( rd_common )
+
+BOOST_AUTO_TEST_SUITE( capture )
+
+BOOST_FIXTURE_TEST_CASE( queues_a_full_set_of_jobs_without_waiting, NullCapture )
+{
+	SetGate( true );
+	for( int frame = 0; frame < CAPTURE_MAX_JOBS; frame++ )
+	{
+		QueueFrame( frame, NullEncode, nullptr );
+	}
+	BOOST_CHECK_EQUAL( NumEncoded(), 0u );
+
+	// more frames than there are jobs, so queueing has to wait for the worker
+	const int numFrames = CAPTURE_MAX_JOBS * 10;
+	SetGate( false );
+	for( int frame = CAPTURE_MAX_JOBS; frame < numFrames; frame++ )
+	{
+		QueueFrame( frame, NullEncode, nullptr );
+	}
+	R_FinishCaptureJobs();
+
+	BOOST_REQUIRE_EQUAL( encoded.size(), (size_t)numFrames );
+	for( int frame = 0; frame < numFrames; frame++ )
+	{
+		BOOST_CHECK_EQUAL( encoded[frame], frame );
+		BOOST_CHECK( encodedBy[frame] != std::this_thread::get_id() );
+	}
+	BOOST_CHECK( written.empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( writes_only_when_polled, NullCapture )
+{
+	const int numFrames = CAPTURE_MAX_JOBS * 3;
+	for( int frame = 0; frame < numFrames; frame++ )
+	{
+		QueueFrame( frame, NullEncodeForWrite, NullWrite );
+	}
+
+	BOOST_CHECK( written.empty() );
+
+	// the writes outlive their jobs being reused
+	while( written.size() < (size_t)numFrames )
+	{
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		R_PollCaptureJobs();
+	}
+	BOOST_REQUIRE_EQUAL( written.size(), (size_t)numFrames );
+	for( int frame = 0; frame < numFrames; frame++ )
+	{
+		BOOST_CHECK_EQUAL( written[frame], frame );
+		BOOST_CHECK( writtenBy[frame] == std::this_thread::get_id() );
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE( finish_writes_everything, NullCapture )
+{
+	QueueFrame( 0, NullEncodeForWrite, NullWrite );
+	QueueFrame( 1, NullEncode, nullptr );
+	QueueFrame( 2, NullEncodeForWrite, NullWrite );
+	R_FinishCaptureJobs();
+
+	BOOST_CHECK_EQUAL( encoded.size(), 3u );
+	BOOST_REQUIRE_EQUAL( written.size(), 2u );
+	BOOST_CHECK_EQUAL( written[0], 0 );
+	BOOST_CHECK_EQUAL( written[1], 2 );
+
+	// and the worker starts again after a shutdown
+	R_ShutdownCaptureThread();
+	QueueFrame( 3, NullEncodeForWrite, NullWrite );
+	R_FinishCaptureJobs();
+	BOOST_REQUIRE_EQUAL( written.size(), 3u );
+	BOOST_CHECK_EQUAL( written[2], 3 );
+}
+
+BOOST_AUTO_TEST_SUITE_END() // capture
+
+BOOST_AUTO_TEST_SUITE_END() // rd_common
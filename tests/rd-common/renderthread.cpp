@@ -0,0 +1,142 @@
+#include "rd-common/tr_renderthread.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+	// null back end: "GL" is a token only one thread may hold at a time
+	std::atomic< int > contextOwners( 0 );
+	std::atomic< bool > contextMisused( false );
+	thread_local bool hasContext = false;
+
+	std::thread::id frontEndThread;
+	std::vector< int > executed;
+	bool executedOnFrontEnd = false;
+
+	void NullMakeCurrent( bool current )
+	{
+		if( current == hasContext )
+		{
+			contextMisused = true;
+		}
+		hasContext = current;
+		if( current && contextOwners++ != 0 )
+		{
+			contextMisused = true;
+		}
+		if( !current )
+		{
+			contextOwners--;
+		}
+	}
+
+	void NullExecute( const void *data )
+	{
+		if( !hasContext )
+		{
+			contextMisused = true;
+		}
+		if( std::this_thread::get_id() == frontEndThread )
+		{
+			executedOnFrontEnd = true;
+		}
+
+		// give the front end a chance to run ahead
+		std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+		executed.push_back( *static_cast< const int * >( data ) );
+	}
+
+	struct NullBackEnd
+	{
+		NullBackEnd()
+		{
+			frontEndThread = std::this_thread::get_id();
+			executed.clear();
+			executedOnFrontEnd = false;
+			contextMisused = false;
+			contextOwners = 0;
+			NullMakeCurrent( true );
+			BOOST_REQUIRE( R_SpawnRenderThread( NullExecute, NullMakeCurrent ) );
+		}
+		~NullBackEnd()
+		{
+			R_ShutdownRenderThread();
+			NullMakeCurrent( false );
+		}
+	};
+}
+
+BOOST_AUTO_TEST_SUITE( rd_common )
+
+BOOST_AUTO_TEST_SUITE( renderthread )
+
+BOOST_FIXTURE_TEST_CASE( executes_double_buffered_lists_in_order, NullBackEnd )
+{
+	BOOST_CHECK( R_RenderThreadActive() );
+
+	// the front end fills one buffer while the other one is being executed
+	int buffers[2];
+	const int numFrames = 100;
+	for( int frame = 0; frame < numFrames; frame++ )
+	{
+		buffers[frame & 1] = frame;
+		R_WakeRenderThread( &buffers[frame & 1] );
+	}
+	R_WaitRenderThread();
+
+	BOOST_REQUIRE_EQUAL( executed.size(), (size_t)numFrames );
+	for( int frame = 0; frame < numFrames; frame++ )
+	{
+		BOOST_CHECK_EQUAL( executed[frame], frame );
+	}
+	BOOST_CHECK( !executedOnFrontEnd );
+	BOOST_CHECK( !contextMisused );
+}
+
+BOOST_FIXTURE_TEST_CASE( sync_gives_the_context_back, NullBackEnd )
+{
+	int frame = 0;
+	R_WakeRenderThread( &frame );
+	BOOST_CHECK( !hasContext );
+
+	R_SyncRenderThread();
+	BOOST_CHECK( hasContext );
+	BOOST_CHECK_EQUAL( executed.size(), 1u );
+
+	// syncing again while idle doesn't bounce the context around
+	R_SyncRenderThread();
+	BOOST_CHECK( hasContext );
+
+	frame = 1;
+	R_WakeRenderThread( &frame );
+	R_WaitRenderThread();
+	BOOST_CHECK( !hasContext );
+	BOOST_CHECK_EQUAL( executed.size(), 2u );
+
+	BOOST_CHECK( !contextMisused );
+}
+
+BOOST_AUTO_TEST_CASE( shutdown_returns_the_context )
+{
+	{
+		NullBackEnd backEnd;
+		int frame = 0;
+		R_WakeRenderThread( &frame );
+		R_ShutdownRenderThread();
+
+		BOOST_CHECK( !R_RenderThreadActive() );
+		BOOST_CHECK( hasContext );
+		BOOST_CHECK_EQUAL( executed.size(), 1u );
+	}
+	BOOST_CHECK( !contextMisused );
+	BOOST_CHECK_EQUAL( contextOwners, 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END() // renderthread
+
+BOOST_AUTO_TEST_SUITE_END() // rd_common
@@ -0,0 +1,177 @@
+#include "rd-common/tr_vertexlerp.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#ifdef R_VERTEXLERP_SIMD
+
+namespace
+{
+	// odd sizes, so the scalar tail of the SIMD versions gets exercised too
+	const int vertexCounts[] = { 1, 3, 4, 7, 64, 257 };
+	const float backlerps[] = { 0.0f, 0.25f, 0.5f, 0.9f };
+
+	const float floatTolerance = 1e-5f;
+
+	// layout of rend2's mdvVertex_t: xyz, normal, tangent, bitangent
+	const int floatVertStride = 12;
+
+	std::vector< float > MakeFloatVertexes( std::mt19937& rng, int numVerts )
+	{
+		std::uniform_real_distribution< float > position( -512.0f, 512.0f );
+		std::uniform_real_distribution< float > direction( -1.0f, 1.0f );
+
+		std::vector< float > verts( numVerts * floatVertStride );
+		for( int i = 0; i < numVerts; i++ )
+		{
+			float *v = &verts[i * floatVertStride];
+			for( int j = 0; j < 3; j++ )
+			{
+				v[j] = position( rng );
+			}
+
+			float length;
+			do
+			{
+				for( int j = 3; j < 6; j++ )
+				{
+					v[j] = direction( rng );
+				}
+				length = std::sqrt( v[3] * v[3] + v[4] * v[4] + v[5] * v[5] );
+			} while( length < 0.1f );
+
+			for( int j = 3; j < 6; j++ )
+			{
+				v[j] /= length;
+			}
+			for( int j = 6; j < floatVertStride; j++ )
+			{
+				v[j] = direction( rng );
+			}
+		}
+		return verts;
+	}
+
+	std::vector< short > MakeMD3Vertexes( std::mt19937& rng, int numVerts )
+	{
+		std::uniform_int_distribution< int > position( -32768, 32767 );
+		std::uniform_int_distribution< int > normal( 0, 65535 );
+
+		std::vector< short > verts( numVerts * 4 );
+		for( int i = 0; i < numVerts; i++ )
+		{
+			for( int j = 0; j < 3; j++ )
+			{
+				verts[i * 4 + j] = (short)position( rng );
+			}
+			verts[i * 4 + 3] = (short)(unsigned short)normal( rng );
+		}
+		return verts;
+	}
+
+	std::vector< float > MakeSinTable()
+	{
+		std::vector< float > sinTable( VERTEXLERP_SINTABLE_SIZE );
+		for( int i = 0; i < VERTEXLERP_SINTABLE_SIZE; i++ )
+		{
+			sinTable[i] = (float)std::sin( i * 2.0 * 3.14159265358979323846 / VERTEXLERP_SINTABLE_SIZE );
+		}
+		return sinTable;
+	}
+
+	void CheckFloatsClose( const std::vector< float >& expected, const std::vector< float >& actual )
+	{
+		BOOST_REQUIRE_EQUAL( expected.size(), actual.size() );
+		for( size_t i = 0; i < expected.size(); i++ )
+		{
+			const float tolerance = floatTolerance * std::fmax( 1.0f, std::fabs( expected[i] ) );
+			if( std::fabs( expected[i] - actual[i] ) > tolerance )
+			{
+				BOOST_ERROR( "mismatch at " << i << ": " << expected[i] << " != " << actual[i] );
+				return;
+			}
+		}
+	}
+
+	// packed normals may differ by one step per component due to rounding
+	void CheckPackedNormalsClose( const std::vector< uint32_t >& expected, const std::vector< uint32_t >& actual )
+	{
+		BOOST_REQUIRE_EQUAL( expected.size(), actual.size() );
+		for( size_t i = 0; i < expected.size(); i++ )
+		{
+			for( int shift = 0; shift < 30; shift += 10 )
+			{
+				const int a = (int)( ( expected[i] >> shift ) & 0x3ff );
+				const int b = (int)( ( actual[i] >> shift ) & 0x3ff );
+				if( std::abs( a - b ) > 1 )
+				{
+					BOOST_ERROR( "normal mismatch at " << i << ": " << expected[i] << " != " << actual[i] );
+					return;
+				}
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE( rd_common )
+
+BOOST_AUTO_TEST_SUITE( vertexlerp )
+
+BOOST_AUTO_TEST_CASE( float_vertexes_match_scalar )
+{
+	std::mt19937 rng( 1234 );
+	for( int numVerts : vertexCounts )
+	{
+		const std::vector< float > newVerts = MakeFloatVertexes( rng, numVerts );
+		const std::vector< float > oldVerts = MakeFloatVertexes( rng, numVerts );
+
+		for( float backlerp : backlerps )
+		{
+			std::vector< float > scalarXyz( numVerts * 4 ), simdXyz( numVerts * 4 );
+			std::vector< uint32_t > scalarNormals( numVerts ), simdNormals( numVerts );
+
+			R_LerpFloatVertexes_scalar( newVerts.data(), oldVerts.data(), floatVertStride,
+				backlerp, numVerts, scalarXyz.data(), scalarNormals.data() );
+			R_LerpFloatVertexes_simd( newVerts.data(), oldVerts.data(), floatVertStride,
+				backlerp, numVerts, simdXyz.data(), simdNormals.data() );
+
+			CheckFloatsClose( scalarXyz, simdXyz );
+			CheckPackedNormalsClose( scalarNormals, simdNormals );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( md3_vertexes_match_scalar )
+{
+	std::mt19937 rng( 5678 );
+	const std::vector< float > sinTable = MakeSinTable();
+	for( int numVerts : vertexCounts )
+	{
+		const std::vector< short > newVerts = MakeMD3Vertexes( rng, numVerts );
+		const std::vector< short > oldVerts = MakeMD3Vertexes( rng, numVerts );
+
+		for( float backlerp : backlerps )
+		{
+			std::vector< float > scalarXyz( numVerts * 4 ), simdXyz( numVerts * 4 );
+			std::vector< float > scalarNormals( numVerts * 4 ), simdNormals( numVerts * 4 );
+
+			R_LerpMD3Vertexes_scalar( newVerts.data(), oldVerts.data(), backlerp,
+				sinTable.data(), numVerts, scalarXyz.data(), scalarNormals.data() );
+			R_LerpMD3Vertexes_simd( newVerts.data(), oldVerts.data(), backlerp,
+				sinTable.data(), numVerts, simdXyz.data(), simdNormals.data() );
+
+			CheckFloatsClose( scalarXyz, simdXyz );
+			CheckFloatsClose( scalarNormals, simdNormals );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END() // vertexlerp
+
+BOOST_AUTO_TEST_SUITE_END() // rd_common
+
+#endif // R_VERTEXLERP_SIMD